@@ -26,6 +26,8 @@ int c4s_runstring(const char *script);
 int c4s_checkfile(const char *filename);
 int c4s_checkstring(const char *script);
 
+void c4s_dumpbytecode(int enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,273 @@
+/**
+	FindObject
+	Unit tests for the search functions: Searches that are driven by the object index
+	or by the contents of a container must find the same objects in the same order as
+	a search through the whole main object list. Searches of an area must find the same
+	objects as such a search, and searches for the nearest object the first of the nearest
+	ones in the main list.
+	
+	Invokes tests by calling the global function Test*_OnStart()
+	and iterate through all tests.
+	Test*_Execute() is called two frames later, so resorted objects are back in place.
+	Then Test*_OnFinished() is called, to be able to reset the scenario
+	for the next test.
+*/
+
+
+protected func Initialize()
+{
+	// Add test control effect.
+	var effect = AddEffect("IntTestControl", nil, 100, 2);
+	effect.testnr = 1;
+	effect.launched = false;
+	return true;
+}
+
+
+/*-- Tests --*/
+
+global func FxIntTestControlStart(object target, proplist effect, int temporary)
+{
+	if (temporary)
+		return FX_OK;
+	// Set default interval.
+	effect.Interval = 2;
+	effect.result = true;
+	return FX_OK;
+}
+
+global func FxIntTestControlTimer(object target, proplist effect)
+{
+	// Launch new test if needed.
+	if (!effect.launched)
+	{
+		// Log test start.
+		Log("=====================================");
+		Log("Test %d started:", effect.testnr);
+		// Start the test if available, otherwise finish test sequence.
+		if (!Call(Format("~Test%d_OnStart", effect.testnr)))
+		{
+			Log("Test %d not available, this was the last test.", effect.testnr);
+			Log("=====================================");
+			if (effect.result)
+				Log("All tests have passed!");
+			else
+				Log("At least one test has failed!");
+			return FX_Execute_Kill;
+		}
+		effect.launched = true;
+	}
+	else
+	{
+		effect.launched = false;
+		var result = Call(Format("Test%d_Execute", effect.testnr));
+		effect.result &= result;
+		// Call the test on finished function.
+		Call(Format("~Test%d_OnFinished", effect.testnr));
+		// Log result and increase test number.
+		if (result)
+			Log(">> Test %d passed.", effect.testnr);
+		else
+			Log(">> Test %d failed.", effect.testnr);
+
+		effect.testnr++;
+	}
+	return FX_OK;
+}
+
+global func Test1_OnStart()
+{
+	// Planes that do not follow the creation order, so the main list order differs from the object numbers.
+	CreateObjectsInPlanes(Rock, 10);
+	CreateObjectsInPlanes(Ore, 10);
+	return true;
+}
+global func Test1_OnFinished() { RemoveAll(Find_Or(Find_ID(Rock), Find_ID(Ore))); }
+global func Test1_Execute()
+{
+	Log("Test the order of searches for a definition");
+	var expected = FindObjects(Find_FullScan(Find_ID(Rock)));
+	var passed = doTest("Searching by definition finds the objects in main list order. Got %v, expected %v.", FindObjects(Find_ID(Rock)), expected);
+	passed &= doTest("The first object found by definition is the first in the main list. Got %v, expected %v.", FindObject(Find_ID(Rock)), expected[0]);
+	passed &= doTest("Sorting by definition keeps the main list order of ties. Got %v, expected %v.", FindObjects(Find_ID(Rock), Sort_Func("GetZero")), FindObjects(Find_FullScan(Find_ID(Rock)), Sort_Func("GetZero")));
+	return passed;
+}
+
+global func Test2_OnStart() { return Test1_OnStart(); }
+global func Test2_OnFinished() { return Test1_OnFinished(); }
+global func Test2_Execute()
+{
+	Log("Test the order of searches for a category");
+	var expected = FindObjects(Find_FullScan(Find_Category(C4D_Object)));
+	var passed = doTest("Searching by category finds the objects in main list order. Got %v, expected %v.", FindObjects(Find_Category(C4D_Object)), expected);
+	passed &= doTest("The first object found by category is the first in the main list. Got %v, expected %v.", FindObject(Find_Category(C4D_Object)), expected[0]);
+	// Several category bits are searched in several parts of the index.
+	expected = FindObjects(Find_FullScan(Find_Category(C4D_Object | C4D_Environment)));
+	passed &= doTest("Searching by several categories finds the objects in main list order. Got %v, expected %v.", FindObjects(Find_Category(C4D_Object | C4D_Environment)), expected);
+	return passed;
+}
+
+global func Test3_OnStart()
+{
+	var container = CreateObject(Rock);
+	container->SetCategory(C4D_StaticBack);
+	container.FindObjectTestContainer = true;
+	for (var obj in CreateObjectsInPlanes(Ore, 10))
+		obj->Enter(container);
+	return true;
+}
+global func Test3_OnFinished() { RemoveAll(Find_Or(Find_ID(Rock), Find_ID(Ore))); }
+global func Test3_Execute()
+{
+	Log("Test the order of searches for contents");
+	var container = FindObject(Find_Property("FindObjectTestContainer"));
+	var expected = FindObjects(Find_FullScan(Find_Container(container)));
+	var passed = doTest("The container holds all its contents. Got %d, expected %d.", GetLength(expected), 10);
+	passed &= doTest("Searching the contents finds the objects in main list order. Got %v, expected %v.", FindObjects(Find_Container(container)), expected);
+	passed &= doTest("The first object found in the contents is the first in the main list. Got %v, expected %v.", FindObject(Find_Container(container)), expected[0]);
+	return passed;
+}
+
+global func Test4_OnStart()
+{
+	// Each rock is inserted between the previous one and the ore, using up the room between their list positions.
+	var ore = CreateObject(Ore);
+	ore.Plane = 400;
+	for (var i = 0; i < 100; i++)
+		CreateObject(Rock).Plane = 450;
+	return true;
+}
+global func Test4_OnFinished() { return Test1_OnFinished(); }
+global func Test4_Execute()
+{
+	Log("Test the order of searches after many insertions at the same place");
+	var expected = FindObjects(Find_FullScan(Find_Category(C4D_Object)));
+	var passed = doTest("Searching by category finds the objects in main list order. Got %v, expected %v.", FindObjects(Find_Category(C4D_Object)), expected);
+	passed &= doTest("The ore is last in the main list. Got %v, expected %v.", expected[-1]->GetID(), Ore);
+	return passed;
+}
+
+global func Test5_OnStart()
+{
+	for (var i = 0; i < 60; i++)
+		CreateObject(Rock, Random(LandscapeWidth()), Random(LandscapeHeight()));
+	return true;
+}
+global func Test5_OnFinished() { return Test1_OnFinished(); }
+global func Test5_Execute()
+{
+	Log("Test searches of areas while objects move between sectors");
+	var passed = true;
+	for (var round = 0; round < 20; round++)
+	{
+		// Some objects move, some of them out of the landscape.
+		for (var i = 0; i < 10; i++)
+			FindObjects(Find_ID(Rock))[Random(60)]->SetPosition(Random(LandscapeWidth() + 100) - 50, Random(LandscapeHeight() + 100) - 50);
+		// Objects moving on while a search goes through their sectors.
+		FindObjects(Find_InRect(0, 0, LandscapeWidth() / 2, LandscapeHeight()), Find_Func("MoveByOneSector"));
+		var x = Random(LandscapeWidth()), y = Random(LandscapeHeight());
+		for (var area in [Find_InRect(x - 60, y - 40, 120, 80), Find_AtRect(x - 60, y - 40, 120, 80), Find_Distance(70, x, y), Find_AtPoint(x, y), Find_InRect(-100, -100, LandscapeWidth() + 200, 150)])
+		{
+			var found = FindObjects(Find_ID(Rock), area);
+			var expected = FindObjects(Find_FullScan(Find_And(Find_ID(Rock), area)));
+			passed &= doTest(Format("Searching an area in round %d finds the objects of a full search. Got %%v, expected %%v.", round), GetObjectNumbers(found), GetObjectNumbers(expected));
+		}
+	}
+	return passed;
+}
+
+global func Test6_OnStart() { return true; }
+global func Test6_OnFinished() { return Test1_OnFinished(); }
+global func Test6_Execute()
+{
+	Log("Test the nearest object among objects at the same distance");
+	var passed = true;
+	// Points in the middle and at the corner of a sector (of 50 pixels), with rocks on circles around them.
+	// Some of the rocks are exactly as far away as the border of the sectors around the point's one.
+	var offsets = [[25, 0], [-25, 0], [0, 25], [0, -25], [50, 0], [0, -50], [120, 0], [-120, 0], [0, 120], [0, -120], [72, 96], [-72, 96], [96, -72], [-96, -72]];
+	for (var round = 0; round < 20; round++)
+	{
+		var x = 50 * (3 + Random(LandscapeWidth() / 50 - 6)) + 25 * (round % 2);
+		var y = 50 * (3 + Random(LandscapeHeight() / 50 - 6)) + 25 * (round % 2);
+		// Random creation order, so the main list order is unrelated to the sectors.
+		ShuffleArray(offsets);
+		for (var offset in offsets)
+		{
+			var rock = CreateObject(Rock);
+			rock->SetPosition(x + offset[0], y + offset[1]);
+			rock.FindObjectTestRock = true;
+		}
+		// Searches for a property are not driven by the object index, so these scan the sectors around the point.
+		// Sorting the objects of a full search keeps the main list order of ties.
+		var rocks = Find_Property("FindObjectTestRock");
+		for (var radius in [25, 50, 120])
+		{
+			var found = FindObject(rocks, Sort_Distance(x, y));
+			var expected = FindObjects(Find_FullScan(rocks), Sort_Distance(x, y))[0];
+			passed &= doTest(Format("The nearest object at %d pixels in round %d is the first in the main list. Got %%v, expected %%v.", radius, round), found, expected);
+			found = FindObject(rocks, Find_Distance(radius + 1, x, y), Sort_Distance(x, y));
+			passed &= doTest(Format("The nearest object within %d pixels in round %d is the first in the main list. Got %%v, expected %%v.", radius, round), found, expected);
+			// Go on with the next circle.
+			RemoveAll(rocks, Find_Distance(radius + 1, x, y));
+		}
+		RemoveAll(Find_ID(Rock));
+	}
+	return passed;
+}
+
+/*-- Helper Functions --*/
+
+global func CreateObjectsInPlanes(id def, int amount)
+{
+	var objects = [];
+	for (var i = 0; i < amount; i++)
+	{
+		var obj = CreateObject(def, 10 + 10 * i, 10);
+		obj.Plane = 400 + (i * 7) % amount;
+		PushBack(objects, obj);
+	}
+	return objects;
+}
+
+// Find_Or has no driving set, so the resulting condition is checked against the whole main list.
+global func Find_FullScan(condition)
+{
+	return Find_Or(condition, Find_Func("GetZero"));
+}
+
+global func GetZero() { return 0; }
+
+global func MoveByOneSector()
+{
+	SetPosition(GetX() + 50, GetY());
+	return true;
+}
+
+global func GetObjectNumbers(array objects)
+{
+	var numbers = [];
+	for (var obj in objects)
+		PushBack(numbers, obj->ObjectNumber());
+	SortArray(numbers);
+	return numbers;
+}
+
+global func doTest(description, returned, expected)
+{
+	var test;
+
+	if (GetType(returned) == C4V_Array)
+	{
+		test = DeepEqual(returned, expected);
+	}
+	else
+	{
+		test = (returned == expected);
+	}
+	
+	var predicate = "[Fail]";
+	if (test) predicate = "[Pass]";
+	
+	Log(Format("%s %s", predicate, description), returned, expected);
+	return test;
+}
@@ -77,6 +77,9 @@
 #define C4CFN_CtrlRec         "CtrlRec.ocb"
 #define C4CFN_CtrlRecText     "CtrlRec.txt"
 #define C4CFN_LogRec          "Record.log"
+#define C4CFN_RecKeyframe     "Keyframe%08d.ocg"
+#define C4CFN_RecKeyframes    "Keyframe*.ocg"
+#define C4CFN_RecKeyframeInfo "Keyframe.txt"
 #define C4CFN_TexMap          "TexMap.txt"
 #define C4CFN_MatMap          "MatMap.txt"
 #define C4CFN_Title           "Title%s.txt|Title.txt"
@@ -146,6 +149,7 @@
 #define C4CFN_Titles          "Title*.txt|Title.txt"
 #define C4CFN_DefNameFiles    "Names*.txt|Names.txt"
 #define C4CFN_EditorGeometry  "Editor.geometry"
+#define C4CFN_ChecksumCache   "Checksums.txt"
 #define C4CFN_DefaultScenarioTemplate "Empty.ocs"
 
 #define C4CFN_TempMusic       "~Music.tmp"
@@ -25,6 +25,8 @@
 #include "c4group/C4Components.h"
 #include "lib/C4InputValidation.h"
 #include <zlib.h>
+#include <atomic>
+#include <thread>
 
 
 //------------------------------ File Sort Lists -------------------------------------------
@@ -591,6 +593,7 @@ struct C4Group::P
 	std::string ErrorString;
 
 	bool NoSort = false; // If this flag is set, all entries will be marked NoSort in AddEntry
+	bool Indexed = false; // If this flag is set, the group file is saved in independently compressed blocks for random access
 };
 
 C4GroupEntry::~C4GroupEntry()
@@ -775,6 +778,7 @@ bool C4Group::OpenRealGrpFile()
 	{
 		return Error("OpenRealGrpFile: Cannot open standard file");
 	}
+	p->Indexed = p->StdFile.IsIndexed();
 
 	// Read header
 	if (!p->StdFile.Read((BYTE*)&Head, sizeof(C4GroupHeader)))
@@ -1075,7 +1079,7 @@ bool C4Group::Save(bool reopen)
 
 	// Create the new (temp) group file
 	CStdFile temp_file;
-	if (!temp_file.Create(temp_filename, true, false, hold_in_memory))
+	if (!temp_file.Create(temp_filename, true, false, hold_in_memory, p->Indexed && !hold_in_memory))
 	{
 		delete [] save_core;
 		return Error("Close: ...");
@@ -1420,10 +1424,7 @@ bool C4Group::Advance(int offset)
 	}
 	// uncached advance
 	if (p->SourceType == P::ST_Unpacked) return !!p->StdFile.Advance(offset);
-	// FIXME: reading the file one byte at a time sounds just slow.
-	BYTE buf;
-	for (; offset>0; offset--)
-		if (!Read(&buf, 1)) return false;
+	if (!AdvanceFilePtr(offset)) { RewindFilePtr(); return Error("Advance:"); }
 	return true;
 }
 
@@ -2351,22 +2352,99 @@ size_t C4Group::EntrySize(const char *wildcard)
 
 size_t C4Group::AccessedEntrySize() const { return p->iCurrFileSize; }
 
+// fewer entries aren't worth starting another thread
+static const size_t MinEntriesPerChecksumThread = 4;
+// additional threads currently computing checksums, so nested groups don't start more than there are cores
+static std::atomic<int> C4Group_ChecksumThreads{0};
+
 unsigned int C4Group::EntryCRC32(const char *wildcard)
 {
 	if (!wildcard)
 	{
 		wildcard = "*";
 	}
+	// the checksum of an unchanged group file might be known already
+	bool whole_file = SEqual(wildcard, "*") && p->SourceType == P::ST_Packed && !p->Mother && !p->Modified;
+	uint32_t cached_crc;
+	if (whole_file && GetCachedContentsCRC(GetName(), &cached_crc))
+	{
+		return cached_crc;
+	}
 	ResetSearch();
 
-	// iterate thorugh child
-	unsigned int CRC = 0;
+	// Entries on disk can be read independently of this group, and so can child
+	// groups of an indexed group file, which allows decompressing at random positions.
+	// Those are checksummed on all cores. Everything else comes from our own stream.
+	// The checksums are combined by xor, so the order doesn't matter.
+	std::vector<C4GroupEntry> disk_entries;
+	std::vector<std::string> indexed_children;
+	bool indexed = p->SourceType == P::ST_Packed && !p->Mother && p->StdFile.IsIndexed();
+	std::vector<C4GroupEntry *> own_entries;
 	C4GroupEntry *entry;
 	while ((entry = SearchNextEntry(wildcard)))
+	{
+		if (entry->Status == C4GroupEntry::C4GRES_OnDisk)
+		{
+			disk_entries.push_back(*entry);
+			disk_entries.back().HoldBuffer = false;
+		}
+		else if (indexed && entry->Status == C4GroupEntry::C4GRES_InGroup && entry->ChildGroup)
+		{
+			indexed_children.emplace_back(entry->FileName);
+		}
+		else
+		{
+			own_entries.push_back(entry);
+		}
+	}
+	std::atomic<uint32_t> CRC{0};
+	std::atomic<size_t> next{0};
+	size_t job_count = disk_entries.size() + indexed_children.size();
+	std::string file_name = GetName();
+	auto CalcJobCRC32s = [&]()
+	{
+		for (size_t i; (i = next++) < job_count; )
+		{
+			if (i < disk_entries.size())
+			{
+				CRC ^= CalcCRC32(&disk_entries[i]);
+			}
+			else
+			{
+				C4Group mother, child;
+				if (mother.Open(file_name.c_str()) && child.OpenAsChild(&mother, indexed_children[i - disk_entries.size()].c_str()))
+				{
+					CRC ^= child.EntryCRC32();
+				}
+			}
+		}
+	};
+	int max_threads = int(std::thread::hardware_concurrency()) - 1;
+	std::vector<std::thread> threads;
+	while (threads.size() < job_count / MinEntriesPerChecksumThread)
+	{
+		if (++C4Group_ChecksumThreads > max_threads)
+		{
+			--C4Group_ChecksumThreads;
+			break;
+		}
+		threads.emplace_back(CalcJobCRC32s);
+	}
+	for (C4GroupEntry *entry : own_entries)
 	{
 		CRC ^= CalcCRC32(entry);
 	}
-	// return
+	CalcJobCRC32s();
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+	C4Group_ChecksumThreads -= threads.size();
+	// remember for the next time
+	if (whole_file)
+	{
+		SetCachedContentsCRC(GetName(), CRC);
+	}
 	return CRC;
 }
 
@@ -2551,6 +2629,21 @@ bool C4Group::HasPackedMother() const
 
 bool C4Group::SetNoSort(bool no_sorting) { p->NoSort = no_sorting; return true; }
 
+bool C4Group::SetIndexed(bool indexed)
+{
+	// only top level group files have their own compression
+	if (p->SourceType != P::ST_Packed || p->Mother)
+		return Error("SetIndexed: Not a packed group file");
+	if (p->Indexed != indexed)
+	{
+		p->Indexed = indexed;
+		p->Modified = true;
+	}
+	return true;
+}
+
+bool C4Group::IsIndexed() const { return p->Indexed; }
+
 bool C4Group::CloseExclusiveMother()
 {
 	if (p->Mother && p->ExclusiveChild)
@@ -230,6 +230,8 @@ public:
 	bool IsPacked() const;
 	bool HasPackedMother() const;
 	bool SetNoSort(bool no_sorting);
+	bool SetIndexed(bool indexed); // save in blocks that can be decompressed independently. Top level packed groups only.
+	bool IsIndexed() const;
 	int PreCacheEntries(const char *search_pattern, bool cache_previous = false); // pre-load entries to memory. return number of loaded entries.
 
 	const C4GroupHeader &GetHeader() const;
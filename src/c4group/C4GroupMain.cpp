@@ -330,6 +330,13 @@ bool ProcessGroup(const char *FilenamePar)
 					case 'z':
 						PrintGroupInternals(hGroup);
 						break;
+						// Convert to indexed (or back to stream) compression
+					case 'c':
+						if (!hGroup.SetIndexed(argv[iArg][2] != 'z'))
+						{
+							fprintf(stderr, "Convert failed: %s\n", hGroup.GetError());
+						}
+						break;
 						// Undefined
 					default:
 						fprintf(stderr, "Unknown command: %s\n", argv[iArg]);
@@ -551,6 +558,7 @@ int main(int argc, char *argv[])
 		printf("          -y [ppid] Apply update (waiting for ppid to terminate first)\n");
 		printf("          -g [source] [target] [title] Make update\n");
 		printf("          -s Sort\n");
+		printf("          -c Convert to indexed format (-cz: back to stream format)\n");
 		printf("\n");
 		printf("Options:  -v Verbose -r Recursive\n");
 		printf("          -i Register shell -u Unregister shell\n");
@@ -28,6 +28,66 @@
 #include "zlib/gzio.h"
 
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+// Indexed files: The contents are compressed in independent blocks, followed by a table of
+// the blocks. The file is mapped to memory, and any position can be reached by decompressing
+// a single block.
+#pragma pack (push, 1)
+struct CStdFileIndexHeader
+{
+	char Id[8];
+	uint32_t Ver;
+	uint32_t BlockSize;
+	uint64_t Size; // uncompressed
+	uint64_t TableOffset;
+	uint32_t Blocks;
+	uint32_t Reserved;
+};
+
+struct CStdFileIndexBlock
+{
+	uint64_t Offset;
+	uint32_t PackedSize; // 0 if stored uncompressed
+	uint32_t Size;
+};
+#pragma pack (pop)
+
+static const char CStdFileIndexID[8] = { 'O', 'C', 'G', 'r', 'p', 'I', 'd', 'x' };
+const uint32_t CStdFileIndexVer = 1;
+const uint32_t CStdFileIndexBlockSize = 64 * 1024;
+
+struct CStdFileIndexed
+{
+	CStdFileIndexHeader Head;
+	std::vector<CStdFileIndexBlock> Table;
+	// writing
+	std::vector<BYTE> Block, Packed;
+	// reading
+	const BYTE *Data = nullptr; size_t DataSize = 0;
+	std::vector<BYTE> DataCopy; // if the file can't be mapped
+#ifdef _WIN32
+	HANDLE hMapping = nullptr;
+#endif
+	uint64_t Pos = 0; // uncompressed position of the next byte to load into the buffer
+	size_t StreamBlock = SIZE_MAX; // block the inflate stream is in, if it's in use
+	uint64_t StreamPos = 0; // uncompressed position of the inflate stream
+	z_stream Stream;
+	bool StreamInit = false;
+
+	~CStdFileIndexed()
+	{
+		if (StreamInit) inflateEnd(&Stream);
+#ifdef _WIN32
+		if (Data && DataCopy.empty()) UnmapViewOfFile(Data);
+		if (hMapping) CloseHandle(hMapping);
+#else
+		if (Data && DataCopy.empty()) munmap(const_cast<BYTE *>(Data), DataSize);
+#endif
+	}
+};
 
 CStdFile::CStdFile()
 {
@@ -36,6 +96,7 @@ CStdFile::CStdFile()
 	hFile=nullptr;
 	hgzFile=nullptr;
 	pMemory=nullptr;
+	pIndexed=nullptr;
 	ClearBuffer();
 	ModeWrite=false;
 	Name[0]=0;
@@ -46,7 +107,7 @@ CStdFile::~CStdFile()
 	Close();
 }
 
-bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable, bool fMemory)
+bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable, bool fMemory, bool fIndexed)
 {
 	thread_check.Set();
 	// Set modes
@@ -76,7 +137,20 @@ bool CStdFile::Create(const char *szFilename, bool fCompressed, bool fExecutable
 		int fd = open(Name, flags, mode);
 #endif
 		if (fd == -1) return false;
-		if (fCompressed)
+		if (fCompressed && fIndexed)
+		{
+			if (!(hFile = fdopen(fd,"wb"))) return false;
+			// the header is written again with the final sizes on close
+			pIndexed = new CStdFileIndexed();
+			CStdFileIndexHeader &Head = pIndexed->Head;
+			memcpy(Head.Id, CStdFileIndexID, sizeof(Head.Id));
+			Head.Ver = CStdFileIndexVer;
+			Head.BlockSize = CStdFileIndexBlockSize;
+			Head.Size = Head.TableOffset = 0;
+			Head.Blocks = Head.Reserved = 0;
+			if (fwrite(&Head, sizeof(Head), 1, hFile) != 1) return false;
+		}
+		else if (fCompressed)
 		{
 			if (!(hgzFile = c4_gzdopen(fd,"wb1"))) return false;
 		}
@@ -109,9 +183,15 @@ bool CStdFile::Open(const char *szFilename, bool fCompressed)
 	if(fd == -1) return false;
 	if (fCompressed)
 	{
-		if (!(hgzFile = c4_gzdopen(fd,"rb"))) { close(fd); return false; }
+		// indexed file?
+		char Id[sizeof(CStdFileIndexID)];
+		if (read(fd, Id, sizeof(Id)) == sizeof(Id) && !memcmp(Id, CStdFileIndexID, sizeof(Id)))
+		{
+			if (!OpenIndexed(fd)) { delete pIndexed; pIndexed = nullptr; return false; }
+		}
+		else if (lseek(fd, 0, SEEK_SET) || !(hgzFile = c4_gzdopen(fd,"rb"))) { close(fd); return false; }
 		/* Reject uncompressed files */
-		if(c4_gzdirect(hgzFile))
+		else if(c4_gzdirect(hgzFile))
 		{
 			c4_gzclose(hgzFile);
 			hgzFile = nullptr;
@@ -156,6 +236,8 @@ bool CStdFile::Close(StdBuf **ppMemory)
 	Name[0]=0;
 	// Save buffer if in write mode
 	if (ModeWrite && BufferLoad) if (!SaveBuffer()) rval=false;
+	if (pIndexed && !CloseIndexed()) rval=false;
+	delete pIndexed; pIndexed=nullptr;
 	// Close file(s)
 	if (hgzFile) if (c4_gzclose(hgzFile)!=Z_OK) rval=false;
 	if (hFile) if (fclose(hFile)!=0) rval=false;
@@ -178,6 +260,7 @@ bool CStdFile::Default()
 	hgzFile=nullptr;
 	hFile=nullptr;
 	pMemory=nullptr;
+	pIndexed=nullptr;
 	MemoryPtr=0;
 	BufferLoad=BufferPtr=0;
 	thread_check.Set();
@@ -213,16 +296,139 @@ bool CStdFile::Read(void *pBuffer, size_t iSize, size_t *ipFSize)
 int CStdFile::LoadBuffer()
 {
 	thread_check.Check();
+	if (pIndexed) return LoadIndexedBuffer();
 	if (hFile) BufferLoad = fread(Buffer,1,CStdFileBufSize,hFile);
 	if (hgzFile) BufferLoad = c4_gzread(hgzFile, Buffer,CStdFileBufSize);
 	BufferPtr=0;
 	return BufferLoad;
 }
 
+bool CStdFile::OpenIndexed(int fd)
+{
+	pIndexed = new CStdFileIndexed();
+	CStdFileIndexed &Idx = *pIndexed;
+	// map the whole file
+	struct stat st;
+	if (fstat(fd, &st) || size_t(st.st_size) < sizeof(CStdFileIndexHeader))
+		{ close(fd); return false; }
+	Idx.DataSize = st.st_size;
+#ifdef _WIN32
+	Idx.hMapping = CreateFileMapping((HANDLE) _get_osfhandle(fd), nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (Idx.hMapping)
+		Idx.Data = static_cast<const BYTE *>(MapViewOfFile(Idx.hMapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	void *pMap = mmap(nullptr, Idx.DataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (pMap != MAP_FAILED)
+		Idx.Data = static_cast<const BYTE *>(pMap);
+#endif
+	if (!Idx.Data)
+	{
+		// read it instead
+		Idx.DataCopy.resize(Idx.DataSize);
+		if (lseek(fd, 0, SEEK_SET) || read(fd, &Idx.DataCopy[0], Idx.DataSize) != (ssize_t) Idx.DataSize)
+			{ close(fd); return false; }
+		Idx.Data = &Idx.DataCopy[0];
+	}
+	close(fd);
+	// check header and block table
+	memcpy(&Idx.Head, Idx.Data, sizeof(Idx.Head));
+	const CStdFileIndexHeader &Head = Idx.Head;
+	if (Head.Ver != CStdFileIndexVer || !Head.BlockSize
+	 || Head.TableOffset > Idx.DataSize || Head.Blocks > (Idx.DataSize - Head.TableOffset) / sizeof(CStdFileIndexBlock))
+		return false;
+	Idx.Table.resize(Head.Blocks);
+	if (Head.Blocks)
+		memcpy(&Idx.Table[0], Idx.Data + Head.TableOffset, Head.Blocks * sizeof(CStdFileIndexBlock));
+	uint64_t iSize = 0;
+	for (const CStdFileIndexBlock &Block : Idx.Table)
+	{
+		// only the last block may be short
+		if (Block.Size > Head.BlockSize || (Block.Size < Head.BlockSize && &Block != &Idx.Table.back()) || Block.Offset > Head.TableOffset
+		 || (Block.PackedSize ? Block.PackedSize : Block.Size) > Head.TableOffset - Block.Offset)
+			return false;
+		iSize += Block.Size;
+	}
+	if (iSize != Head.Size) return false;
+	return true;
+}
+
+int CStdFile::LoadIndexedBuffer()
+{
+	CStdFileIndexed &Idx = *pIndexed;
+	BufferLoad = BufferPtr = 0;
+	if (Idx.Pos >= Idx.Head.Size) return 0;
+	size_t iBlock = Idx.Pos / Idx.Head.BlockSize;
+	uint32_t iBlockPos = Idx.Pos % Idx.Head.BlockSize;
+	const CStdFileIndexBlock &Block = Idx.Table[iBlock];
+	int iLoad = std::min<uint32_t>(CStdFileBufSize, Block.Size - iBlockPos);
+	if (!Block.PackedSize)
+	{
+		// stored: just copy
+		memcpy(Buffer, Idx.Data + Block.Offset + iBlockPos, iLoad);
+	}
+	else
+	{
+		// restart inflating unless the stream is at this position of the block already
+		// or before it; then skip to the position
+		if (Idx.StreamBlock != iBlock || Idx.StreamPos > Idx.Pos)
+		{
+			if (!Idx.StreamInit)
+			{
+				Idx.Stream = z_stream();
+				if (inflateInit(&Idx.Stream) != Z_OK) return 0;
+				Idx.StreamInit = true;
+			}
+			else if (inflateReset(&Idx.Stream) != Z_OK) return 0;
+			Idx.Stream.next_in = const_cast<BYTE *>(Idx.Data + Block.Offset);
+			Idx.Stream.avail_in = Block.PackedSize;
+			Idx.StreamBlock = iBlock;
+			Idx.StreamPos = uint64_t(iBlock) * Idx.Head.BlockSize;
+		}
+		while (Idx.StreamPos < Idx.Pos + iLoad)
+		{
+			// everything before the position goes to the buffer, too, and is overwritten
+			uint32_t iOut;
+			if (Idx.StreamPos < Idx.Pos)
+			{
+				Idx.Stream.next_out = Buffer;
+				iOut = std::min<uint64_t>(Idx.Pos - Idx.StreamPos, CStdFileBufSize);
+			}
+			else
+			{
+				Idx.Stream.next_out = Buffer + (Idx.StreamPos - Idx.Pos);
+				iOut = Idx.Pos + iLoad - Idx.StreamPos;
+			}
+			Idx.Stream.avail_out = iOut;
+			int iResult = inflate(&Idx.Stream, Z_SYNC_FLUSH);
+			uint32_t iDone = iOut - Idx.Stream.avail_out;
+			Idx.StreamPos += iDone;
+			if ((iResult != Z_OK && iResult != Z_STREAM_END) || !iDone)
+			{
+				Idx.StreamBlock = SIZE_MAX;
+				return 0;
+			}
+		}
+	}
+	Idx.Pos += iLoad;
+	BufferLoad = iLoad;
+	return BufferLoad;
+}
+
 bool CStdFile::SaveBuffer()
 {
 	thread_check.Check();
 	int saved = 0;
+	if (pIndexed)
+	{
+		// collect a block
+		CStdFileIndexed &Idx = *pIndexed;
+		int iTransfer = std::min<int>(BufferLoad, CStdFileIndexBlockSize - Idx.Block.size());
+		Idx.Block.insert(Idx.Block.end(), Buffer, Buffer + iTransfer);
+		if (Idx.Block.size() == CStdFileIndexBlockSize && !SaveIndexedBlock()) return false;
+		Idx.Block.insert(Idx.Block.end(), Buffer + iTransfer, Buffer + BufferLoad);
+		BufferLoad=0;
+		return true;
+	}
 	if (hFile) saved=fwrite(Buffer,1,BufferLoad,hFile);
 	if (hgzFile) saved=c4_gzwrite(hgzFile,Buffer,BufferLoad);
 	if (pMemory) { pMemory->Append(Buffer, BufferLoad); saved = BufferLoad; }
@@ -231,6 +437,47 @@ bool CStdFile::SaveBuffer()
 	return true;
 }
 
+bool CStdFile::SaveIndexedBlock()
+{
+	CStdFileIndexed &Idx = *pIndexed;
+	if (Idx.Block.empty()) return true;
+	CStdFileIndexBlock Block;
+	Block.Offset = sizeof(CStdFileIndexHeader);
+	if (!Idx.Table.empty()) Block.Offset = Idx.Table.back().Offset + (Idx.Table.back().PackedSize ? Idx.Table.back().PackedSize : Idx.Table.back().Size);
+	Block.Size = Idx.Block.size();
+	// store incompressible data (images, sounds) as it is, so it is only copied when read
+	uLongf iPackedSize = compressBound(Block.Size);
+	Idx.Packed.resize(iPackedSize);
+	if (compress2(&Idx.Packed[0], &iPackedSize, &Idx.Block[0], Block.Size, 1) == Z_OK && iPackedSize < Block.Size)
+	{
+		Block.PackedSize = iPackedSize;
+		if (fwrite(&Idx.Packed[0], 1, iPackedSize, hFile) != iPackedSize) return false;
+	}
+	else
+	{
+		Block.PackedSize = 0;
+		if (fwrite(&Idx.Block[0], 1, Block.Size, hFile) != Block.Size) return false;
+	}
+	Idx.Table.push_back(Block);
+	Idx.Head.Size += Block.Size;
+	Idx.Block.clear();
+	return true;
+}
+
+bool CStdFile::CloseIndexed()
+{
+	if (!ModeWrite) return true;
+	// last block, table, then the header again with the final sizes
+	if (!SaveIndexedBlock()) return false;
+	CStdFileIndexed &Idx = *pIndexed;
+	Idx.Head.TableOffset = sizeof(CStdFileIndexHeader);
+	if (!Idx.Table.empty()) Idx.Head.TableOffset = Idx.Table.back().Offset + (Idx.Table.back().PackedSize ? Idx.Table.back().PackedSize : Idx.Table.back().Size);
+	Idx.Head.Blocks = Idx.Table.size();
+	if (!Idx.Table.empty() && fwrite(&Idx.Table[0], sizeof(CStdFileIndexBlock), Idx.Table.size(), hFile) != Idx.Table.size()) return false;
+	if (fseek(hFile, 0, SEEK_SET) || fwrite(&Idx.Head, sizeof(Idx.Head), 1, hFile) != 1) return false;
+	return true;
+}
+
 void CStdFile::ClearBuffer()
 {
 	thread_check.Check();
@@ -277,6 +524,7 @@ bool CStdFile::Rewind()
 	thread_check.Check();
 	if (ModeWrite) return false;
 	ClearBuffer();
+	if (pIndexed) pIndexed->Pos = 0;
 	if (hFile) rewind(hFile);
 	if (hgzFile) c4_gzrewind(hgzFile);
 	return true;
@@ -298,6 +546,11 @@ bool CStdFile::Advance(int iOffset)
 		// Buffer empty: Load or skip
 		else
 		{
+			if (pIndexed) // indexed: Skip to that block
+			{
+				pIndexed->Pos += iOffset;
+				return pIndexed->Pos <= pIndexed->Head.Size;
+			}
 			if (hFile) return !fseek(hFile, iOffset, SEEK_CUR); // uncompressed: Just skip
 			if (LoadBuffer()<=0) return false; // compressed: Read...
 		}
@@ -308,19 +561,25 @@ bool CStdFile::Advance(int iOffset)
 int CStdFile::Seek(long int offset, int whence)
 {
 	// seek in file by offset and stdio-style SEEK_* constants. Only implemented for uncompressed files.
-	assert(!hgzFile);
+	assert(!hgzFile && !pIndexed);
 	return fseek(hFile, offset, whence);
 }
 
 long int CStdFile::Tell()
 {
 	// get current file pos. Only implemented for uncompressed files.
-	assert(!hgzFile);
+	assert(!hgzFile && !pIndexed);
 	return ftell(hFile);
 }
 
 int UncompressedFileSize(const char *szFilename)
 {
+	// indexed files know their size
+	{
+		CStdFile File;
+		if (File.Open(szFilename, true) && File.IsIndexed())
+			return File.AccessedEntrySize();
+	}
 	int rd,rval=0;
 	BYTE buf[1024];
 	int flags = _O_BINARY|O_CLOEXEC|O_RDONLY;
@@ -346,60 +605,181 @@ int UncompressedFileSize(const char *szFilename)
 
 size_t CStdFile::AccessedEntrySize() const
 {
+	if (pIndexed)
+		return pIndexed->Head.Size;
 	if (hFile)
 		return FileSize(fileno(hFile));
 	assert(!hgzFile);
 	return 0;
 }
 
-bool GetFileCRC(const char *szFilename, uint32_t *pCRC32)
+// Checksums of whole files by full path. They are valid as long as size and modification time match.
+struct CStdFileChecksums
 {
-	if (!pCRC32) return false;
-	// open file
-	CStdFile File;
-	if (!File.Open(szFilename))
-		return false;
-	// calculcate CRC
-	uint32_t iCRC32 = 0;
-	for (;;)
+	size_t Size = 0; int Time = 0;
+	bool HasCRC = false; uint32_t CRC = 0;
+	bool HasSHA1 = false; BYTE SHA1[SHA_DIGEST_LENGTH];
+	bool HasContentsCRC = false; uint32_t ContentsCRC = 0;
+};
+
+static CStdCSec ChecksumCacheCSec;
+static std::map<std::string, CStdFileChecksums> ChecksumCache;
+static StdCopyStrBuf ChecksumCacheFile;
+static bool ChecksumCacheModified = false;
+
+// files changed within the resolution of the modification time might change again unnoticed
+const int ChecksumCacheMinAge = 2;
+
+static bool GetChecksumCacheEntry(const char *szFilename, std::string *pKey, CStdFileChecksums *pEntry)
+{
+	// only remember regular files; directory contents can change without changing the directory
+	if (!FileExists(szFilename) || DirectoryExists(szFilename)) return false;
+	char szFullFilename[_MAX_PATH_LEN];
+	RealPath(szFilename, szFullFilename);
+	*pKey = szFullFilename;
+	size_t iSize = FileSize(szFilename); int iTime = FileTime(szFilename);
+	if (time(nullptr) - iTime < ChecksumCacheMinAge) return false;
+	CStdLock CacheLock(&ChecksumCacheCSec);
+	auto it = ChecksumCache.find(*pKey);
+	if (it != ChecksumCache.end() && it->second.Size == iSize && it->second.Time == iTime)
+		*pEntry = it->second;
+	else
 	{
-		// read a chunk of data
-		BYTE szData[CStdFileBufSize]; size_t iSize = 0;
-		if (!File.Read(szData, CStdFileBufSize, &iSize))
-			if (!iSize)
-				break;
-		// update CRC
-		iCRC32 = crc32(iCRC32, szData, iSize);
+		*pEntry = CStdFileChecksums();
+		pEntry->Size = iSize; pEntry->Time = iTime;
 	}
-	// close file
-	File.Close();
-	// okay
-	*pCRC32 = iCRC32;
 	return true;
 }
 
-bool GetFileSHA1(const char *szFilename, BYTE *pSHA1)
+static void SetChecksumCacheEntry(const std::string &Key, const CStdFileChecksums &Entry)
 {
-	if (!pSHA1) return false;
-	// open file
-	CStdFile File;
-	if (!File.Open(szFilename))
-		return false;
-	// calculcate CRC
-	sha1 ctx;
-	for (;;)
+	CStdLock CacheLock(&ChecksumCacheCSec);
+	ChecksumCache[Key] = Entry;
+	ChecksumCacheModified = true;
+}
+
+void SetFileChecksumCache(const char *szFilename)
+{
+	CStdLock CacheLock(&ChecksumCacheCSec);
+	ChecksumCache.clear();
+	ChecksumCacheFile.Copy(szFilename);
+	ChecksumCacheModified = false;
+	// one file per line: size, time, CRC, SHA1 and contents CRC or "-", path
+	StdStrBuf Buf;
+	if (!szFilename || !Buf.LoadFromFile(szFilename)) return;
+	for (const char *szLine = Buf.getData(); szLine && *szLine; szLine = SSearch(szLine, "\n"))
+	{
+		CStdFileChecksums Entry;
+		unsigned long iSize; int iTime, iPathPos = 0;
+		char szCRC[9], szSHA1[SHA_DIGEST_LENGTH * 2 + 1], szContentsCRC[9];
+		if (sscanf(szLine, "%lu %d %8s %40s %8s %n", &iSize, &iTime, szCRC, szSHA1, szContentsCRC, &iPathPos) != 5 || !iPathPos) continue;
+		Entry.Size = iSize; Entry.Time = iTime;
+		if ((Entry.HasCRC = !SEqual(szCRC, "-"))) Entry.CRC = strtoul(szCRC, nullptr, 16);
+		if ((Entry.HasSHA1 = (SLen(szSHA1) == SHA_DIGEST_LENGTH * 2)))
+			for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+			{
+				char szByte[3] = { szSHA1[i * 2], szSHA1[i * 2 + 1], 0 };
+				Entry.SHA1[i] = BYTE(strtoul(szByte, nullptr, 16));
+			}
+		if ((Entry.HasContentsCRC = !SEqual(szContentsCRC, "-"))) Entry.ContentsCRC = strtoul(szContentsCRC, nullptr, 16);
+		const char *szPathEnd = SSearch(szLine + iPathPos, "\n");
+		std::string Path(szLine + iPathPos, szPathEnd ? szPathEnd - 1 : szLine + iPathPos + SLen(szLine + iPathPos));
+		if (!Path.empty() && Path.back() == '\r') Path.pop_back();
+		if (!Path.empty()) ChecksumCache[Path] = Entry;
+	}
+}
+
+bool SaveFileChecksumCache()
+{
+	CStdLock CacheLock(&ChecksumCacheCSec);
+	if (!ChecksumCacheModified || !ChecksumCacheFile.getLength()) return true;
+	StdStrBuf Buf;
+	for (auto it = ChecksumCache.begin(); it != ChecksumCache.end(); )
 	{
-		// read a chunk of data
-		BYTE szData[CStdFileBufSize]; size_t iSize = 0;
-		if (!File.Read(szData, CStdFileBufSize, &iSize))
-			if (!iSize)
-				break;
-		// update CRC
-		ctx.process_bytes(szData, iSize);
+		// forget deleted files
+		if (!FileExists(it->first.c_str())) { it = ChecksumCache.erase(it); continue; }
+		const CStdFileChecksums &Entry = it->second;
+		Buf.AppendFormat("%lu %d ", (unsigned long) Entry.Size, Entry.Time);
+		if (Entry.HasCRC) Buf.AppendFormat("%08x ", (unsigned int) Entry.CRC); else Buf.Append("- ");
+		if (Entry.HasSHA1)
+		{
+			for (BYTE b : Entry.SHA1) Buf.AppendFormat("%02x", (unsigned int) b);
+			Buf.AppendChar(' ');
+		}
+		else Buf.Append("- ");
+		if (Entry.HasContentsCRC) Buf.AppendFormat("%08x ", (unsigned int) Entry.ContentsCRC); else Buf.Append("- ");
+		Buf.Append(it->first.c_str());
+		Buf.AppendChar('\n');
+		++it;
+	}
+	if (!Buf.SaveToFile(ChecksumCacheFile.getData())) return false;
+	ChecksumCacheModified = false;
+	return true;
+}
+
+bool GetCachedContentsCRC(const char *szFilename, uint32_t *pCRC32)
+{
+	std::string Key; CStdFileChecksums Entry;
+	if (!GetChecksumCacheEntry(szFilename, &Key, &Entry) || !Entry.HasContentsCRC) return false;
+	*pCRC32 = Entry.ContentsCRC;
+	return true;
+}
+
+void SetCachedContentsCRC(const char *szFilename, uint32_t iCRC32)
+{
+	std::string Key; CStdFileChecksums Entry;
+	if (!GetChecksumCacheEntry(szFilename, &Key, &Entry)) return;
+	Entry.HasContentsCRC = true; Entry.ContentsCRC = iCRC32;
+	SetChecksumCacheEntry(Key, Entry);
+}
+
+bool GetFileChecksums(const char *szFilename, uint32_t *pCRC32, BYTE *pSHA1)
+{
+	// known?
+	std::string Key; CStdFileChecksums Entry;
+	bool fCache = GetChecksumCacheEntry(szFilename, &Key, &Entry);
+	if (!fCache || (pCRC32 && !Entry.HasCRC) || (pSHA1 && !Entry.HasSHA1))
+	{
+		// open file
+		CStdFile File;
+		if (!File.Open(szFilename))
+			return false;
+		// calculate both in one pass, so the file only needs to be read once
+		// even if the other one is needed later
+		uint32_t iCRC32 = 0;
+		sha1 ctx;
+		for (;;)
+		{
+			// read a chunk of data
+			BYTE szData[CStdFileBufSize]; size_t iSize = 0;
+			if (!File.Read(szData, CStdFileBufSize, &iSize))
+				if (!iSize)
+					break;
+			// update checksums
+			iCRC32 = crc32(iCRC32, szData, iSize);
+			ctx.process_bytes(szData, iSize);
+		}
+		// close file
+		File.Close();
+		// finish calculation
+		Entry.HasCRC = true; Entry.CRC = iCRC32;
+		ctx.get_digest((sha1::digest_type) Entry.SHA1);
+		Entry.HasSHA1 = true;
+		if (fCache) SetChecksumCacheEntry(Key, Entry);
 	}
-	// close file
-	File.Close();
-	// finish calculation
-	ctx.get_digest((sha1::digest_type) *pSHA1);
+	if (pCRC32) *pCRC32 = Entry.CRC;
+	if (pSHA1) memcpy(pSHA1, Entry.SHA1, SHA_DIGEST_LENGTH);
 	return true;
 }
+
+bool GetFileCRC(const char *szFilename, uint32_t *pCRC32)
+{
+	if (!pCRC32) return false;
+	return GetFileChecksums(szFilename, pCRC32, nullptr);
+}
+
+bool GetFileSHA1(const char *szFilename, BYTE *pSHA1)
+{
+	if (!pSHA1) return false;
+	return GetFileChecksums(szFilename, nullptr, pSHA1);
+}
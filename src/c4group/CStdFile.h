@@ -25,6 +25,8 @@
 
 const int CStdFileBufSize = 4096;
 
+struct CStdFileIndexed;
+
 class CStdStream
 {
 public:
@@ -50,9 +52,10 @@ protected:
 	BYTE Buffer[CStdFileBufSize];
 	int BufferLoad,BufferPtr;
 	bool ModeWrite;
+	CStdFileIndexed *pIndexed; // compressed in independent blocks, so seeking doesn't need to decompress everything before
 	StdThreadCheck thread_check; // thread check helper to make sure only the thread that opened the file is using it
 public:
-	bool Create(const char *szFileName, bool fCompressed=false, bool fExecutable=false, bool fMemory=false);
+	bool Create(const char *szFileName, bool fCompressed=false, bool fExecutable=false, bool fMemory=false, bool fIndexed=false);
 	bool Open(const char *szFileName, bool fCompressed=false);
 	bool Append(const char *szFilename, bool text=false); // append (uncompressed only)
 	bool Close(StdBuf **ppMemory = nullptr);
@@ -65,7 +68,8 @@ public:
 	bool Advance(int iOffset) override;
 	int Seek(long int offset, int whence); // seek in file by offset and stdio-style SEEK_* constants. Only implemented for uncompressed files.
 	long int Tell(); // get current file pos. Only implemented for uncompressed files.
-	bool IsOpen() const { return hFile || hgzFile; }
+	bool IsOpen() const { return hFile || hgzFile || pIndexed; }
+	bool IsIndexed() const { return !!pIndexed; }
 	// flush contents to disk
 	inline bool Flush() { if (ModeWrite && BufferLoad) return SaveBuffer(); else return true; }
 	size_t AccessedEntrySize() const override;
@@ -73,10 +77,22 @@ protected:
 	void ClearBuffer();
 	int LoadBuffer();
 	bool SaveBuffer();
+	bool OpenIndexed(int fd);
+	int LoadIndexedBuffer();
+	bool SaveIndexedBlock();
+	bool CloseIndexed();
 };
 
 int UncompressedFileSize(const char *szFileName);
 bool GetFileCRC(const char *szFilename, uint32_t *pCRC32);
 bool GetFileSHA1(const char *szFilename, BYTE *pSHA1);
+bool GetFileChecksums(const char *szFilename, uint32_t *pCRC32, BYTE *pSHA1); // both in one pass; either may be nullptr
+
+// Checksums of files are remembered by path, size and modification time.
+// If a cache file is set, they are kept there between runs.
+void SetFileChecksumCache(const char *szFilename);
+bool SaveFileChecksumCache();
+bool GetCachedContentsCRC(const char *szFilename, uint32_t *pCRC32); // C4Group::EntryCRC32 of a group file
+void SetCachedContentsCRC(const char *szFilename, uint32_t iCRC32);
 
 #endif // INC_CSTDFILE
@@ -65,6 +65,7 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *compiler)
 	compiler->Value(mkNamingAdapt(s(MissionAccess),    "MissionAccess",      "", false, true));
 	compiler->Value(mkNamingAdapt(FPS,                 "FPS",                0              ));
 	compiler->Value(mkNamingAdapt(DefRec,              "DefRec",             0              ));
+	compiler->Value(mkNamingAdapt(RecordKeyframeInterval, "RecordKeyframeInterval", 0       ));
 	compiler->Value(mkNamingAdapt(ScreenshotFolder,    "ScreenshotFolder",   "Screenshots",  false, true));
 	compiler->Value(mkNamingAdapt(ModsFolder,          "ModsFolder",         "mods",  false, true));
 	compiler->Value(mkNamingAdapt(ScrollSmooth,        "ScrollSmooth",       4              ));
@@ -192,6 +193,7 @@ void C4ConfigNetwork::CompileFunc(StdCompiler *compiler)
 #endif
 	compiler->Value(mkNamingAdapt(AsyncMaxWait,            "AsyncMaxWait",         2             ));
 	compiler->Value(mkNamingAdapt(PacketLogging,           "PacketLogging",        0             ));
+	compiler->Value(mkNamingAdapt(UseEpoll,                "UseEpoll",             0             ));
 	
 
 	compiler->Value(mkNamingAdapt(s(PuncherAddress),       "PuncherAddress",       "netpuncher.openclonk.org:11115"));
@@ -47,6 +47,7 @@ public:
 	char MissionAccess[CFG_MaxString+1];
 	int32_t FPS;
 	int32_t DefRec;
+	int32_t RecordKeyframeInterval; // frames between keyframes saved into records for seeking; 0 for none
 	int32_t MMTimer;  // use multimedia-timers
 	int32_t ScrollSmooth; // view movement smoothing
 	int32_t ConfigResetSafety; // safety value: If this value is screwed, the config got corrupted and must be reset
@@ -169,6 +170,7 @@ public:
 #endif
 	int32_t AsyncMaxWait;
 	int32_t PacketLogging;
+	int32_t UseEpoll;
 public:
 	void CompileFunc(StdCompiler *compiler);
 	const char *GetLeagueServerAddress();
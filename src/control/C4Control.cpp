@@ -24,6 +24,7 @@
 #include "control/C4GameSave.h"
 #include "control/C4RoundResults.h"
 #include "editor/C4Console.h"
+#include "game/C4Application.h"
 #include "game/C4GameScript.h"
 #include "game/C4GraphicsSystem.h"
 #include "gui/C4GameLobby.h"
@@ -749,7 +750,7 @@ void C4ControlSyncCheck::Set()
 	ControlTick = ::Control.ControlTick;
 	RandomCount = ::RandomCount;
 	AllCrewPosX = GetAllCrewPosX();
-	PXSCount = ::PXS.Count;
+	PXSCount = ::PXS.GetCount();
 	MassMoverIndex = ::MassMover.CreatePtr;
 	ObjectCount = ::Objects.ObjectCount();
 	ObjectEnumerationIndex = C4PropListNumbered::GetEnumerationIndex();
@@ -806,7 +807,16 @@ void C4ControlSyncCheck::Execute() const
 		::Network.LeagueNotifyDisconnect(C4ClientIDHost, C4LDR_Desync);
 		// Deactivate / end
 		if (::Control.isReplay())
+		{
 			Game.DoGameOver();
+			// verifying records: no use in playing on
+			if (Application.RecordVerification)
+			{
+				Application.RecordVerification->OnDivergence(true, "Synchronization loss");
+				Application.RecordVerification->Finish(false);
+				Application.QuitGame();
+			}
+		}
 		else if (::Control.isNetwork())
 		{
 			Game.RoundResults.EvaluateNetwork(C4RoundResults::NR_NetError, "Network: Synchronization loss!");
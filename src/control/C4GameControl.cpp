@@ -130,6 +130,18 @@ void C4GameControl::OnGameSynchronizing()
 		fRecordNeeded = false;
 		StartRecord(false, false);
 	}
+	// save record keyframe if due
+	// it can only be saved during queue control, so playback can continue right after it
+	if (pRecord && pExecutingControl && Config.General.RecordKeyframeInterval > 0)
+		if (Game.FrameCounter - pRecord->GetLastKeyframe() >= Config.General.RecordKeyframeInterval)
+		{
+			fKeyframeRequested = false;
+			// packets executed before this synchronization won't be executed again after seeking
+			int32_t iSkipPackets = 0;
+			for (C4IDPacket *pPkt = pExecutingControl->firstPkt(); pPkt && pPkt->getPktType() != CID_Synchronize; pPkt = pExecutingControl->nextPkt(pPkt))
+				iSkipPackets++;
+			pRecord->SaveKeyframe(iSkipPackets);
+		}
 }
 
 bool C4GameControl::StartRecord(bool fInitial, bool fStreaming)
@@ -222,6 +234,7 @@ void C4GameControl::Default()
 	SyncRate = C4SyncCheckRate;
 	DoSync = false;
 	fRecordNeeded = false;
+	fKeyframeRequested = false;
 	pExecutingControl = nullptr;
 }
 
@@ -317,6 +330,14 @@ void C4GameControl::Execute()
 	Control.Clear();
 	pExecutingControl = nullptr;
 
+	// record keyframe due? Request it through a synchronize-call
+	if (pRecord && fHost && !fKeyframeRequested && Config.General.RecordKeyframeInterval > 0)
+		if (Game.FrameCounter - pRecord->GetLastKeyframe() >= Config.General.RecordKeyframeInterval)
+		{
+			fKeyframeRequested = true;
+			DoInput(CID_Synchronize, new C4ControlSynchronize(false, false), CDT_Queue);
+		}
+
 	// statistics record
 	if (Game.pNetworkStatistics) Game.pNetworkStatistics->ExecuteControlFrame();
 
@@ -340,6 +361,13 @@ void C4GameControl::Ticks()
 				if (Game.FrameCounter % ((Network.GetBehind(ControlTick) + 15) / 20))
 					Game.DoSkipFrame = true;
 		}
+
+	// seeking in replay: fast-forward to the requested frame
+	if (eMode == CM_Replay && Game.FrameCounter < Game.RecordSeekFrame)
+	{
+		Game.GameGo = true;
+		Game.DoSkipFrame = true;
+	}
 }
 
 bool C4GameControl::CtrlTickReached(int32_t iTick)
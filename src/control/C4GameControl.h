@@ -72,6 +72,7 @@ protected:
 	bool                fHost;              // (set for local, too)
 	bool                fActivated;
 	bool                fRecordNeeded;
+	bool                fKeyframeRequested; // synchronization requested to save a record keyframe
 	int32_t             iClientID;
 
 	C4Record            *pRecord;
@@ -154,7 +155,7 @@ public:
 	// execute and record control (by self or C4GameControlNetwork)
 	void ExecControl(const C4Control &rCtrl);
 	void ExecControlPacket(C4PacketType eCtrlType, class C4ControlPacket *pPkt);
-	void OnGameSynchronizing(); // start record if desired
+	void OnGameSynchronizing(); // start record or save keyframe if desired
 
 protected:
 
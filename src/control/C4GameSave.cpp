@@ -145,7 +145,12 @@ bool C4GameSave::SaveLandscape()
 		C4DebugRecOff DBGRECOFF;
 		// Landscape
 		bool fSuccess;
-		if (::Landscape.GetMode() ==  LandscapeMode::Exact)
+		// changes only if the receiver can create the initial landscape from its scenario file
+		// (which is not the case for the landscape of a loaded section)
+		// the diff is saved even if unchanged, so it replaces any diff in the receiver's scenario
+		if (GetSaveLandscapeDiff() && !Game.pCurrentScenarioSection)
+			fSuccess = !!::Landscape.SaveDiff(*pSaveGroup, false, true);
+		else if (::Landscape.GetMode() ==  LandscapeMode::Exact)
 			fSuccess = !!::Landscape.Save(*pSaveGroup);
 		else
 			fSuccess = !!::Landscape.SaveDiff(*pSaveGroup, !IsSynced());
@@ -61,6 +61,7 @@ protected:
 	virtual const char *GetSortOrder() { return C4FLS_Scenario; } // return nullptr to prevent sorting
 	virtual bool GetCreateSmallFile() { return false; }           // return whether file size should be minimized
 	virtual bool GetForceExactLandscape() { return GetSaveRuntimeData() && IsExact(); } // whether exact landscape shall be saved
+	virtual bool GetSaveLandscapeDiff() { return false; }         // whether the landscape may be saved as changes against the initial scenario landscape
 	virtual bool GetSaveOrigin() { return false; }                // return whether C4S.Head.Origin shall be set
 	virtual bool GetClearOrigin() { return !GetSaveOrigin(); }    // return whether C4S.Head.Origin shall be cleared if it's set
 	virtual bool GetSaveUserPlayers() { return IsExact(); }       // return whether joined user players shall be saved into SavePlayerInfos
@@ -179,6 +180,7 @@ protected:
 	bool GetKeepTitle() override { return false; }     // always delete title files (not used in dynamics)
 	bool GetSaveDesc() override { return false; }      // no desc in dynamics
 	bool GetCreateSmallFile() override { return true; }// return whether file size should be minimized
+	bool GetSaveLandscapeDiff() override { return true; } // clients already got the scenario landscape
 
 	bool GetCopyScenario() override { return false; }    // network dynamics do not base on normal scenario
 	// savegame specializations
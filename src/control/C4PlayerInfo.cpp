@@ -1470,6 +1470,9 @@ bool C4PlayerInfoList::RecreatePlayerFiles()
 						// replay of resumed savegame: RecreatePlayers saves used player files into the record group in this manner
 						sFilenameInRecord.Format("Recreate-%d.ocp", pInfo->GetID());
 						szCurrPlrFile = sFilenameInRecord.getData();
+						// runtime records and record keyframes contain the files as saved in the savegame
+						if (!Game.ScenarioFile.FindEntry(szCurrPlrFile))
+							szCurrPlrFile = pInfo->GetFilename();
 					}
 					else
 						szCurrPlrFile = pInfo->GetFilename();
@@ -22,6 +22,7 @@
 #include "control/C4GameSave.h"
 #include "control/C4PlayerInfo.h"
 #include "editor/C4Console.h"
+#include "game/C4Application.h"
 #include "player/C4Player.h"
 
 #define IMMEDIATEREC
@@ -97,6 +98,13 @@ void C4RecordChunk::CompileFunc(StdCompiler *pComp)
 	}
 }
 
+void C4RecordKeyframe::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkNamingAdapt(Frame, "Frame", 0));
+	pComp->Value(mkNamingAdapt(Chunk, "Chunk", 0));
+	pComp->Value(mkNamingAdapt(SkipPackets, "SkipPackets", 0));
+}
+
 C4Record::C4Record() = default;
 
 C4Record::~C4Record() = default;
@@ -163,6 +171,9 @@ bool C4Record::Start(bool fInitial)
 	fStreaming = false;
 	fRecording = true;
 	iLastFrame = 0;
+	iChunks = 0;
+	iLastCtrlChunk = -1;
+	iLastKeyframe = Game.FrameCounter;
 	return true;
 }
 
@@ -241,6 +252,9 @@ bool C4Record::Rec(int iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
 	// get frame difference
 	uint8_t iFrameDiff = std::max<uint8_t>(0, iFrame - iLastFrame);
 	iLastFrame += iFrameDiff;
+	// count chunks, so keyframes can refer to them
+	if (eType == RCT_Ctrl) iLastCtrlChunk = iChunks;
+	++iChunks;
 	// create head
 	C4RecordChunkHead Head = { iFrameDiff, uint8_t(eType) };
 	// pack
@@ -308,6 +322,42 @@ bool C4Record::AddFile(const char *szLocalFilename, const char *szAddAs, bool fD
 	return true;
 }
 
+bool C4Record::SaveKeyframe(int32_t iSkipPackets)
+{
+	if (!fRecording) return false;
+	// the keyframe must directly follow recorded control
+	if (iLastCtrlChunk < 0) return false;
+	// do not retry before the next interval if saving fails
+	iLastKeyframe = Game.FrameCounter;
+
+	// Get temporary file name
+	StdCopyStrBuf sTempFilename(sFilename);
+	MakeTempFilename(&sTempFilename);
+	EraseItem(sTempFilename.getData());
+
+	// Save current state (without copy of scenario; it is merged into the record for seeking)
+	C4Group KeyframeGrp;
+	if (!KeyframeGrp.Open(sTempFilename.getData(), true)) return false;
+	C4GameSaveRecord saveRec(false, Index, Game.Parameters.isLeague(), false);
+	if (!saveRec.Save(KeyframeGrp, false)) { KeyframeGrp.Close(); EraseItem(sTempFilename.getData()); return false; }
+	saveRec.Close();
+
+	// Remember where playback continues
+	C4RecordKeyframe Keyframe;
+	Keyframe.Frame = Game.FrameCounter;
+	Keyframe.Chunk = iLastCtrlChunk;
+	Keyframe.SkipPackets = iSkipPackets;
+	StdStrBuf KeyframeData = DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(Keyframe, "Keyframe"));
+	if (!KeyframeGrp.Add(C4CFN_RecKeyframeInfo, KeyframeData, false, true) || !KeyframeGrp.Close())
+		{ EraseItem(sTempFilename.getData()); return false; }
+
+	// Move into record group
+	if (!RecordGrp.Move(sTempFilename.getData(), FormatString(C4CFN_RecKeyframe, (int) Game.FrameCounter).getData()))
+		return false;
+	LogSilentF("Record: Keyframe saved (Frame %d)", (int) Game.FrameCounter);
+	return true;
+}
+
 bool C4Record::StartStreaming(bool fInitial)
 {
 	if (!fRecording) return false;
@@ -475,6 +525,26 @@ bool C4Playback::Open(C4Group &rGrp)
 	// reset status
 	currChunk = chunks.begin();
 	Finished = false;
+	// verifying records: check debugrecs if the record contains them
+	if (Application.RecordVerification && !Config.General.DebugRecExternalFile[0])
+	{
+		Config.General.DebugRec = std::any_of(chunks.begin(), chunks.end(), [](const C4RecordChunk &c) { return c.Type >= 0x80; });
+		Config.General.DebugRecWrite = 0;
+		DoNoDebugRec = 0;
+	}
+	// record created for seeking? Then the game starts at the keyframe
+	StdStrBuf KeyframeBuf;
+	if (rGrp.LoadEntryString(C4CFN_RecKeyframeInfo, &KeyframeBuf))
+	{
+		C4RecordKeyframe Keyframe;
+		if (!CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(Keyframe, "Keyframe"), KeyframeBuf, C4CFN_RecKeyframeInfo))
+			return false;
+		if (!SkipToKeyframe(Keyframe))
+		{
+			LogFatal("Record: Keyframe does not match control data!");
+			return false;
+		}
+	}
 	// external debugrec file
 	if (Config.General.DebugRecExternalFile[0] && Config.General.DebugRec)
 	{
@@ -840,7 +910,16 @@ void C4Playback::Strip()
 bool C4Playback::ExecuteControl(C4Control *pCtrl, int iFrame)
 {
 	// still playbacking?
-	if (currChunk == chunks.end()) return false;
+	if (currChunk == chunks.end())
+	{
+		// verifying records: done, complete if the end chunk has been reached
+		if (Application.RecordVerification)
+		{
+			Application.RecordVerification->Finish(Finished);
+			Application.QuitGame();
+		}
+		return false;
+	}
 	if (Finished) { Finish(); return false; }
 	if (Config.General.DebugRec)
 	{
@@ -889,6 +968,26 @@ bool C4Playback::ExecuteControl(C4Control *pCtrl, int iFrame)
 	return true;
 }
 
+bool C4Playback::SkipToKeyframe(const C4RecordKeyframe &Keyframe)
+{
+	// skip all chunks before the control that was executing
+	for (int32_t i = 0; i < Keyframe.Chunk; ++i)
+	{
+		if (currChunk == chunks.end()) return false;
+		NextChunk();
+	}
+	if (currChunk == chunks.end() || currChunk->Type != RCT_Ctrl || currChunk->Frame != Keyframe.Frame)
+		return false;
+	// drop the packets of that control that had been executed before saving
+	for (int32_t i = 0; i < Keyframe.SkipPackets; ++i)
+	{
+		C4IDPacket *pPkt = currChunk->pCtrl->firstPkt();
+		if (!pPkt) return false;
+		currChunk->pCtrl->Delete(pPkt);
+	}
+	return true;
+}
+
 void C4Playback::Finish()
 {
 	Clear();
@@ -904,6 +1003,12 @@ void C4Playback::Finish()
 	}
 	// finish playback: enable controls
 	::Control.ChangeToLocal();
+	// verifying records: continue with the next one
+	if (Application.RecordVerification)
+	{
+		Application.RecordVerification->Finish(true);
+		Application.QuitGame();
+	}
 }
 
 void C4Playback::Clear()
@@ -1102,6 +1207,12 @@ void C4Playback::DebugRecError(const char *szError)
 {
 	LogF("Playback error: %s", szError);
 	BREAKPOINT_HERE;
+	// verifying records: further checks would only fail as well
+	if (Application.RecordVerification)
+	{
+		Application.RecordVerification->OnDivergence(false, szError);
+		Config.General.DebugRec = 0;
+	}
 }
 
 bool C4Playback::StreamToRecord(const char *szStream, StdStrBuf *pRecordFile)
@@ -1225,3 +1336,193 @@ bool C4Playback::StreamToRecord(const char *szStream, StdStrBuf *pRecordFile)
 	pRecordFile->Copy(szRecord);
 	return true;
 }
+
+bool C4Playback::GetKeyframeRecord(const char *szRecord, int32_t iFrame, StdStrBuf *pSeekRecord)
+{
+	pSeekRecord->Clear();
+
+	// Find last keyframe up to the given frame
+	C4Group Grp;
+	if (!Grp.Open(szRecord))
+		return false;
+	StdStrBuf KeyframeName, EntryName; int32_t iKeyframeFrame = 0;
+	for (bool fFound = Grp.FindEntry(C4CFN_RecKeyframes, &EntryName); fFound; fFound = Grp.FindNextEntry(C4CFN_RecKeyframes, &EntryName))
+	{
+		C4Group KeyframeGrp; StdStrBuf KeyframeBuf; C4RecordKeyframe Keyframe;
+		if (!KeyframeGrp.OpenAsChild(&Grp, EntryName.getData()) ||
+		    !KeyframeGrp.LoadEntryString(C4CFN_RecKeyframeInfo, &KeyframeBuf) ||
+		    !CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(Keyframe, "Keyframe"), KeyframeBuf, C4CFN_RecKeyframeInfo))
+			continue;
+		if (Keyframe.Frame <= iFrame && Keyframe.Frame > iKeyframeFrame)
+		{
+			KeyframeName.Copy(EntryName);
+			iKeyframeFrame = Keyframe.Frame;
+		}
+	}
+	if (!KeyframeName.getLength())
+	{
+		// nothing to skip: the whole record will be fast-forwarded
+		Grp.Close();
+		return true;
+	}
+	LogF("Record: Seeking from keyframe at frame %d", (int) iKeyframeFrame);
+
+	// Put keyframe to temporary file and unpack
+	char szKeyframe[_MAX_PATH_LEN];
+	SCopy(Config.AtTempPath("~keyframe.tmp"), szKeyframe, _MAX_PATH);
+	MakeTempFilename(szKeyframe);
+	if (!Grp.ExtractEntry(KeyframeName.getData(), szKeyframe) ||
+	    !Grp.Close() ||
+	    !C4Group_UnpackDirectory(szKeyframe))
+		return false;
+
+	// Copy record
+	char szSeekRecord[_MAX_PATH_LEN];
+	SCopy(Config.AtTempPath(GetFilename(szRecord)), szSeekRecord, _MAX_PATH);
+	MakeTempFilename(szSeekRecord);
+	SAppend(".ocs", szSeekRecord, _MAX_PATH);
+	if (!C4Group_CopyItem(szRecord, szSeekRecord))
+		{ EraseItem(szKeyframe); return false; }
+
+	// Merge keyframe over the initial state; other keyframes aren't needed
+	// Without the initial player infos, the players are restored from the keyframe like in runtime records
+	bool fSuccess = Grp.Open(szSeekRecord) &&
+	                Grp.Delete(C4CFN_RecKeyframes) &&
+	                Grp.Delete(C4CFN_PlayerInfos) &&
+	                Grp.Merge(szKeyframe) &&
+	                Grp.Close();
+	EraseItem(szKeyframe);
+	if (!fSuccess)
+	{
+		EraseItem(szSeekRecord);
+		return false;
+	}
+	pSeekRecord->Copy(szSeekRecord);
+	return true;
+}
+
+void C4RecordVerification::Result::CompileFunc(StdCompiler *pComp)
+{
+	StdCopyStrBuf ResultName(IsPassed() ? "Passed" : !Started ? "Failed" : (DebugRecDivergence >= 0 || SyncDivergence >= 0) ? "Diverged" : "Incomplete");
+	pComp->Value(mkNamingAdapt(Record, "File"));
+	pComp->Value(mkNamingAdapt(ResultName, "Result"));
+	pComp->Value(mkNamingAdapt(Frames, "Frames"));
+	pComp->Value(mkNamingAdapt(LoadTime, "LoadTime"));
+	pComp->Value(mkNamingAdapt(RunTime, "RunTime"));
+	int32_t iTicksPerSecond = RunTime ? int32_t(int64_t(Frames) * 1000 / RunTime) : 0;
+	pComp->Value(mkNamingAdapt(iTicksPerSecond, "TicksPerSecond"));
+	pComp->Value(mkNamingAdapt(DebugRecDivergence, "DebugRecDivergence", -1));
+	pComp->Value(mkNamingAdapt(SyncDivergence, "SyncDivergence", -1));
+	pComp->Value(mkNamingAdapt(Divergence, "Divergence", StdCopyStrBuf()));
+}
+
+void C4RecordVerification::AddRecords(const char *szFilename)
+{
+	// single record
+	if (SEqualNoCase(GetExtension(szFilename), "ocs"))
+	{
+		Records.emplace_back(szFilename);
+		return;
+	}
+	// folder of records
+	C4Group Grp; StdStrBuf EntryName;
+	if (!Grp.Open(szFilename))
+	{
+		LogF("Record verification: Cannot open %s", szFilename);
+		return;
+	}
+	for (bool fFound = Grp.FindEntry(C4CFN_ScenarioFiles, &EntryName); fFound; fFound = Grp.FindNextEntry(C4CFN_ScenarioFiles, &EntryName))
+		Records.emplace_back(FormatString("%s" DirSep "%s", szFilename, EntryName.getData()));
+}
+
+const char *C4RecordVerification::StartNextRecord()
+{
+	if (Records.empty()) return nullptr;
+	Results.emplace_back();
+	Result &Current = Results.back();
+	Current.Record.Take(Records.front());
+	Records.pop_front();
+	fPlaying = true;
+	tLoadStart = C4TimeMilliseconds::Now();
+	LogF("Record verification: %s (%d remaining)", Current.Record.getData(), (int) Records.size());
+	return Current.Record.getData();
+}
+
+void C4RecordVerification::OnGameStarted()
+{
+	if (!fPlaying) return;
+	Result &Current = Results.back();
+	Current.Started = true;
+	tRunStart = C4TimeMilliseconds::Now();
+	Current.LoadTime = tRunStart - tLoadStart;
+	iStartFrame = Game.FrameCounter;
+	// no waiting for the timer
+	Game.FullSpeed = true;
+}
+
+void C4RecordVerification::OnDivergence(bool fSyncCheck, const char *szMessage)
+{
+	if (!fPlaying) return;
+	Result &Current = Results.back();
+	int32_t &iDivergence = fSyncCheck ? Current.SyncDivergence : Current.DebugRecDivergence;
+	if (iDivergence >= 0) return;
+	iDivergence = Game.FrameCounter;
+	if (!Current.Divergence.getLength()) Current.Divergence.Copy(szMessage);
+}
+
+void C4RecordVerification::Finish(bool fComplete)
+{
+	if (!fPlaying) return;
+	fPlaying = false;
+	Result &Current = Results.back();
+	Current.Complete = fComplete;
+	if (Current.Started)
+	{
+		Current.Frames = Game.FrameCounter - iStartFrame;
+		Current.RunTime = C4TimeMilliseconds::Now() - tRunStart;
+	}
+	else
+		Current.LoadTime = C4TimeMilliseconds::Now() - tLoadStart;
+	LogF("Record verification: %s %s after %d frames", Current.Record.getData(), Current.IsPassed() ? "passed" : "failed", (int) Current.Frames);
+	// keep summary up to date, in case the engine crashes on a later record
+	SaveSummary();
+}
+
+bool C4RecordVerification::IsPassed() const
+{
+	// not verifying anything must not pass silently
+	if (Results.empty()) return false;
+	return std::all_of(Results.begin(), Results.end(), [](const Result &r) { return r.IsPassed(); });
+}
+
+bool C4RecordVerification::SaveSummary()
+{
+	if (!DecompileToBuf<StdCompilerINIWrite>(*this).SaveToFile(SummaryFilename.getData()))
+	{
+		LogF("Record verification: Cannot write %s", SummaryFilename.getData());
+		return false;
+	}
+	return true;
+}
+
+void C4RecordVerification::CompileFunc(StdCompiler *pComp)
+{
+	int32_t iRecords = Results.size(), iPassed = 0, iFailed, iFrames = 0; uint32_t iRunTime = 0;
+	for (const Result &r : Results)
+	{
+		if (r.IsPassed()) ++iPassed;
+		iFrames += r.Frames;
+		iRunTime += r.RunTime;
+	}
+	iFailed = iRecords - iPassed;
+	int32_t iTicksPerSecond = iRunTime ? int32_t(int64_t(iFrames) * 1000 / iRunTime) : 0;
+	pComp->Name("Summary");
+	pComp->Value(mkNamingAdapt(iRecords, "Records"));
+	pComp->Value(mkNamingAdapt(iPassed, "Passed"));
+	pComp->Value(mkNamingAdapt(iFailed, "Failed"));
+	pComp->Value(mkNamingAdapt(iFrames, "Frames"));
+	pComp->Value(mkNamingAdapt(iTicksPerSecond, "TicksPerSecond"));
+	pComp->NameEnd();
+	for (Result &r : Results)
+		pComp->Value(mkNamingAdapt(r, "Record"));
+}
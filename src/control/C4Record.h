@@ -22,6 +22,7 @@ class C4Record;
 
 #include "c4group/C4Group.h"
 #include "control/C4Control.h"
+#include "platform/C4TimeMilliseconds.h"
 
 extern int DoNoDebugRec; // debugrec disable counter in C4Record.cpp
 
@@ -119,6 +120,14 @@ public:
 	virtual ~C4RecordChunk() = default;
 };
 
+struct C4RecordKeyframe // position in the control record at which a keyframe was saved
+{
+	int32_t Frame{0}; // game frame of the keyframe
+	int32_t Chunk{0}; // index of the control chunk that was executing
+	int32_t SkipPackets{0}; // packets of that chunk that had been executed already
+	void CompileFunc(StdCompiler *pComp);
+};
+
 struct C4RCSetPix
 {
 	int x,y; // pos
@@ -249,6 +258,9 @@ private:
 	C4Group RecordGrp; // record scenario group
 	bool fRecording{false}; // set if recording is active
 	uint32_t iLastFrame; // frame of last chunk written
+	int32_t iChunks; // number of chunks written
+	int32_t iLastCtrlChunk; // index of last control chunk written
+	int32_t iLastKeyframe; // frame of last keyframe (or of record start)
 	bool fStreaming{false}; // perdiodically sent new control to server
 	unsigned int iStreamingPos; // Position of current buffer in stream
 	StdBuf StreamingData; // accumulated control data since last stream sync
@@ -259,6 +271,7 @@ public:
 	int Index;
 
 	bool IsRecording() const { return fRecording; } // return whether Start() has been called
+	int32_t GetLastKeyframe() const { return iLastKeyframe; }
 	unsigned int GetStreamingPos() const { return iStreamingPos; }
 	const StdBuf &GetStreamingBuf() const { return StreamingData; }
 
@@ -270,6 +283,7 @@ public:
 	bool Rec(int iFrame, const StdBuf &sBuf, C4RecordChunkType eType);
 
 	bool AddFile(const char *szLocalFilename, const char *szAddAs, bool fDelete = false);
+	bool SaveKeyframe(int32_t iSkipPackets); // save synchronized game state for seeking; called while the last control chunk executes
 
 	bool StartStreaming(bool fInitial);
 	void ClearStreamingBuf(unsigned int iAmount);
@@ -294,6 +308,7 @@ private:
 	StdBuf sequentialBuffer; // buffer to manage sequential reads
 	uint32_t iLastSequentialFrame; // frame number of last chunk read
 	void Finish(); // end playback
+	bool SkipToKeyframe(const C4RecordKeyframe &Keyframe); // skip control that has been executed before the keyframe
 	C4PacketList DebugRec;
 public:
 	C4Playback(); // constructor; init playback
@@ -313,6 +328,43 @@ public:
 	void Check(C4RecordChunkType eType, const uint8_t *pData, int iSize); // compare with debugrec
 	void DebugRecError(const char *szError);
 	static bool StreamToRecord(const char *szStream, StdStrBuf *pRecord);
+	static bool GetKeyframeRecord(const char *szRecord, int32_t iFrame, StdStrBuf *pSeekRecord); // create record starting at the last keyframe up to iFrame
+};
+
+class C4RecordVerification // plays records one after another at full speed and checks them (--verify-records)
+{
+public:
+	struct Result
+	{
+		StdCopyStrBuf Record; // record file name
+		bool Started{false}; // set if the game could be started
+		bool Complete{false}; // set if the playback reached the end of the record
+		int32_t Frames{0}; // number of frames played
+		uint32_t LoadTime{0}, RunTime{0}; // in milliseconds
+		int32_t DebugRecDivergence{-1}, SyncDivergence{-1}; // first frames at which debugrec or sync check failed
+		StdCopyStrBuf Divergence; // message of first divergence
+
+		bool IsPassed() const { return Started && Complete && DebugRecDivergence < 0 && SyncDivergence < 0; }
+		void CompileFunc(StdCompiler *pComp);
+	};
+private:
+	StdCopyStrBuf SummaryFilename;
+	std::list<StdCopyStrBuf> Records; // records still to be played
+	std::vector<Result> Results;
+	bool fPlaying{false}; // set while the last result is being determined
+	int32_t iStartFrame{0};
+	C4TimeMilliseconds tLoadStart, tRunStart;
+public:
+	C4RecordVerification(const char *szSummaryFilename) : SummaryFilename(szSummaryFilename) {}
+
+	void AddRecords(const char *szFilename); // add a record or all records in a folder
+	const char *StartNextRecord(); // returns nullptr if all records have been played
+	void OnGameStarted();
+	void OnDivergence(bool fSyncCheck, const char *szMessage);
+	void Finish(bool fComplete); // end of the current record
+	bool IsPassed() const; // false if no record was verified
+	bool SaveSummary();
+	void CompileFunc(StdCompiler *pComp);
 };
 
 #endif
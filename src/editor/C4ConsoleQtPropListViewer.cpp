@@ -709,7 +709,7 @@ QString C4PropertyDelegateEffect::GetDisplayString(const C4Value &v, C4Object *o
 	{
 		if (effect->IsActive())
 		{
-			return QString("t=%1, interval=%2").arg(effect->iTime).arg(effect->iInterval);
+			return QString("t=%1, interval=%2").arg(effect->GetTime()).arg(effect->iInterval);
 		}
 		else
 		{
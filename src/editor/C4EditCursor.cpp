@@ -891,7 +891,7 @@ void C4EditCursor::Draw(C4TargetFacet &cgo)
 		if (!creator_overlay)
 		{
 			creator_overlay = std::make_unique<C4GraphicsOverlay>();
-			creator_overlay->SetAsBase(&creator_def->Graphics, C4GFXBLIT_ADDITIVE);
+			creator_overlay->SetAsBase(&creator_def->GetGraphics(), C4GFXBLIT_ADDITIVE);
 		}
 		creator_overlay->Draw(cgo_creator, nullptr, NO_OWNER);
 	}
@@ -22,6 +22,7 @@
 #include "game/C4Application.h"
 
 #include "C4Version.h"
+#include "control/C4Record.h"
 #include "editor/C4Console.h"
 #include "game/C4FullScreen.h"
 #include "game/C4GraphicsSystem.h"
@@ -104,6 +105,7 @@ bool C4Application::DoInit(int argc, char * argv[])
 	C4Group_SetProcessCallback(&ProcessCallback);
 	C4Group_SetTempPath(Config.General.TempPath.getData());
 	C4Group_SetSortList(C4CFN_FLS);
+	SetFileChecksumCache(Config.AtUserDataPath(C4CFN_ChecksumCache));
 
 	// Cleanup temp folders left behind
 	Config.CleanupTempUpdateFolder();
@@ -234,6 +236,11 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"startup", required_argument, nullptr, 's'},
 			{"stream", required_argument, nullptr, 'e'},
 			{"recdump", required_argument, nullptr, 'R'},
+			{"seek", required_argument, nullptr, 'k'},
+			{"verify-records", required_argument, nullptr, 'V'},
+			{"profile-scripts", required_argument, nullptr, 'F'},
+			{"trace", required_argument, nullptr, 'T'},
+			{"lazy-defs", optional_argument, nullptr, 'z'},
 			{"comment", required_argument, nullptr, 'm'},
 			{"pass", required_argument, nullptr, 'p'},
 			{"udpport", required_argument, nullptr, 'u'},
@@ -336,6 +343,19 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 		case 'm': Config.Network.Comment.CopyValidated(optarg); break;
 		// record dump
 		case 'R': Game.RecordDumpFile.Copy(optarg); break;
+		// replay start frame
+		case 'k': Game.RecordSeekFrame = std::max(atoi(optarg), 0); break;
+		// batch record verification with summary file
+		case 'V': RecordVerification = std::make_unique<C4RecordVerification>(optarg); break;
+		// script profiler output
+		case 'F': Game.ScriptProfileFile.Copy(optarg); break;
+		// engine trace output
+		case 'T': Game.TraceFile.Copy(optarg); break;
+		// lazy definition loading, optionally with a manifest of graphics to preload
+		case 'z':
+			Game.LazyDefinitions = true;
+			if (optarg) Game.DefGraphicsManifest.Copy(optarg);
+			break;
 		// record stream
 		case 'e': Game.RecordStream.Copy(optarg); break;
 		// startup start screen
@@ -389,6 +409,16 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 				szParameter[iLen-1] = '\0';
 			}
 		}
+		// Records or record folders to verify
+		if (RecordVerification && (SEqualNoCase(GetExtension(szParameter),"ocs") || SEqualNoCase(GetExtension(szParameter),"ocf") || DirectoryExists(szParameter)))
+		{
+			if(IsGlobalPath(szParameter))
+				RecordVerification->AddRecords(szParameter);
+			else
+				RecordVerification->AddRecords((std::string(GetWorkingDirectory()) + DirSep + szParameter).c_str());
+
+			continue;
+		}
 		// Scenario file
 		if (SEqualNoCase(GetExtension(szParameter),"ocs"))
 		{
@@ -481,6 +511,20 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 	Game.RecordStream.ReplaceChar(AltDirectorySeparator, DirectorySeparator);
 #endif
 
+	// Record verification: play the records one after another, without network and recording
+	if (RecordVerification)
+	{
+		const char *szRecord = RecordVerification->StartNextRecord();
+		if (szRecord)
+			Game.SetScenarioFilename(szRecord);
+		else
+			Log("Record verification: No records given.");
+		isEditor = false;
+		Game.NetworkActive = false;
+		Game.Record = false;
+		Config.Network.LeagueServerSignUp = false;
+	}
+
 	// Default to editor if scenario given, player mode otherwise
 	if (isEditor == 2)
 		isEditor = !!*Game.ScenarioFilename && !Config.General.OpenScenarioInGameMode;
@@ -611,6 +655,8 @@ void C4Application::Clear()
 	IRCClient.Close();
 	// close system group (System.ocg)
 	SystemGroup.Close();
+	// keep checksums of unchanged files for the next start
+	SaveFileChecksumCache();
 	// Log
 	if (::Languages.HasStringTable()) // Avoid (double and undefined) message on (second?) shutdown...
 		Log(LoadResStr("IDS_PRC_DEINIT"));
@@ -641,6 +687,8 @@ void C4Application::Quit()
 {
 	// Participants should not be cleared for usual startup dialog
 
+	// Aborted record verification: Keep what has been verified so far
+	if (RecordVerification) RecordVerification->Finish(false);
 	// Save config if there was no loading error
 	if (Config.ConfigLoaded) Config.Save();
 	// make sure startup data is unloaded
@@ -669,6 +717,13 @@ void C4Application::OpenGame(const char * scenario)
 
 void C4Application::QuitGame()
 {
+	// verifying records? Continue with the next one
+	if (RecordVerification)
+	{
+		RecordVerification->Finish(false);
+		const char *szRecord = RecordVerification->StartNextRecord();
+		if (szRecord) SetNextMission(szRecord);
+	}
 	// reinit desired? Do restart
 	if (!QuitAfterGame || !NextMission.empty())
 	{
@@ -718,6 +773,7 @@ void C4Application::GameTick()
 			QuitGame();
 			break;
 		}
+		if (RecordVerification) RecordVerification->OnGameStarted();
 		if(Config.Graphics.Windowed == 2 && FullScreenMode())
 			Application.SetVideoMode(GetConfigWidth(), GetConfigHeight(), Config.Graphics.RefreshRate, Config.Graphics.Monitor, true);
 		if (!isEditor)
@@ -26,6 +26,7 @@
 #include "platform/C4SoundSystem.h"
 
 class C4ApplicationGameTimer;
+class C4RecordVerification;
 
 /* Main class to initialize configuration and execute the game */
 
@@ -78,6 +79,8 @@ public:
 	std::string IncomingUpdate;
 	// set by ParseCommandLine, for manually invoking an update check by command line or url
 	int CheckForUpdates{false};
+	// set by ParseCommandLine, for playing and checking records in batch
+	std::unique_ptr<C4RecordVerification> RecordVerification;
 
 	bool FullScreenMode();
 	int GetConfigWidth()  { return (!FullScreenMode()) ? Config.Graphics.WindowX : Config.Graphics.ResX; }
@@ -77,6 +77,7 @@
 #include "script/C4AulDebug.h"
 #include "script/C4AulExec.h"
 #include "script/C4Effect.h"
+#include "script/C4ScriptHeap.h"
 
 #include <unordered_map>
 
@@ -127,6 +128,8 @@ bool C4Game::InitDefs()
 	{
 		++def_res_count;
 	}
+	DWORD load_what = C4D_Load_RX;
+	if (LazyDefinitions) load_what |= C4D_Load_LazyGraphics;
 	int i = 0;
 	// Load specified defs
 	for (def = Parameters.GameRes.iterRes(nullptr, NRT_Definitions); def; def = Parameters.GameRes.iterRes(def, NRT_Definitions))
@@ -134,7 +137,7 @@ bool C4Game::InitDefs()
 		int min_progress = 25 + (25 * i) / def_res_count;
 		int max_progress = 25 + (25 * (i + 1)) / def_res_count;
 		++i;
-		def_count += ::Definitions.Load(def->getFile(),C4D_Load_RX, Config.General.LanguageEx,&Application.SoundSystem, true, min_progress, max_progress);
+		def_count += ::Definitions.Load(def->getFile(),load_what, Config.General.LanguageEx,&Application.SoundSystem, true, min_progress, max_progress);
 
 		// Def load failure
 		if (::Definitions.LoadFailure)
@@ -144,7 +147,7 @@ bool C4Game::InitDefs()
 	}
 
 	// Load for scenario file - ignore sys group here, because it has been loaded already
-	def_count += ::Definitions.Load(ScenarioFile, C4D_Load_RX, Config.General.LanguageEx,&Application.SoundSystem, true, true, 35, 40, false);
+	def_count += ::Definitions.Load(ScenarioFile, load_what, Config.General.LanguageEx,&Application.SoundSystem, true, true, 35, 40, false);
 
 	// Absolutely no defs: we don't like that
 	if (!def_count)
@@ -169,6 +172,13 @@ bool C4Game::InitDefs()
 	// handle skeleton appends and includes
 	::Definitions.AppendAndIncludeSkeletons();
 
+	// preload the graphics that were used last time
+	if (LazyDefinitions && DefGraphicsManifest.getLength())
+	{
+		int32_t preload_count = ::Definitions.LoadGraphicsManifest(DefGraphicsManifest.getData());
+		if (preload_count) LogF("Preloaded graphics of %d definitions", (int) preload_count);
+	}
+
 	// Done
 	return true;
 }
@@ -197,6 +207,22 @@ bool C4Game::OpenScenario()
 	}
 	LogF(LoadResStr("IDS_PRC_LOADC4S"),ScenarioFilename);
 
+	// Seeking in record: replace by a copy starting at the last keyframe
+	if (RecordSeekFrame > 0)
+	{
+		StdStrBuf SeekRecord;
+		if (!C4Playback::GetKeyframeRecord(ScenarioFilename, RecordSeekFrame, &SeekRecord))
+		{
+			LogFatal("[!] Could not seek in record!");
+			return false;
+		}
+		if (SeekRecord.getLength())
+		{
+			SCopy(SeekRecord.getData(), ScenarioFilename, _MAX_PATH);
+			TempScenarioFile.Copy(SeekRecord);
+		}
+	}
+
 	// get parent folder, if it's ocf
 	pParentGroup = GroupSet.RegisterParentFolders(ScenarioFilename);
 
@@ -638,6 +664,12 @@ bool C4Game::Init()
 	// game running now!
 	IsRunning = true;
 
+	// profile the whole round if requested on the command line
+	if (ScriptProfileFile.getLength())
+		C4AulProfiler::StartProfiling(nullptr);
+	if (TraceFile.getLength())
+		C4Stat::getMainStat()->Start();
+
 	// Start message
 	Log(LoadResStr(C4S.Head.NetworkGame ? "IDS_PRC_JOIN" : C4S.Head.SaveGame ? "IDS_PRC_RESUME" : "IDS_PRC_START"));
 
@@ -676,12 +708,16 @@ void C4Game::Clear()
 	// fade out music
 	Application.MusicSystem.FadeOut(2000);
 
+	// remember which graphics were needed, if the round got started at all
+	if (IsRunning && LazyDefinitions && DefGraphicsManifest.getLength())
+		if (!::Definitions.SaveGraphicsManifest(DefGraphicsManifest.getData()))
+			LogF("Error writing definition graphics manifest %s", DefGraphicsManifest.getData());
+
 	// game no longer running
 	IsRunning = false;
 	PointersDenumerated = false;
 
-	C4ST_SHOWSTAT
-	// C4ST_RESET
+	C4Stat::getMainStat()->Stop(TraceFile.getData());
 
 	// Evaluation
 	if (GameOver)
@@ -694,6 +730,7 @@ void C4Game::Clear()
 
 	// stop statistics
 	pNetworkStatistics.reset();
+	C4AulProfiler::StopProfiling(ScriptProfileFile.getData());
 	C4AulProfiler::Abort();
 
 	// next mission (shoud have been transferred to C4Application now if next mission was desired)
@@ -723,7 +760,10 @@ void C4Game::Clear()
 	Names.Clear();
 	GameText.Clear();
 	RecordDumpFile.Clear();
+	ScriptProfileFile.Clear();
+	TraceFile.Clear();
 	RecordStream.Clear();
+	RecordSeekFrame = 0;
 
 #ifdef WITH_QT_EDITOR
 	// clear console pointers held into script engine
@@ -846,6 +886,8 @@ bool C4Game::GameOverCheck()
 	return GameOver;
 }
 
+C4ST_NEW(FrameStat,         "C4Game::Execute")
+C4ST_NEW(NetworkStat,       "C4Game::Execute Network.Execute")
 C4ST_NEW(ControlRcvStat,    "C4Game::Execute ReceiveControl")
 C4ST_NEW(ControlStat,       "C4Game::Execute ExecuteControl")
 C4ST_NEW(ExecObjectsStat,   "C4Game::Execute ExecObjects")
@@ -858,6 +900,10 @@ C4ST_NEW(PlayersStat,       "C4Game::Execute Players.Execute")
 C4ST_NEW(LandscapeStat,     "C4Game::Execute Landscape.Execute")
 C4ST_NEW(MusicSystemStat,   "C4Game::Execute MusicSystem.Execute")
 C4ST_NEW(MessagesStat,      "C4Game::Execute Messages.Execute")
+C4ST_NEW(ScriptHeapStat,    "C4Game::Execute ScriptHeap.Collect")
+
+// script heap objects traced for reference cycles after each frame
+const int32_t ScriptHeapSliceSize = 5000;
 
 #define EXEC_S(Expressions, Stat) \
   { C4ST_START(Stat) Expressions C4ST_STOP(Stat) }
@@ -871,7 +917,7 @@ bool C4Game::Execute() // Returns true if the game is over
 	GameGo = true;
 
 	// Network
-	Network.Execute();
+	EXEC_S(     Network.Execute();                , NetworkStat )
 
 	// Prepare control
 	bool control_prepared;
@@ -892,6 +938,9 @@ bool C4Game::Execute() // Returns true if the game is over
 		Landscape.DoRelights();
 	}
 
+	// Frame time for the histogram
+	C4ST_START(FrameStat)
+
 	// Execute the control
 	Control.Execute();
 	if (!IsRunning)
@@ -923,6 +972,7 @@ bool C4Game::Execute() // Returns true if the game is over
 	EXEC_S_DR(  Landscape.Execute();              , LandscapeStat       , "LdsEx")
 	EXEC_S_DR(  Players.Execute();                , PlayersStat         , "PlrEx")
 	EXEC_S_DR(  ::Messages.Execute();             , MessagesStat        , "MsgEx")
+	EXEC_S(     C4ScriptHeap::Collect(ScriptHeapSliceSize); , ScriptHeapStat )
 
 	EXEC_DR(    MouseControl.Execute();                                 , "Input")
 
@@ -943,11 +993,14 @@ bool C4Game::Execute() // Returns true if the game is over
 		}
 	}
 
+	uint64_t tFrame = FrameStatScope.Stop();
+	if (tFrame) C4Stat::getMainStat()->AddFrame(tFrame);
+
 	// show stat each 1000 ticks
-	if (!(FrameCounter % 1000))
+	if (!(FrameCounter % 1000) && C4Stat::getMainStat()->IsRecording())
 	{
-		C4ST_SHOWPARTSTAT(FrameCounter)
-		C4ST_RESETPART
+		C4Stat::getMainStat()->ShowPart(FrameCounter);
+		C4Stat::getMainStat()->ResetPart();
 	}
 
 	if (Config.General.DebugRec)
@@ -2775,7 +2828,7 @@ bool C4Game::InitGame(C4Group &group, InitMode init_mode, bool load_sky, C4Value
 	}
 	SetInitProgress(89);
 	// Init main object list
-	Objects.Init(Landscape.GetWidth(), Landscape.GetHeight());
+	Objects.Init(Landscape.GetWidth(), Landscape.GetHeight(), C4S.Landscape.ObjectSectorSize);
 
 	// Pathfinder
 	if (init_mode == IM_Normal)
@@ -4673,7 +4726,7 @@ float C4Game::GetTextSpecImageAspect(const char* spec)
 			return -1.0f;
 		}
 
-		C4DefGraphics* gfx = &def->Graphics;
+		C4DefGraphics* gfx = &def->GetGraphics();
 		if (gfx->Type == C4DefGraphics::TYPE_Bitmap)
 		{
 			return static_cast<float>(def->PictureRect.Wdt) / static_cast<float>(def->PictureRect.Hgt);
@@ -4722,7 +4775,7 @@ bool C4Game::DrawPropListSpecImage(C4Facet &target, C4PropList *spec)
 	else
 	{
 		// Alternative named graphics
-		C4DefGraphics *source_graphics = source_def->Graphics.Get(source_name->GetCStr());
+		C4DefGraphics *source_graphics = source_def->GetGraphics().Get(source_name->GetCStr());
 		if (!source_graphics)
 		{
 			return false;
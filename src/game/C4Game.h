@@ -123,7 +123,12 @@ public:
 	bool NetworkActive;
 	bool Record;
 	StdStrBuf RecordDumpFile;
+	StdStrBuf ScriptProfileFile; // profile all scripts while the game is running and save the call graph here
+	StdStrBuf TraceFile; // record engine statistics while the game is running and save the trace here
+	bool LazyDefinitions{false}; // load definition graphics when they are first used
+	StdStrBuf DefGraphicsManifest; // with LazyDefinitions: preload the graphics listed here and list the ones used by the round afterwards
 	StdStrBuf RecordStream;
+	int32_t RecordSeekFrame{0}; // replay: start from the last record keyframe up to this frame and fast-forward to it
 	StdStrBuf TempScenarioFile;
 	bool fPreinited{false}; // set after PreInit has been called; unset by Clear and Default
 	int32_t FrameCounter;
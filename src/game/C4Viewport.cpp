@@ -285,6 +285,8 @@ void C4Viewport::Draw(C4TargetFacet &cgo0, bool draw_game, bool draw_overlay)
 		// Update FoW
 		if (FoW)
 		{
+			// Pending landscape changes invalidate light sections, so apply them first
+			::Landscape.DoRelights();
 			// Viewport region in landscape coordinates
 			const FLOAT_RECT vpRect = { cgo.TargetX, cgo.TargetX + cgo.Wdt, cgo.TargetY, cgo.TargetY + cgo.Hgt };
 			// Region in which the light is calculated
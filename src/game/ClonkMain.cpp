@@ -21,6 +21,7 @@
 #include "game/C4Application.h"
 
 #include "C4Version.h"
+#include "control/C4Record.h"
 #include "network/C4Network2.h"
 
 #ifdef _WIN32
@@ -99,6 +100,7 @@ int WINAPI WinMain (HINSTANCE hInst,
 		delete[] *it;
 	argv.clear();
 	// Return exit code
+	if (Application.RecordVerification) return Application.RecordVerification->IsPassed() ? C4XRV_Completed : C4XRV_Failure;
 	if (!Game.GameOver) return C4XRV_Aborted;
 	return C4XRV_Completed;
 }
@@ -243,6 +245,7 @@ int main (int argc, char * argv[])
 	Application.Clear();
 	if (Application.restartAtEnd) restart(argv);
 	// Return exit code
+	if (Application.RecordVerification) return Application.RecordVerification->IsPassed() ? C4XRV_Completed : C4XRV_Failure;
 	if (!Game.GameOver) return C4XRV_Aborted;
 	return C4XRV_Completed;
 }
@@ -70,7 +70,7 @@ namespace C4GUI
 		int32_t tx = act->GetPropertyInt(P_OffX);
 		int32_t ty = act->GetPropertyInt(P_OffY);
 		if (!wdt || !hgt) return false;
-		rfctTarget.Set(pOfDef->Graphics.GetBitmap(), x, y, wdt, hgt, tx, ty);
+		rfctTarget.Set(pOfDef->GetGraphics().GetBitmap(), x, y, wdt, hgt, tx, ty);
 		return true;
 	}
 
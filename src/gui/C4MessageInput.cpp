@@ -25,9 +25,11 @@
 #include "graphics/C4GraphicsResource.h"
 #include "gui/C4Gui.h"
 #include "gui/C4GameLobby.h"
+#include "lib/C4Stat.h"
 #include "object/C4Object.h"
 #include "player/C4Player.h"
 #include "player/C4PlayerList.h"
+#include "script/C4AulExec.h"
 
 // --------------------------------------------------
 // C4ChatInputDialog
@@ -571,6 +573,8 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 			LogF("/nodebug - %s", LoadResStr("IDS_TEXT_PREVENTDEBUGMODEINTHISROU"));
 			LogF("/script [script] - %s", LoadResStr("IDS_TEXT_EXECUTEASCRIPTCOMMAND"));
 			LogF("/screenshot [zoom] - %s", LoadResStr("IDS_TEXT_SAFEZOOMEDFULLSCREENSHOT"));
+			LogF("/profile start|stop [filename] - %s", LoadResStr("IDS_TEXT_PROFILESCRIPTS"));
+			LogF("/trace start|stop [filename] - %s", LoadResStr("IDS_TEXT_TRACEENGINE"));
 		}
 		LogF("/kick [client] - %s", LoadResStr("IDS_TEXT_KICKTHESPECIFIEDCLIENT"));
 		LogF("/observer [client] - %s", LoadResStr("IDS_TEXT_SETTHESPECIFIEDCLIENTTOOB"));
@@ -769,6 +773,38 @@ bool C4MessageInput::ProcessCommand(const char *szCommand)
 		return true;
 	}
 
+	// script profiler; only measures the local client, so no control is needed
+	if (SEqual(szCmdName, "profile"))
+	{
+		if (!Game.IsRunning) return false;
+		StdStrBuf sAction, sFilename;
+		sAction.Copy(pCmdPar);
+		sAction.SplitAtChar(' ', &sFilename);
+		if (SEqual(sAction.getData(), "start"))
+			C4AulProfiler::StartProfiling(nullptr);
+		else if (SEqual(sAction.getData(), "stop"))
+			C4AulProfiler::StopProfiling(sFilename.getData());
+		else
+			return false;
+		return true;
+	}
+
+	// engine statistics; also local only
+	if (SEqual(szCmdName, "trace"))
+	{
+		if (!Game.IsRunning) return false;
+		StdStrBuf sAction, sFilename;
+		sAction.Copy(pCmdPar);
+		sAction.SplitAtChar(' ', &sFilename);
+		if (SEqual(sAction.getData(), "start"))
+			C4Stat::getMainStat()->Start();
+		else if (SEqual(sAction.getData(), "stop"))
+			C4Stat::getMainStat()->Stop(sFilename.getData());
+		else
+			return false;
+		return true;
+	}
+
 	// add to TODO list
 	if (SEqual(szCmdName, "todo"))
 	{
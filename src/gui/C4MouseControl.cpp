@@ -376,7 +376,7 @@ void C4MouseControl::Draw(C4TargetFacet &cgo, const ZoomData &GameZoom)
 			if(DragImageObject)
 				pGfx = DragImageObject->GetGraphics();
 			else
-				pGfx = &DragImageDef->Graphics;
+				pGfx = &DragImageDef->GetGraphics();
 
 			// Determine image boundaries
 			float ImageWdt;
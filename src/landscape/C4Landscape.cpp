@@ -28,6 +28,7 @@
 #include "game/C4Physics.h"
 #include "graphics/C4GraphicsResource.h"
 #include "gui/C4GameMessage.h"
+#include "landscape/C4LandscapeDiff.h"
 #include "landscape/C4LandscapeRender.h"
 #include "landscape/C4Map.h"
 #include "landscape/C4MapCreatorS2.h"
@@ -62,7 +63,10 @@ struct C4Landscape::P
 	bool Pix2Light[C4M_MaxTexIndex];
 	int32_t PixCntPitch = 0;
 	std::vector<uint8_t> PixCnt;
-	std::array<C4Rect, C4LS_MaxRelights> Relights;
+	// Tiles of C4LS_RelightTileSize that changed since the last DoRelights
+	std::vector<bool> RelightTiles;
+	int32_t RelightTilesWdt = 0, RelightTilesHgt = 0;
+	bool HasRelights = false;
 	mutable std::array<std::unique_ptr<uint8_t[]>, C4M_MaxTexIndex> BridgeMatConversion; // NoSave //
 
 	LandscapeMode mode = LandscapeMode::Undefined;
@@ -104,11 +108,14 @@ struct C4Landscape::P
 	void UpdateMatCnt(const C4Landscape *, C4Rect Rect, bool fPlus);
 	void PrepareChange(const C4Landscape *d, const C4Rect &BoundingBox, bool updateMatCnt = true);
 	void FinishChange(C4Landscape *d, C4Rect BoundingBox, bool updateMatAndPixCnt = true);
+	void AddRelight(C4Rect Rect); // mark all tiles touching Rect for relighting
+	bool GetRelightRect(C4Rect &Rect); // extract the next rectangle of dirty tiles and clear them
+	void ClearRelights();
 	bool DrawLineLandscape(int32_t iX, int32_t iY, int32_t iGrade, uint8_t line_color, uint8_t line_color_bkg);
 	bool DrawLineMap(int32_t iX, int32_t iY, int32_t iRadius, uint8_t line_color, uint8_t line_color_bkg);
 	uint8_t *GetBridgeMatConversion(const C4Landscape *d, int32_t for_material_col) const;
 	bool SaveInternal(const C4Landscape *d, C4Group &hGroup) const;
-	bool SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, bool fSyncSave) const;
+	bool SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, bool fSyncSave, bool fSaveUnchanged) const;
 
 	int32_t ForPolygon(C4Landscape *d, int *vtcs, int length, const std::function<bool(int32_t, int32_t)> &callback,
 		C4MaterialList *mats_count = nullptr, uint8_t col = 0, uint8_t colBkg = 0, uint8_t *conversion_table = nullptr);
@@ -389,29 +396,90 @@ void C4Landscape::Draw(C4TargetFacet &cgo, C4FoWRegion *pLight)
 
 bool C4Landscape::DoRelights()
 {
-	if (!p->pLandscapeRender) return true;
-	for (int32_t i = 0; i < C4LS_MaxRelights; i++)
+	if (!p->HasRelights) return true;
+	if (!p->pLandscapeRender && !p->pFoW)
 	{
-		if (!p->Relights[i].Wdt)
-			break;
-		// Remove all solid masks in the (twice!) extended region around the change
-		C4Rect SolidMaskRect = p->pLandscapeRender->GetAffectedRect(p->Relights[i]);
-		C4SolidMask * pSolid;
-		for (pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
-			pSolid->RemoveTemporary(SolidMaskRect);
-		// Perform the update
-		p->pLandscapeRender->Update(p->Relights[i], this);
-		if (p->pFoW) p->pFoW->Ambient.UpdateFromLandscape(*this, p->Relights[i]);
-		// Restore Solidmasks
-		for (pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
-			pSolid->PutTemporary(SolidMaskRect);
-		C4SolidMask::CheckConsistency();
-		// Clear slot
-		p->Relights[i].Default();
+		p->ClearRelights();
+		return true;
+	}
+	C4Rect Relight;
+	while (p->GetRelightRect(Relight))
+	{
+		if (p->pLandscapeRender)
+		{
+			// Remove all solid masks in the (twice!) extended region around the change
+			C4Rect SolidMaskRect = p->pLandscapeRender->GetAffectedRect(Relight);
+			C4SolidMask * pSolid;
+			for (pSolid = C4SolidMask::Last; pSolid; pSolid = pSolid->Prev)
+				pSolid->RemoveTemporary(SolidMaskRect);
+			// Perform the update
+			p->pLandscapeRender->Update(Relight, this);
+			// Restore Solidmasks
+			for (pSolid = C4SolidMask::First; pSolid; pSolid = pSolid->Next)
+				pSolid->PutTemporary(SolidMaskRect);
+			C4SolidMask::CheckConsistency();
+		}
+		if (p->pFoW)
+		{
+			p->pFoW->Invalidate(Relight);
+			p->pFoW->Ambient.UpdateFromLandscape(*this, Relight);
+		}
 	}
+	p->HasRelights = false;
 	return true;
 }
 
+void C4Landscape::P::AddRelight(C4Rect Rect)
+{
+	// (Re-)create tile map for the current landscape size
+	const int32_t TilesWdt = (Width + C4LS_RelightTileSize - 1) / C4LS_RelightTileSize;
+	const int32_t TilesHgt = (Height + C4LS_RelightTileSize - 1) / C4LS_RelightTileSize;
+	if (TilesWdt != RelightTilesWdt || TilesHgt != RelightTilesHgt)
+	{
+		RelightTilesWdt = TilesWdt; RelightTilesHgt = TilesHgt;
+		RelightTiles.assign(TilesWdt * TilesHgt, false);
+	}
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (Rect.Wdt <= 0 || Rect.Hgt <= 0) return;
+	const int32_t tx0 = Rect.x / C4LS_RelightTileSize, tx1 = (Rect.x + Rect.Wdt - 1) / C4LS_RelightTileSize;
+	const int32_t ty0 = Rect.y / C4LS_RelightTileSize, ty1 = (Rect.y + Rect.Hgt - 1) / C4LS_RelightTileSize;
+	for (int32_t ty = ty0; ty <= ty1; ++ty)
+		for (int32_t tx = tx0; tx <= tx1; ++tx)
+			RelightTiles[ty * RelightTilesWdt + tx] = true;
+	HasRelights = true;
+}
+
+bool C4Landscape::P::GetRelightRect(C4Rect &Rect)
+{
+	// Find the first dirty tile and grow a rectangle from it: first along the
+	// row, then downwards as long as the complete span of the next row is dirty.
+	for (int32_t ty = 0; ty < RelightTilesHgt; ++ty)
+		for (int32_t tx = 0; tx < RelightTilesWdt; ++tx)
+		{
+			if (!RelightTiles[ty * RelightTilesWdt + tx]) continue;
+			int32_t tx1 = tx + 1;
+			while (tx1 < RelightTilesWdt && RelightTiles[ty * RelightTilesWdt + tx1]) ++tx1;
+			int32_t ty1 = ty + 1;
+			for (; ty1 < RelightTilesHgt; ++ty1)
+			{
+				auto row = RelightTiles.begin() + ty1 * RelightTilesWdt;
+				if (!std::all_of(row + tx, row + tx1, [](bool dirty) { return dirty; })) break;
+			}
+			for (int32_t y = ty; y < ty1; ++y)
+				std::fill(RelightTiles.begin() + y * RelightTilesWdt + tx, RelightTiles.begin() + y * RelightTilesWdt + tx1, false);
+			Rect = C4Rect(tx * C4LS_RelightTileSize, ty * C4LS_RelightTileSize, (tx1 - tx) * C4LS_RelightTileSize, (ty1 - ty) * C4LS_RelightTileSize);
+			Rect.Intersect(C4Rect(0, 0, Width, Height));
+			return true;
+		}
+	return false;
+}
+
+void C4Landscape::P::ClearRelights()
+{
+	std::fill(RelightTiles.begin(), RelightTiles.end(), false);
+	HasRelights = false;
+}
+
 
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 /* +++++++++++++++++++++++ Add and destroy landscape++++++++++++++++++++++++ */
@@ -867,18 +935,9 @@ bool C4Landscape::_SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 	p->Surface8Bkg->SetPix(x, y, bgPix);
 	// note for relight
 	if (p->pLandscapeRender)
-	{
-		C4Rect CheckRect = p->pLandscapeRender->GetAffectedRect(C4Rect(x, y, 1, 1));
-		for (int32_t i = 0; i < C4LS_MaxRelights; i++)
-			if (!p->Relights[i].Wdt || p->Relights[i].Overlap(CheckRect) || i + 1 >= C4LS_MaxRelights)
-			{
-				p->Relights[i].Add(CheckRect);
-				break;
-			}
-		// Invalidate FoW
-		if (p->pFoW)
-			p->pFoW->Invalidate(CheckRect);
-	}
+		p->AddRelight(p->pLandscapeRender->GetAffectedRect(C4Rect(x, y, 1, 1)));
+	else if (p->pFoW)
+		p->AddRelight(C4Rect(x, y, 1, 1));
 	// success
 	return true;
 }
@@ -1373,9 +1432,10 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky, bool fClearRender
 	p->pInitial.reset();
 	p->pInitialBkg.reset();
 	p->pFoW.reset();
-	// clear relight array
-	for (auto &relight : p->Relights)
-		relight.Default();
+	// clear relight tiles
+	p->RelightTiles.clear();
+	p->RelightTilesWdt = p->RelightTilesHgt = 0;
+	p->HasRelights = false;
 	// clear scan
 	p->ScanX = 0;
 	p->mode = LandscapeMode::Undefined;
@@ -1731,71 +1791,23 @@ bool C4Landscape::P::SaveInternal(const C4Landscape *d, C4Group &hGroup) const
 	return true;
 }
 
-bool C4Landscape::SaveDiff(C4Group &hGroup, bool fSyncSave) const
+bool C4Landscape::SaveDiff(C4Group &hGroup, bool fSyncSave, bool fSaveUnchanged) const
 {
 	C4SolidMask::RemoveSolidMasks();
-	bool r = p->SaveDiffInternal(this, hGroup, fSyncSave);
+	bool r = p->SaveDiffInternal(this, hGroup, fSyncSave, fSaveUnchanged);
 	C4SolidMask::PutSolidMasks();
 	return r;
 }
 
-bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, bool fSyncSave) const
+bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, bool fSyncSave, bool fSaveUnchanged) const
 {
 	assert(pInitial && pInitialBkg);
 	if (!pInitial || !pInitialBkg) return false;
 
-	// If it shouldn't be sync-save: Clear all bytes that have not changed, i.e.
-	// set them to C4M_MaxTexIndex
-	bool fChanged = false, fChangedBkg = false;;
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (pInitial[y * Width + x] == Surface8->_GetPix(x, y))
-					Surface8->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChanged = true;
-
-				if (pInitialBkg[y * Width + x] == Surface8Bkg->_GetPix(x, y))
-					Surface8Bkg->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChangedBkg = true;
-			}
-
-	if (fSyncSave || fChanged)
-	{
-		// Save landscape surface
-		if (!Surface8->Save(Config.AtTempPath(C4CFN_TempLandscape)))
-			return false;
-
-		// Move temp file to group
-		if (!hGroup.Move(Config.AtTempPath(C4CFN_TempLandscape),
-			C4CFN_DiffLandscape))
-			return false;
-	}
-
-	if (fSyncSave || fChangedBkg)
-	{
-		// Save landscape surface
-		if (!Surface8Bkg->Save(Config.AtTempPath(C4CFN_TempLandscapeBkg)))
-			return false;
-
-		// Move temp file to group
-		if (!hGroup.Move(Config.AtTempPath(C4CFN_TempLandscapeBkg),
-			C4CFN_DiffLandscapeBkg))
-			return false;
-	}
-
-	// Restore landscape pixels
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-			{
-				if (Surface8->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8->SetPix(x, y, pInitial[y * Width + x]);
-				if (Surface8Bkg->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8Bkg->SetPix(x, y, pInitialBkg[y * Width + x]);
-			}
+	if (!SaveLandscapeDiff(*Surface8, pInitial.get(), hGroup, C4CFN_DiffLandscape, Config.AtTempPath(C4CFN_TempLandscape), fSyncSave, fSaveUnchanged))
+		return false;
+	if (!SaveLandscapeDiff(*Surface8Bkg, pInitialBkg.get(), hGroup, C4CFN_DiffLandscapeBkg, Config.AtTempPath(C4CFN_TempLandscapeBkg), fSyncSave, fSaveUnchanged))
+		return false;
 
 	// Save changed map, too
 	if (fMapChanged && Map)
@@ -1893,34 +1905,16 @@ bool C4Landscape::Load(C4Group &hGroup, bool fLoadSky, bool fSavegame)
 	if (fLoadSky)
 	{
 		Game.SetInitProgress(70);
-		if (p->Sky.Init(fSavegame)) return false;
+		if (!p->Sky.Init(fSavegame)) return false;
 	}
 	// Success
 	return true;
 }
 bool C4Landscape::ApplyDiff(C4Group &hGroup)
 {
-	std::unique_ptr<CSurface8> pDiff, pDiffBkg;
-	// Load diff landscape from group
-	pDiff = GroupReadSurface8(hGroup, C4CFN_DiffLandscape);
-	pDiffBkg = GroupReadSurface8(hGroup, C4CFN_DiffLandscapeBkg);
-	if (pDiff == nullptr && pDiffBkg == nullptr) return false;
-
-	// convert all pixels: keep if same material; re-set if different material
-	BYTE byPix;
-	for (int32_t y = 0; y < GetHeight(); ++y) for (int32_t x = 0; x < GetWidth(); ++x)
-	{
-		if (pDiff && pDiff->GetPix(x, y) != C4M_MaxTexIndex)
-			if (p->Surface8->_GetPix(x, y) != (byPix = pDiff->_GetPix(x, y)))
-				// material has changed here: readjust with new texture
-				p->Surface8->SetPix(x, y, byPix);
-		if (pDiffBkg && pDiffBkg->GetPix(x, y) != C4M_MaxTexIndex)
-			if (p->Surface8Bkg->_GetPix(x, y) != (byPix = pDiffBkg->_GetPix(x, y)))
-				p->Surface8Bkg->_SetPix(x, y, byPix);
-	}
-
-	// done
-	return true;
+	bool fApplied = ApplyLandscapeDiff(*p->Surface8, hGroup, C4CFN_DiffLandscape);
+	if (ApplyLandscapeDiff(*p->Surface8Bkg, hGroup, C4CFN_DiffLandscapeBkg)) fApplied = true;
+	return fApplied;
 }
 
 void C4Landscape::Default()
@@ -3929,9 +3923,8 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox, const bool
 	// Intersect bounding box with landscape
 	BoundingBox.Intersect(C4Rect(0, 0, Width, Height));
 	if (!BoundingBox.Wdt || !BoundingBox.Hgt) return;
-	// update render
-	if (pLandscapeRender)
-		pLandscapeRender->Update(BoundingBox, d);
+	// update render and FoW with the next DoRelights
+	AddRelight(BoundingBox);
 	if (updateMatAndPixCnt) UpdateMatCnt(d, BoundingBox, true);
 	// Restore Solidmasks
 	C4Rect SolidMaskRect = BoundingBox;
@@ -3943,12 +3936,6 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox, const bool
 	}
 	C4SolidMask::CheckConsistency();
 	if (updateMatAndPixCnt) UpdatePixCnt(d, BoundingBox);
-	// update FoW
-	if (pFoW)
-	{
-		pFoW->Invalidate(BoundingBox);
-		pFoW->Ambient.UpdateFromLandscape(*d, BoundingBox);
-	}
 }
 
 
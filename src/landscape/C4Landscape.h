@@ -24,7 +24,7 @@
 
 const int32_t C4MaxMaterial = 125;
 
-const int32_t C4LS_MaxRelights = 50;
+const int32_t C4LS_RelightTileSize = 64; // edge length of the tiles in which landscape changes are tracked for relighting
 
 enum class LandscapeMode
 {
@@ -64,7 +64,7 @@ public:
 	BYTE GetBackMapIndex(int32_t iX, int32_t iY) const;
 	bool Load(C4Group &hGroup, bool fLoadSky, bool fSavegame);
 	bool Save(C4Group &hGroup) const;
-	bool SaveDiff(C4Group &hGroup, bool fSyncSave) const;
+	bool SaveDiff(C4Group &hGroup, bool fSyncSave, bool fSaveUnchanged = false) const;
 	bool SaveMap(C4Group &hGroup) const;
 	bool SaveInitial();
 	bool SaveTextures(C4Group &hGroup) const;
@@ -0,0 +1,73 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2019, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Landscape changes against the initial landscape, as stored in savegames and network dynamics */
+
+#include "C4Include.h"
+#include "landscape/C4LandscapeDiff.h"
+
+#include "c4group/C4Group.h"
+#include "graphics/CSurface8.h"
+
+bool SaveLandscapeDiff(CSurface8 &sfcLandscape, const uint8_t *pInitial, C4Group &hGroup, const char *szEntryName, const char *szTempFilename, bool fSyncSave, bool fSaveUnchanged)
+{
+	const int32_t iWdt = sfcLandscape.Wdt, iHgt = sfcLandscape.Hgt;
+	// If it shouldn't be sync-save: Clear all bytes that have not changed, i.e.
+	// set them to C4M_MaxTexIndex
+	bool fChanged = false;
+	if (!fSyncSave)
+		for (int32_t y = 0; y < iHgt; y++)
+			for (int32_t x = 0; x < iWdt; x++)
+			{
+				if (pInitial[y * iWdt + x] == sfcLandscape._GetPix(x, y))
+					sfcLandscape.SetPix(x, y, C4M_MaxTexIndex);
+				else
+					fChanged = true;
+			}
+
+	bool fSuccess = true;
+	if (fSyncSave || fChanged || fSaveUnchanged)
+	{
+		// Save landscape surface and move temp file to group
+		fSuccess = sfcLandscape.Save(szTempFilename) && hGroup.Move(szTempFilename, szEntryName);
+	}
+
+	// Restore landscape pixels
+	if (!fSyncSave)
+		for (int32_t y = 0; y < iHgt; y++)
+			for (int32_t x = 0; x < iWdt; x++)
+				if (sfcLandscape._GetPix(x, y) == C4M_MaxTexIndex)
+					sfcLandscape.SetPix(x, y, pInitial[y * iWdt + x]);
+
+	return fSuccess;
+}
+
+bool ApplyLandscapeDiff(CSurface8 &sfcLandscape, C4Group &hGroup, const char *szEntryName)
+{
+	// Load diff landscape from group
+	if (!hGroup.AccessEntry(szEntryName)) return false;
+	CSurface8 sfcDiff;
+	if (!sfcDiff.Read(hGroup)) return false;
+
+	// convert all pixels: keep if same material; re-set if different material
+	BYTE byPix;
+	for (int32_t y = 0; y < sfcLandscape.Hgt; ++y)
+		for (int32_t x = 0; x < sfcLandscape.Wdt; ++x)
+			if ((byPix = sfcDiff.GetPix(x, y)) != C4M_MaxTexIndex)
+				if (sfcLandscape._GetPix(x, y) != byPix)
+					// material has changed here: readjust with new texture
+					sfcLandscape._SetPix(x, y, byPix);
+	return true;
+}
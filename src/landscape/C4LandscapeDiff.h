@@ -0,0 +1,32 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2019, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Landscape changes against the initial landscape, as stored in savegames and network dynamics */
+
+#ifndef INC_C4LandscapeDiff
+#define INC_C4LandscapeDiff
+
+class C4Group;
+class CSurface8;
+
+// Saves sfcLandscape into the entry szEntryName of hGroup, through the file szTempFilename.
+// Unless fSyncSave is set, pixels that equal pInitial are saved as C4M_MaxTexIndex, and nothing
+// is saved if no pixel changed, except with fSaveUnchanged. sfcLandscape is left as it was.
+bool SaveLandscapeDiff(CSurface8 &sfcLandscape, const uint8_t *pInitial, C4Group &hGroup, const char *szEntryName, const char *szTempFilename, bool fSyncSave, bool fSaveUnchanged);
+// Sets all pixels of sfcLandscape that are not C4M_MaxTexIndex in the entry szEntryName of hGroup.
+// Returns false if there is no such entry.
+bool ApplyLandscapeDiff(CSurface8 &sfcLandscape, C4Group &hGroup, const char *szEntryName);
+
+#endif
@@ -30,36 +30,36 @@
 
 static const C4Real WindDrift_Factor = itofix(1, 800);
 
-bool C4PXS::Execute()
+bool C4PXSSystem::ExecutePXS(int32_t &mat, C4Real &x, C4Real &y, C4Real &xdir, C4Real &ydir)
 {
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=x; rc.y=y; rc.iMat=mat;
 		rc.pos = 0;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
 	int32_t inmat;
 
 	// Safety
-	if (!MatValid(Mat))
-		{ Deactivate(); return false; }
+	if (!MatValid(mat))
+		{ Deactivate(mat, x, y); return false; }
 
 	// Out of bounds
 	if ((x<0) || (x>=::Landscape.GetWidth()) || (y<-10) || (y>=::Landscape.GetHeight()))
-		{ Deactivate(); return false; }
+		{ Deactivate(mat, x, y); return false; }
 
 	// Material conversion
 	int32_t iX = fixtoi(x), iY = fixtoi(y);
 	inmat=GBackMat(iX,iY);
-	C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Mat, inmat);
-	if (pReact && (*pReact->pFunc)(pReact, iX,iY, iX,iY, xdir,ydir, Mat,inmat, meePXSPos, nullptr))
-		{ Deactivate(); return false; }
+	C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(mat, inmat);
+	if (pReact && (*pReact->pFunc)(pReact, iX,iY, iX,iY, xdir,ydir, mat,inmat, meePXSPos, nullptr))
+		{ Deactivate(mat, x, y); return false; }
 
 	// Gravity
 	ydir+=GravAccel;
 
-	if (GBackDensity(iX, iY + 1) < ::MaterialMap.Map[Mat].Density)
+	if (GBackDensity(iX, iY + 1) < ::MaterialMap.Map[mat].Density)
 	{
 		// Air speed: Wind plus some random
 		int32_t iWind = Weather.GetWind(iX, iY);
@@ -67,7 +67,7 @@ bool C4PXS::Execute()
 		C4Real tydir = C4REAL256(Random(1200) - 600);
 
 		// Air friction, based on WindDrift. MaxSpeed is ignored.
-		int32_t iWindDrift = std::max(::MaterialMap.Map[Mat].WindDrift - 20, 0);
+		int32_t iWindDrift = std::max(::MaterialMap.Map[mat].WindDrift - 20, 0);
 		xdir += ((txdir - xdir) * iWindDrift) * WindDrift_Factor;
 		ydir += ((tydir - ydir) * iWindDrift) * WindDrift_Factor;
 	}
@@ -95,13 +95,13 @@ bool C4PXS::Execute()
 		int32_t inX = iX + Sign(iToX - iX), inY = iY + Sign(iToY - iY);
 		// Contact?
 		inmat = GBackMat(inX, inY);
-		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Mat, inmat);
+		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(mat, inmat);
 		if (pReact)
 		{
-			if ((*pReact->pFunc)(pReact, iX,iY, inX,inY, xdir,ydir, Mat,inmat, meePXSMove, &fStopMovement))
+			if ((*pReact->pFunc)(pReact, iX,iY, inX,inY, xdir,ydir, mat,inmat, meePXSMove, &fStopMovement))
 			{
 				// destructive contact
-				Deactivate();
+				Deactivate(mat, x, y);
 				return false;
 			}
 			else
@@ -126,23 +126,23 @@ bool C4PXS::Execute()
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=x; rc.y=y; rc.iMat=mat;
 		rc.pos = 1;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
 	return true;
 }
 
-void C4PXS::Deactivate()
+void C4PXSSystem::Deactivate(int32_t &mat, C4Real x, C4Real y)
 {
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=x; rc.y=y; rc.iMat=mat;
 		rc.pos = 2;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
-	Mat=MNone;
+	mat=MNone;
 }
 
 C4PXSSystem::C4PXSSystem()
@@ -157,41 +157,69 @@ C4PXSSystem::~C4PXSSystem()
 
 void C4PXSSystem::Default()
 {
-	Count=0;
+	Clear();
 }
 
 void C4PXSSystem::Clear()
 {
-	Count=0;
+	// Keep the allocated capacity: the system is refilled quickly in most rounds
+	Mat.clear();
+	X.clear(); Y.clear();
+	XDir.clear(); YDir.clear();
+}
+
+void C4PXSSystem::Reserve(size_t size)
+{
+	Mat.reserve(size);
+	X.reserve(size); Y.reserve(size);
+	XDir.reserve(size); YDir.reserve(size);
 }
 
-C4PXS* C4PXSSystem::New()
+void C4PXSSystem::Remove(size_t i)
 {
-	if (Count < PXSMax)
-		return &PXS[Count++];
-	return nullptr;
+	// Move the last PXS into the gap to keep the live range compact
+	size_t last = Mat.size() - 1;
+	if (i != last)
+	{
+		Mat[i] = Mat[last];
+		X[i] = X[last]; Y[i] = Y[last];
+		XDir[i] = XDir[last]; YDir[i] = YDir[last];
+	}
+	Mat.pop_back();
+	X.pop_back(); Y.pop_back();
+	XDir.pop_back(); YDir.pop_back();
 }
 
 bool C4PXSSystem::Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir, C4Real iydir)
 {
-	C4PXS *pxp;
 	if (!MatValid(mat)) return false;
-	if (!(pxp=New())) return false;
-	pxp->Mat=mat;
-	pxp->x=ix; pxp->y=iy;
-	pxp->xdir=ixdir; pxp->ydir=iydir;
+	Mat.push_back(mat);
+	X.push_back(ix); Y.push_back(iy);
+	XDir.push_back(ixdir); YDir.push_back(iydir);
 	return true;
 }
 
 void C4PXSSystem::Execute()
 {
-	for (size_t i = 0; i < Count; i++)
+	// Material reactions may create new PXS while a PXS is executed, which
+	// can reallocate the columns. So each PXS is executed on a local copy
+	// that is written back afterwards. New PXS are appended at the end and
+	// executed in the same frame, just like removed PXS are replaced by the
+	// last one, which is then executed in place.
+	for (size_t i = 0; i < Mat.size(); )
 	{
-		if (!PXS[i].Execute())
+		int32_t mat = Mat[i];
+		C4Real x = X[i], y = Y[i], xdir = XDir[i], ydir = YDir[i];
+		if (!ExecutePXS(mat, x, y, xdir, ydir))
 		{
-			assert(PXS[i].Mat == MNone);
-			PXS[i--] = PXS[--Count];
+			assert(mat == MNone);
+			Remove(i);
+			continue;
 		}
+		Mat[i] = mat;
+		X[i] = x; Y[i] = y;
+		XDir[i] = xdir; YDir[i] = ydir;
+		++i;
 	}
 }
 
@@ -211,13 +239,14 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 
 	float cgox = cgo.X - cgo.TargetX, cgoy = cgo.Y - cgo.TargetY;
 	// First pass: draw simple PXS (lines/pixels)
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		C4PXS *pxp = &PXS[i];
-		if (pxp->Mat != MNone && VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y)))
+		const int32_t mat = Mat[i];
+		const C4Real &x = X[i], &y = Y[i], &xdir = XDir[i], &ydir = YDir[i];
+		if (mat != MNone && VisibleRect.Contains(fixtoi(x), fixtoi(y)))
 		{
-			C4Material *pMat = &::MaterialMap.Map[pxp->Mat];
-			const DWORD dwMatClr = ::Landscape.GetPal()->GetClr((BYTE) (Mat2PixColDefault(pxp->Mat)));
+			C4Material *pMat = &::MaterialMap.Map[mat];
+			const DWORD dwMatClr = ::Landscape.GetPal()->GetClr((BYTE) (Mat2PixColDefault(mat)));
 			if(pMat->PXSFace.Surface)
 			{
 				int32_t pnx, pny;
@@ -231,8 +260,8 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 
 				const float w = z;
 				const float h = z * fcHgt / fcWdt;
-				const float x1 = fixtof(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt;
-				const float y1 = fixtof(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcHgt;
+				const float x1 = fixtof(x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt;
+				const float y1 = fixtof(y) + cgoy + z * pMat->PXSGfxRt.ty / fcHgt;
 				const float x2 = x1 + w;
 				const float y2 = y1 + h;
 
@@ -255,7 +284,7 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 				vtx[4] = vtx[2];
 				vtx[5] = vtx[0];
 
-				std::vector<C4BltVertex>& vec = bltVtx[pxp->Mat];
+				std::vector<C4BltVertex>& vec = bltVtx[mat];
 				vec.push_back(vtx[0]);
 				vec.push_back(vtx[1]);
 				vec.push_back(vtx[2]);
@@ -266,14 +295,14 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 			else
 			{
 				// old-style: unicolored pixels or lines
-				if (fixtoi(pxp->xdir) || fixtoi(pxp->ydir))
+				if (fixtoi(xdir) || fixtoi(ydir))
 				{
 					// lines for stuff that goes whooosh!
-					int len = fixtoi(Abs(pxp->xdir) + Abs(pxp->ydir));
+					int len = fixtoi(Abs(xdir) + Abs(ydir));
 					const DWORD dwMatClrLen = uint32_t(std::max<int>(dwMatClr >> 24, 195 - (195 - (dwMatClr >> 24)) / len)) << 24 | (dwMatClr & 0xffffff);
 					C4BltVertex begin, end;
-					begin.ftx = fixtof(pxp->x - pxp->xdir) + cgox; begin.fty = fixtof(pxp->y - pxp->ydir) + cgoy;
-					end.ftx = fixtof(pxp->x) + cgox; end.fty = fixtof(pxp->y) + cgoy;
+					begin.ftx = fixtof(x - xdir) + cgox; begin.fty = fixtof(y - ydir) + cgoy;
+					end.ftx = fixtof(x) + cgox; end.fty = fixtof(y) + cgoy;
 					DwTo4UB(dwMatClrLen, begin.color);
 					DwTo4UB(dwMatClrLen, end.color);
 					lineVtx.push_back(begin);
@@ -283,8 +312,8 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 				{
 					// single pixels for slow stuff
 					C4BltVertex vtx;
-					vtx.ftx = fixtof(pxp->x) + cgox;
-					vtx.fty = fixtof(pxp->y) + cgoy;
+					vtx.ftx = fixtof(x) + cgox;
+					vtx.fty = fixtof(y) + cgoy;
 					DwTo4UB(dwMatClr, vtx.color);
 					pixVtx.push_back(vtx);
 				}
@@ -324,7 +353,7 @@ void C4PXSSystem::Cast(int32_t mat, int32_t num, int32_t tx, int32_t ty, int32_t
 
 bool C4PXSSystem::Save(C4Group &hGroup)
 {
-	if (Count == 0)
+	if (Mat.empty())
 	{
 		hGroup.Delete(C4CFN_PXS);
 		return true;
@@ -341,7 +370,16 @@ bool C4PXSSystem::Save(C4Group &hGroup)
 #endif
 	if (!hTempFile.Write(&iNumFormat, sizeof (iNumFormat)))
 		return false;
-	if (!hTempFile.Write(PXS, Count * sizeof(C4PXS)))
+	// Write the columns as interleaved records to keep the format unchanged
+	std::vector<C4PXS> records(Mat.size());
+	for (size_t i = 0; i < Mat.size(); i++)
+	{
+		C4PXS &rec = records[i];
+		rec.Mat = Mat[i];
+		rec.x = X[i]; rec.y = Y[i];
+		rec.xdir = XDir[i]; rec.ydir = YDir[i];
+	}
+	if (!hTempFile.Write(records.data(), records.size() * sizeof(C4PXS)))
 		return false;
 
 	if (!hTempFile.Close())
@@ -374,14 +412,13 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 	else if (iBinSize % sizeof(C4PXS) != 0) return false;
 	// calc chunk count
 	PXSNum = iBinSize / sizeof(C4PXS);
-	if (PXSNum > PXSMax) return false;
-	if (!hGroup.Read(PXS, iBinSize)) return false;
-	// count the PXS, Peter!
-	Count = PXSNum;
-	// convert num format, if neccessary
-	for (size_t i = 0; i < Count; i++)
+	std::vector<C4PXS> records(PXSNum);
+	if (!hGroup.Read(records.data(), iBinSize)) return false;
+	// convert num format, if neccessary, and split into columns
+	Reserve(PXSNum);
+	for (size_t i = 0; i < PXSNum; i++)
 	{
-		C4PXS *pxp = &PXS[i];
+		C4PXS *pxp = &records[i];
 		if (pxp->Mat != MNone)
 		{
 			// convert number format
@@ -391,6 +428,10 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 			if (iNumForm == 1) { FIXED_TO_FLOAT(&pxp->x); FIXED_TO_FLOAT(&pxp->y); FIXED_TO_FLOAT(&pxp->xdir); FIXED_TO_FLOAT(&pxp->ydir); }
 #endif
 		}
+		// Inactive records are kept so they get removed in Execute as before
+		Mat.push_back(pxp->Mat);
+		X.push_back(pxp->x); Y.push_back(pxp->y);
+		XDir.push_back(pxp->xdir); YDir.push_back(pxp->ydir);
 	}
 	return true;
 }
@@ -399,9 +440,9 @@ int32_t C4PXSSystem::GetCount(int32_t mat) const
 {
 	// count PXS of given material
 	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
+	for (int32_t pxs_mat : Mat)
 	{
-		if (PXS[i].Mat == mat) ++result;
+		if (pxs_mat == mat) ++result;
 	}
 	return result;
 }
@@ -410,11 +451,10 @@ int32_t C4PXSSystem::GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, in
 {
 	// count PXS of given material in given area
 	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		const C4PXS *pxp = &PXS[i];
-		if (pxp->Mat == mat || mat == MNone)
-			if (Inside(pxp->x, x, x + wdt - 1) && Inside(pxp->y, y, y + hgt - 1))
+		if (Mat[i] == mat || mat == MNone)
+			if (Inside(X[i], x, x + wdt - 1) && Inside(Y[i], y, y + hgt - 1))
 				++result;
 	}
 	return result;
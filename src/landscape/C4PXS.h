@@ -22,28 +22,23 @@
 
 #include "landscape/C4Material.h"
 
-class C4PXS
+// On-disk record of a single PXS. The system itself keeps its particles in
+// separate columns; this layout is only used to keep the savegame format.
+struct C4PXS
 {
-	friend class C4PXSSystem;
-protected:
 	int32_t Mat{MNone};
 	C4Real x{Fix0}, y{Fix0}, xdir{Fix0}, ydir{Fix0};
-protected:
-	bool Execute();
-	void Deactivate();
 };
 
-const size_t PXSMax = 10000;
-
 class C4PXSSystem
 {
 public:
 	C4PXSSystem();
 	~C4PXSSystem();
-public:
-	size_t Count;
 protected:
-	C4PXS PXS[PXSMax];
+	// Structure of arrays. All live PXS are kept compacted in [0, GetCount()).
+	std::vector<int32_t> Mat;
+	std::vector<C4Real> X, Y, XDir, YDir;
 public:
 	void Default();
 	void Clear();
@@ -53,11 +48,14 @@ public:
 	bool Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir=Fix0, C4Real iydir=Fix0);
 	bool Load(C4Group &hGroup);
 	bool Save(C4Group &hGroup);
-	int32_t GetCount() const { return Count; } // count all PXS
+	int32_t GetCount() const { return Mat.size(); } // count all PXS
 	int32_t GetCount(int32_t mat) const; // count PXS of given material
 	int32_t GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, int32_t hgt) const; // count PXS of given material in given area. mat==-1 for all materials.
 protected:
-	C4PXS *New();
+	bool ExecutePXS(int32_t &mat, C4Real &x, C4Real &y, C4Real &xdir, C4Real &ydir); // returns false if the PXS got removed
+	void Deactivate(int32_t &mat, C4Real x, C4Real y);
+	void Remove(size_t i);
+	void Reserve(size_t size);
 };
 
 extern C4PXSSystem PXS;
@@ -27,6 +27,7 @@
 #include "landscape/C4Material.h"
 #include "landscape/C4Landscape.h"
 #include "landscape/C4Weather.h"
+#include "lib/C4Stat.h"
 #include "object/C4MeshAnimation.h"	
 #include "object/C4Object.h"
 #include "script/C4Aul.h"
@@ -1253,6 +1254,7 @@ C4ParticleChunk *C4ParticleList::GetFittingParticleChunk(C4ParticleDef *def, uin
 
 void C4ParticleSystem::CalculationThread::Execute()
 {
+	C4Stat::getMainStat()->SetThreadName("Particles");
 	Particles.ExecuteCalculation();
 }
 
@@ -1285,6 +1287,7 @@ void C4ParticleSystem::ExecuteCalculation()
 			timeDelta = (float)(gameTime - currentSimulationTime);
 		currentSimulationTime = gameTime;
 
+		C4ST_STARTNEW(CalcStat, "C4ParticleSystem::ExecuteCalculation")
 		particleListAccessMutex.Enter();
 
 		for (std::list<C4ParticleList>::iterator iter = particleLists.begin(); iter != particleLists.end(); ++iter)
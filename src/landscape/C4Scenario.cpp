@@ -25,6 +25,7 @@
 #include "lib/C4InputValidation.h"
 #include "lib/C4Random.h"
 #include "lib/StdColors.h"
+#include "object/C4Sector.h"
 
 //==================================== C4SVal ==============================================
 
@@ -314,6 +315,7 @@ void C4SLandscape::Default()
 	MaterialZoom=4;
 	FlatChunkShapes=false;
 	Secret=false;
+	ObjectSectorSize=C4LSectorDefaultSize;
 }
 
 void C4SLandscape::GetMapSize(int32_t &rWdt, int32_t &rHgt, int32_t iPlayerNum)
@@ -358,6 +360,7 @@ void C4SLandscape::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(MaterialZoom,            "MaterialZoom",          4));
 	pComp->Value(mkNamingAdapt(FlatChunkShapes,         "FlatChunkShapes",       false));
 	pComp->Value(mkNamingAdapt(Secret,                  "Secret",                false));
+	pComp->Value(mkNamingAdapt(ObjectSectorSize,        "ObjectSectorSize",      C4LSectorDefaultSize));
 }
 
 void C4SWeather::Default()
@@ -187,6 +187,7 @@ public:
 	int32_t MaterialZoom;
 	bool FlatChunkShapes; // if true, all material chunks are drawn flat
 	bool Secret; // hide map from observers (except in dev mode and the like)
+	int32_t ObjectSectorSize; // edge length of the object sectors used for area searches
 public:
 	void Default();
 	void GetMapSize(int32_t &rWdt, int32_t &rHgt, int32_t iPlayerNum);
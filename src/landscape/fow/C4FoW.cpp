@@ -17,6 +17,7 @@
 #include "C4ForbidLibraryCompilation.h"
 #include "landscape/fow/C4FoW.h"
 #include "graphics/C4Draw.h"
+#include "lib/C4Stat.h"
 
 #include <cfloat>
 
@@ -229,6 +230,7 @@ void C4FoW::Invalidate(C4Rect r)
 void C4FoW::Update(C4Rect r, C4Player *pPlr)
 {
 #ifndef USE_CONSOLE
+	C4ST_STARTNEW(UpdateStat, "C4FoW::Update")
 	for (C4FoWLight *pLight = pLights; pLight; pLight = pLight->getNext())
 		if (pLight->IsVisibleForPlayer(pPlr))
 			pLight->Update(r);
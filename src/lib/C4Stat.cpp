@@ -13,19 +13,27 @@
  * To redistribute this file separately, substitute the full license texts
  * for the above references.
  */
-// statistics
+// statistics and tracing
 
 #include "C4Include.h"
 #include "lib/C4Stat.h"
 
+#include "c4group/CStdFile.h"
+
 // ** implemetation of C4MainStat
 
-C4MainStat::C4MainStat() = default;
+thread_local C4MainStat::TraceBuffer *C4MainStat::pThreadBuffer = nullptr;
+
+C4MainStat::C4MainStat()
+{
+	Reset();
+}
 
 C4MainStat::~C4MainStat() = default;
 
 void C4MainStat::RegisterStat(C4Stat* pStat)
 {
+	CStdLock StatsLock(&StatsCSec);
 	// add to list
 	if (!pFirst)
 	{
@@ -44,10 +52,12 @@ void C4MainStat::RegisterStat(C4Stat* pStat)
 
 void C4MainStat::UnRegStat(C4Stat* pStat)
 {
+	CStdLock StatsLock(&StatsCSec);
 	// first item?
 	if (!pStat->pPrev)
 	{
 		pFirst = pStat->pNext;
+		if (pFirst) pFirst->pPrev = nullptr;
 		pStat->pNext = nullptr;
 	}
 	// last item?
@@ -67,102 +77,201 @@ void C4MainStat::UnRegStat(C4Stat* pStat)
 
 void C4MainStat::Reset()
 {
+	CStdLock StatsLock(&StatsCSec);
 	for (C4Stat* pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
 		pAkt->Reset();
+	for (auto &pBuffer : TraceBuffers)
+	{
+		CStdLock BufferLock(&pBuffer->CSec);
+		pBuffer->iNext = 0;
+		pBuffer->fWrapped = false;
+	}
+	std::fill_n(FrameHistogram, FrameHistogramSize, 0);
+	tFrameMax = 0;
+	ResetPart();
 }
 
 void C4MainStat::ResetPart()
 {
+	CStdLock StatsLock(&StatsCSec);
 	for (C4Stat* pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
 		pAkt->ResetPart();
+	std::fill_n(FrameHistogramPart, FrameHistogramSize, 0);
+	tFrameMaxPart = 0;
 }
 
+void C4MainStat::Start()
+{
+	fRecording = false;
+	Reset();
+	SetThreadName("Main");
+	tRecordStart = Now();
+	fRecording = true;
+}
 
-void C4MainStat::Show()
+void C4MainStat::Stop(const char *szTraceFilename)
+{
+	if (!IsRecording()) return;
+	fRecording = false;
+	Show();
+	if (szTraceFilename && *szTraceFilename)
+	{
+		if (SaveTrace(szTraceFilename))
+			LogF("Saved trace to %s", szTraceFilename);
+		else
+			LogF("Error writing trace file %s", szTraceFilename);
+	}
+}
+
+void C4MainStat::AddFrame(uint64_t tDuration)
 {
+	// find bucket: up to 0.5ms, 1ms, 2ms, ...
+	int iBucket = 0;
+	for (uint64_t tLimit = 500000; iBucket < FrameHistogramSize - 1 && tDuration >= tLimit; tLimit *= 2)
+		++iBucket;
+	++FrameHistogram[iBucket];
+	++FrameHistogramPart[iBucket];
+	tFrameMax = std::max(tFrameMax, tDuration);
+	tFrameMaxPart = std::max(tFrameMaxPart, tDuration);
+}
 
-	// count stats
-	unsigned int iCnt = 0;
-	C4Stat* pAkt;
-	for (pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
-		iCnt++;
+C4MainStat::TraceBuffer *C4MainStat::GetThreadBuffer()
+{
+	if (pThreadBuffer) return pThreadBuffer;
+	CStdLock StatsLock(&StatsCSec);
+	TraceBuffers.push_back(std::make_unique<TraceBuffer>());
+	TraceBuffer *pBuffer = TraceBuffers.back().get();
+	pBuffer->iThread = TraceBuffers.size();
+	pBuffer->Name.Format("Thread %d", (int) pBuffer->iThread);
+	pBuffer->Events.resize(TraceBufferSize);
+	pThreadBuffer = pBuffer;
+	return pBuffer;
+}
 
-	// create array
-	auto** StatArray = new C4Stat*[iCnt];
-	auto* bHS = new bool[iCnt];
+void C4MainStat::SetThreadName(const char *szName)
+{
+	TraceBuffer *pBuffer = GetThreadBuffer();
+	CStdLock BufferLock(&pBuffer->CSec);
+	pBuffer->Name.Copy(szName);
+}
 
-	// sort it
-	unsigned int i,ii;
-	for (ii=0; ii<iCnt; ii++) bHS[ii] = false;
-	for (i=0; i<iCnt; i++)
+void C4MainStat::AddTraceEvent(const C4Stat *pStat, uint64_t tStart, uint64_t tDuration)
+{
+	TraceBuffer *pBuffer = GetThreadBuffer();
+	CStdLock BufferLock(&pBuffer->CSec);
+	pBuffer->Events[pBuffer->iNext] = { pStat, tStart, tDuration };
+	if (++pBuffer->iNext == TraceBufferSize)
 	{
-		C4Stat* pBestStat = nullptr;
-		unsigned int iBestNr = ~0;
+		pBuffer->iNext = 0;
+		pBuffer->fWrapped = true;
+	}
+}
 
-		for (ii=0, pAkt = pFirst; ii<iCnt; ii++, pAkt = pAkt->pNext)
-			if (!bHS[ii])
+bool C4MainStat::SaveTrace(const char *szFilename)
+{
+	// trace event format, which is also read by Perfetto; timestamps are in microseconds
+	CStdFile File;
+	if (!File.Create(szFilename)) return false;
+	std::string Buf = "{\"traceEvents\":[\n";
+	bool fFirst = true;
+	CStdLock StatsLock(&StatsCSec);
+	for (auto &pBuffer : TraceBuffers)
+	{
+		CStdLock BufferLock(&pBuffer->CSec);
+		Buf += FormatString(R"(%s{"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":"%s"}})",
+		                    fFirst ? "" : ",\n", (int) pBuffer->iThread, pBuffer->Name.getData()).getData();
+		fFirst = false;
+		// oldest runs first
+		size_t iCount = pBuffer->fWrapped ? TraceBufferSize : pBuffer->iNext;
+		size_t iFirst = pBuffer->fWrapped ? pBuffer->iNext : 0;
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			const TraceEvent &e = pBuffer->Events[(iFirst + i) % TraceBufferSize];
+			if (e.tStart < tRecordStart) continue;
+			Buf += FormatString(R"(,
+{"name":"%s","cat":"engine","ph":"X","ts":%.3f,"dur":%.3f,"pid":1,"tid":%d})",
+			                    e.pStat->strName, (e.tStart - tRecordStart) / 1e3, e.tDuration / 1e3, (int) pBuffer->iThread).getData();
+			if (Buf.size() > 65536)
 			{
-				if (iBestNr == ~0u)
-				{
-					iBestNr = ii;
-					pBestStat = pAkt;
-				}
-				else if (stricmp(pBestStat->strName, pAkt->strName) > 0)
-				{
-					iBestNr = ii;
-					pBestStat = pAkt;
-				}
+				if (!File.Write(Buf.c_str(), Buf.size())) return false;
+				Buf.clear();
 			}
-
-		if (iBestNr == (unsigned int) -1)
-			break;
-		bHS[iBestNr] = true;
-
-		StatArray[i] = pBestStat;
+		}
 	}
+	Buf += "\n]}\n";
+	if (!File.Write(Buf.c_str(), Buf.size())) return false;
+	return File.Close();
+}
 
-	delete [] bHS;
+void C4MainStat::Show()
+{
+	// sort by name
+	std::vector<C4Stat *> Stats;
+	CStdLock StatsLock(&StatsCSec);
+	for (C4Stat* pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
+		Stats.push_back(pAkt);
+	std::sort(Stats.begin(), Stats.end(), [](C4Stat *a, C4Stat *b) { return stricmp(a->strName, b->strName) < 0; });
 
-	LogSilent("** Stat");
+	Log("** Stat");
 
 	// output in order
-	for (i=0; i<iCnt; i++)
+	for (C4Stat *pAkt : Stats)
 	{
-		pAkt = StatArray[i];
-
 		// output it!
-		if (pAkt->iCount)
-			LogSilentF("%s: n = %u, t = %u, td = %.2f",
-			           pAkt->strName, pAkt->iCount, pAkt->tTimeSum,
-			           double(pAkt->tTimeSum) / pAkt->iCount * 1000);
+		uint32_t iCount = pAkt->iCount;
+		uint64_t tTimeSum = pAkt->tTimeSum;
+		if (iCount)
+			LogF("%s: n = %u, t = %.3fms, td = %.3fus",
+			     pAkt->strName, iCount, tTimeSum / 1e6, double(tTimeSum) / iCount / 1e3);
 	}
-
-	// delete...
-	delete[] StatArray;
+	StdStrBuf Histogram = GetFrameHistogram(FrameHistogram, tFrameMax);
+	if (Histogram.getLength()) Log(Histogram.getData());
 
 	// ok. job done
-	LogSilent("** Stat end");
+	Log("** Stat end");
 }
 
 void C4MainStat::ShowPart(int FrameCounter)
 {
-	C4Stat* pAkt;
+	if (!IsRecording()) return;
 
 	// insert tick nr
 	LogSilentF("** PartStat begin %d", FrameCounter);
 
 	// insert all stats
-	for (pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
-		LogSilentF("%s: n=%u, t=%u", pAkt->strName, pAkt->iCountPart, pAkt->tTimeSumPart);
+	CStdLock StatsLock(&StatsCSec);
+	for (C4Stat* pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
+		LogSilentF("%s: n=%u, t=%.3fms", pAkt->strName, (uint32_t) pAkt->iCountPart, pAkt->tTimeSumPart / 1e6);
+	StdStrBuf Histogram = GetFrameHistogram(FrameHistogramPart, tFrameMaxPart);
+	if (Histogram.getLength()) LogSilent(Histogram.getData());
 
 	// insert part stat end idtf
 	LogSilentF("** PartStat end\n");
 }
 
+StdStrBuf C4MainStat::GetFrameHistogram(const uint32_t *Histogram, uint64_t tMax)
+{
+	StdStrBuf Line;
+	uint32_t iFrames = 0;
+	for (int i = 0; i < FrameHistogramSize; ++i)
+		iFrames += Histogram[i];
+	if (!iFrames) return Line;
+	Line.Format("Frame times (n = %u, max = %.3fms):", iFrames, tMax / 1e6);
+	double dLimit = 0.5;
+	for (int i = 0; i < FrameHistogramSize; ++i, dLimit *= 2)
+	{
+		if (i < FrameHistogramSize - 1)
+			Line.AppendFormat(" <%gms: %u", dLimit, Histogram[i]);
+		else
+			Line.AppendFormat(" more: %u", Histogram[i]);
+	}
+	return Line;
+}
+
 // ** implemetation of C4Stat
 
-C4Stat::C4Stat(const char* strnName)
-		: strName(strnName)
+C4Stat::C4Stat(const char* strnName, bool fTrace)
+		: strName(strnName), fTrace(fTrace)
 {
 	Reset();
 	getMainStat()->RegisterStat(this);
@@ -175,8 +284,6 @@ C4Stat::~C4Stat()
 
 void C4Stat::Reset()
 {
-	iStartCalled = 0;
-
 	tTimeSum = 0;
 	iCount = 0;
 
@@ -13,30 +13,81 @@
  * To redistribute this file separately, substitute the full license texts
  * for the above references.
  */
-// statistics
+// statistics and tracing
 #ifndef INC_C4Stat
 #define INC_C4Stat
 
+#include "platform/StdSync.h"
+
+#include <atomic>
+#include <chrono>
+
 class C4Stat;
 
 // *** main statistic class
 // should only been constructed once per application
+// While recording, the times of all checkpoints are summed up, and every thread keeps its
+// latest checkpoint runs in a ring buffer that can be saved in Chrome trace format.
 class C4MainStat
 {
 	friend class C4Stat;
 
 public:
+	static const size_t TraceBufferSize = 1 << 16; // runs kept per thread
+	static const int FrameHistogramSize = 10; // frames below 0.5ms, 1ms, 2ms, ... 128ms, and slower
+
 	C4MainStat();
 	~C4MainStat();
 
+	// monotonic time in nanoseconds
+	static uint64_t Now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+	bool IsRecording() const { return fRecording.load(std::memory_order_relaxed); }
+	void Start(); // reset all times and begin recording
+	void Stop(const char *szTraceFilename = nullptr); // show the results and save the trace if a file name is given
+
+	void AddFrame(uint64_t tDuration); // adds a game frame to the histogram
+	void SetThreadName(const char *szName); // name of the calling thread in the trace
+
 	void Show();
 	void ShowPart(int FrameCounter);
 
 	void Reset();
 	void ResetPart();
 
+	bool SaveTrace(const char *szFilename);
+
 protected:
 	C4Stat* pFirst{nullptr};
+	CStdCSec StatsCSec; // guards the list of stats and trace buffers
+
+	std::atomic<bool> fRecording{false};
+	uint64_t tRecordStart{0};
+
+	// one thread's latest runs
+	struct TraceEvent
+	{
+		const C4Stat *pStat;
+		uint64_t tStart, tDuration;
+	};
+	struct TraceBuffer
+	{
+		int32_t iThread;
+		StdCopyStrBuf Name;
+		CStdCSec CSec;
+		std::vector<TraceEvent> Events;
+		size_t iNext{0};
+		bool fWrapped{false};
+	};
+	std::vector<std::unique_ptr<TraceBuffer> > TraceBuffers;
+	static thread_local TraceBuffer *pThreadBuffer;
+	TraceBuffer *GetThreadBuffer();
+	void AddTraceEvent(const C4Stat *pStat, uint64_t tStart, uint64_t tDuration);
+
+	// frame times
+	uint32_t FrameHistogram[FrameHistogramSize], FrameHistogramPart[FrameHistogramSize];
+	uint64_t tFrameMax, tFrameMaxPart;
+	StdStrBuf GetFrameHistogram(const uint32_t *Histogram, uint64_t tMax);
 
 	void RegisterStat(C4Stat* pStat);
 	void UnRegStat(C4Stat* pStat);
@@ -45,35 +96,23 @@ protected:
 
 // *** one statistic.
 // Holds the data about one "checkpoint" in code
-// registers himself to C4MainStat when Start() is called the first time
+// registers himself to C4MainStat on construction
 class C4Stat
 {
 	friend class C4MainStat;
 
 public:
-	C4Stat(const char* strName);
+	C4Stat(const char* strName, bool fTrace = true);
 	~C4Stat();
 
-	inline void Start()
-	{
-		if (!iStartCalled)
-			tStartTime = C4TimeMilliseconds::Now();
-		iCount ++;
-		iCountPart ++;
-		iStartCalled ++;
-	}
-
-	inline void Stop()
+	// adds one run of the checkpoint; use C4StatScope instead
+	inline void Add(uint64_t tStart, uint64_t tDuration)
 	{
-		assert(iStartCalled);
-		iStartCalled --;
-		if (!iStartCalled && iCount >= 100)
-		{
-			uint32_t tTime = C4TimeMilliseconds::Now() - tStartTime;
-
-			tTimeSum += tTime;
-			tTimeSumPart += tTime;
-		}
+		tTimeSum.fetch_add(tDuration, std::memory_order_relaxed);
+		tTimeSumPart.fetch_add(tDuration, std::memory_order_relaxed);
+		iCount.fetch_add(1, std::memory_order_relaxed);
+		iCountPart.fetch_add(1, std::memory_order_relaxed);
+		if (fTrace) getMainStat()->AddTraceEvent(this, tStart, tDuration);
 	}
 
 	void Reset();
@@ -87,75 +126,66 @@ protected:
 	C4Stat* pNext;
 	C4Stat* pPrev;
 
-	C4TimeMilliseconds tStartTime;
-
-	// start-call depth
-	unsigned int iStartCalled;
-
-
-	// ** statistic data
+	// ** statistic data, in nanoseconds
 
 	// sum of times
-	uint32_t tTimeSum;
+	std::atomic<uint64_t> tTimeSum;
 
-	// number of starts called
-	unsigned int iCount;
+	// number of runs
+	std::atomic<uint32_t> iCount;
 
 	// ** statistic data (partial stat)
 
 	// sum of times
-	uint32_t tTimeSumPart;
+	std::atomic<uint64_t> tTimeSumPart;
 
-	// number of starts called
-	unsigned int iCountPart;
+	// number of runs
+	std::atomic<uint32_t> iCountPart;
 
 
 	// name of statistic
 	const char* strName;
 
-	// registred?
-	bool bRegistred;
+	// record runs in the trace? Off for checkpoints that run too often per frame.
+	bool fTrace;
+
+};
+
+// *** measures one run of a checkpoint until Stop() or the end of the block
+// Nothing is measured unless the main statistic is recording.
+class C4StatScope
+{
+	C4Stat *pStat;
+	uint64_t tStart;
+
+public:
+	C4StatScope(C4Stat &Stat)
+		: pStat(C4Stat::getMainStat()->IsRecording() ? &Stat : nullptr), tStart(pStat ? C4MainStat::Now() : 0) { }
+	~C4StatScope() { Stop(); }
 
+	// returns the measured time, or zero if not recording
+	uint64_t Stop()
+	{
+		if (!pStat) return 0;
+		uint64_t tDuration = C4MainStat::Now() - tStart;
+		pStat->Add(tStart, tDuration);
+		pStat = nullptr;
+		return tDuration;
+	}
 };
 
 // *** some directives
-#ifdef STAT
 
 // used to create and start a new C4Stat object
-#define C4ST_STARTNEW(StatName, strName) static C4Stat StatName(strName); StatName.Start();
+#define C4ST_STARTNEW(StatName, strName) static C4Stat StatName(strName); C4StatScope StatName##Scope(StatName);
 
 // used to create a new C4Stat object
 #define C4ST_NEW(StatName, strName) C4Stat StatName(strName);
 
-// used to start an existing C4Stat object
-#define C4ST_START(StatName) StatName.Start();
+// used to start an existing C4Stat object until C4ST_STOP or the end of the block
+#define C4ST_START(StatName) C4StatScope StatName##Scope(StatName);
 
 // used to stop an existing C4Stat object
-#define C4ST_STOP(StatName) StatName.Stop();
-
-// shows the statistic (to log)
-#define C4ST_SHOWSTAT C4Stat::getMainStat()->Show();
-
-// shows the statistic (to log)
-#define C4ST_SHOWPARTSTAT(FrameCounter) C4Stat::getMainStat()->ShowPart(FrameCounter);
-
-// resets the whole statistic
-#define C4ST_RESET C4Stat::getMainStat()->Reset();
-
-// resets the partial statistic
-#define C4ST_RESETPART C4Stat::getMainStat()->ResetPart();
-
-#else
-
-#define C4ST_STARTNEW(StatName, strName)
-#define C4ST_NEW(StatName, strName)
-#define C4ST_START(StatName)
-#define C4ST_STOP(StatName)
-#define C4ST_SHOWSTAT
-#define C4ST_SHOWPARTSTAT(FrameCounter)
-#define C4ST_RESET
-#define C4ST_RESETPART
-
-#endif
+#define C4ST_STOP(StatName) StatName##Scope.Stop();
 
 #endif // INC_C4Stat
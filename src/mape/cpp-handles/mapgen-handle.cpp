@@ -121,6 +121,7 @@ C4MapgenHandle* c4_mapgen_handle_new_script(const char* filename, const char* so
 		// scenario script is loaded, so simply load an empty script
 		// here:
 		::GameScript.LoadData("Script.c", "", nullptr);
+		ScriptEngine.PreparseScripts();
 
 		const char* parse_error = c4_log_handle_get_first_log_message();
 		if(parse_error)
@@ -232,6 +233,7 @@ C4MapgenHandle* c4_mapgen_handle_new(const char* filename, const char* source, c
 
 			c4_log_handle_clear();
 			GameScript.Load(File, basename, nullptr, nullptr);
+			ScriptEngine.PreparseScripts();
 			g_free(dirname);
 			g_free(basename);
 
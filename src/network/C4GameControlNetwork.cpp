@@ -29,7 +29,7 @@ C4GameControlNetwork::C4GameControlNetwork(C4GameControl *pnParent)
 		fActivated(false), iTargetTick(-1),
 		iControlPreSend(1), tWaitStart(C4TimeMilliseconds::PositiveInfinity), iAvgControlSendTime(0), iTargetFPS(38),
 		iControlSent(0), iControlReady(0),
-		pCtrlStack(nullptr),
+		pCtrlStack(nullptr), iKeepCtrlTick(-1),
 		tNextControlRequest(0),
 		pParent(pnParent)
 {
@@ -67,6 +67,7 @@ void C4GameControlNetwork::Clear() // by main thread
 	fEnabled = false; fRunning = false;
 	iAvgControlSendTime = 0;
 	ClearCtrl(); ClearClients();
+	iKeepCtrlTick = -1;
 	// clear sync control
 	SyncControl.Clear();
 	while (pSyncCtrlQueue)
@@ -728,8 +729,11 @@ void C4GameControlNetwork::CheckCompleteCtrl(bool fSetEvent) // by both
 			Application.NextTick();
 	}
 	// clear old ctrl
-	if (::Control.ControlTick >= C4ControlBacklog)
-		ClearCtrl(::Control.ControlTick - C4ControlBacklog);
+	int32_t iClearTick = ::Control.ControlTick - C4ControlBacklog;
+	int32_t iKeepTick = iKeepCtrlTick;
+	if (iKeepTick >= 0) iClearTick = std::min(iClearTick, iKeepTick);
+	if (iClearTick > 0)
+		ClearCtrl(iClearTick);
 	// target ctrl tick to reach?
 	if (iControlReady < iTargetTick &&
 	    (!fActivated || iControlSent > iControlReady) &&
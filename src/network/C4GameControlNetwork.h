@@ -75,6 +75,7 @@ protected:
 	// control list
 	C4GameControlPacket *pCtrlStack;
 	CStdCSec CtrlCSec;
+	std::atomic<int32_t> iKeepCtrlTick; // kept for clients joining from a runtime join dynamic
 
 	// list of clients (activated only!)
 	C4GameControlClient *pClients;
@@ -100,6 +101,8 @@ public:
 	void setControlPreSend(int32_t iToVal) { iControlPreSend = std::min(iToVal, C4MaxPreSend); }
 	int32_t getAvgControlSendTime() const { return iAvgControlSendTime; }
 	void setTargetFPS(int32_t iToVal) { iTargetFPS = iToVal; }
+	int32_t getKeepCtrlTick() const { return iKeepCtrlTick; }
+	void setKeepCtrlTick(int32_t iToVal) { iKeepCtrlTick = iToVal; } // control from this tick on isn't cleared (-1 for none)
 
 	// main thread communication
 	bool Init(int32_t iClientID, bool fHost, int32_t iStartTick, bool fActivated, C4Network2 *pNetwork); // by main thread
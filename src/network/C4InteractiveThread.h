@@ -99,6 +99,7 @@ public:
 	// process management
 	bool AddProc(StdSchedulerProc *pProc);
 	void RemoveProc(StdSchedulerProc *pProc);
+	void SetUseEpoll(bool fUse) { Scheduler.SetUseEpoll(fUse); }
 
 	// event queue
 	bool PushEvent(C4InteractiveEventType eEventType, void *pData = nullptr);
@@ -836,6 +836,7 @@ bool C4NetIOTCP::Init(uint16_t iPort)
 		SetError("could not create pipe", true);
 		return false;
 	}
+	fcntl(Pipe[0], F_SETFL, fcntl(Pipe[0], F_GETFL) | O_NONBLOCK);
 #endif
 
 	// create listen socket (if necessary)
@@ -845,6 +846,7 @@ bool C4NetIOTCP::Init(uint16_t iPort)
 
 	// ok
 	fInit = true;
+	Changed();
 	return true;
 }
 
@@ -962,12 +964,13 @@ bool C4NetIOTCP::Execute(int iMaxTime, pollfd *fds) // (mt-safe)
 		std::copy(fds, fds + fdvec.size(), fdvec.begin());
 	}
 
-	// flush pipe
+	// flush pipe (completely, the scheduler might only report new data)
 	assert(fdvec[0].fd == Pipe[0]);
 	if (fdvec[0].events & fdvec[0].revents)
 	{
-		char c;
-		if (::read(Pipe[0], &c, 1) == -1)
+		char c[64]; ssize_t iRead;
+		while ((iRead = ::read(Pipe[0], c, sizeof(c))) > 0) {}
+		if (iRead == -1 && errno != EAGAIN)
 			SetError("read failed");
 	}
 
@@ -989,14 +992,21 @@ bool C4NetIOTCP::Execute(int iMaxTime, pollfd *fds) // (mt-safe)
 
 		// a connection waiting for accept?
 		if (wsaEvents.lNetworkEvents & FD_ACCEPT)
+			if (!Accept())
+				return false;
+		// (note: what happens if there are more connections waiting?)
 #else
 		cur_fd = fdmap.find(lsock);
-		// a connection waiting for accept?
+		// connections waiting for accept?
 		if (cur_fd != fdmap.end() && (cur_fd->second->events & cur_fd->second->revents))
+			// accept all of them (the listen socket doesn't block)
+			for (;;)
+				if (!Accept())
+				{
+					if (HaveWouldBlockError()) { ResetSocketError(); break; }
+					return false;
+				}
 #endif
-			if (!Accept())
-				return false;
-		// (note: what happens if there are more connections waiting?)
 
 #ifdef STDSCHEDULER_USE_EVENTS
 		// closed?
@@ -1380,9 +1390,9 @@ void C4NetIOTCP::GetFDs(std::vector<struct pollfd> & fds)
 		pfd.fd = pWait->sock; pfd.events = POLLOUT;
 		fds.push_back(pfd);
 	}
-	// add sockets
+	// add sockets (closed ones might have been reused already)
 	for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
-		if (pPeer->GetSocket())
+		if (pPeer->Open())
 		{
 			// Wait for socket to become readable
 			pfd.fd = pPeer->GetSocket(); pfd.events = POLLIN;
@@ -1440,6 +1450,8 @@ C4NetIOTCP::Peer *C4NetIOTCP::Accept(SOCKET nsock, const addr_t &ConnectAddr) //
 		if ((nsock = ::accept(lsock, &addr, &iAddrSize)) == INVALID_SOCKET)
 #endif
 		{
+			// no more connections waiting?
+			if (HaveWouldBlockError()) return nullptr;
 			// set error
 			SetError("socket accept failed", true);
 			return nullptr;
@@ -1574,6 +1586,14 @@ bool C4NetIOTCP::Listen(uint16_t inListenPort)
 		closesocket(lsock); lsock = INVALID_SOCKET;
 		return false;
 	}
+#else
+	// disable blocking, so all waiting connections can be accepted at once
+	if (::fcntl(lsock, F_SETFL, fcntl(lsock, F_GETFL) | O_NONBLOCK) == SOCKET_ERROR)
+	{
+		SetError("could not disable blocking for listen socket", true);
+		closesocket(lsock); lsock = INVALID_SOCKET;
+		return false;
+	}
 #endif
 
 	// start listening
@@ -1792,6 +1812,8 @@ bool C4NetIOTCP::Peer::Send() // (mt-safe)
 #ifndef STDSCHEDULER_USE_EVENTS
 		// Unblock parent so the FD-list can be refreshed
 		pParent->UnBlock();
+		// ...and have the scheduler wait for the socket to become writable again
+		pParent->Changed();
 #endif
 	}
 	else
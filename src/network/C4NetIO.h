@@ -376,6 +376,7 @@ public:
 	HANDLE GetEvent() override;
 #else
 	void GetFDs(std::vector<struct pollfd> & FDs) override;
+	bool HasPersistentFDs() override { return true; }
 #endif
 
 	// statistics
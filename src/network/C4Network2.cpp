@@ -657,8 +657,17 @@ void C4Network2::Execute()
 
 	if (isHost())
 	{
+		// joining clients caught up? Then their control doesn't need to be kept anymore
+		if (!pDynamicPacker && pControl->getKeepCtrlTick() >= 0)
+		{
+			C4Network2Client *pClient = nullptr;
+			while ((pClient = Clients.GetNextClient(pClient)))
+				if (pClient->isChasing())
+					break;
+			if (!pClient) pControl->setKeepCtrlTick(-1);
+		}
 		// remove dynamic
-		if (!ResDynamic.isNull() && ::Control.ControlTick > iDynamicTick)
+		if (!ResDynamic.isNull() && ::Control.ControlTick > iDynamicTick && pControl->getKeepCtrlTick() != iDynamicTick)
 			RemoveDynamic();
 		// Set chase target
 		UpdateChaseTarget();
@@ -738,6 +747,8 @@ void C4Network2::Clear()
 	Clients.Clear();
 	// close net classes
 	NetIO.Clear();
+	// stop packing dynamic
+	if (pDynamicPacker) { delete pDynamicPacker; pDynamicPacker = nullptr; }
 	// clear resources
 	ResList.Clear();
 	// clear password
@@ -1062,23 +1073,52 @@ void C4Network2::InitPuncher()
 void C4Network2::OnGameSynchronized()
 {
 	// savegame needed?
-	if (fDynamicNeeded)
+	if (fDynamicNeeded && !pDynamicPacker)
 	{
 		// create dynamic
 		bool fSuccess = CreateDynamic(false);
-		// check for clients that still need join-data
-		C4Network2Client *pClient = nullptr;
-		while ((pClient = Clients.GetNextClient(pClient)))
-			if (!pClient->hasJoinData())
-			{
-				if (fSuccess)
-					// now we can provide join data: send it
-					SendJoinData(pClient);
-				else
-					// join data could not be created: emergency kick
-					Game.Clients.CtrlRemove(pClient->getClient(), LoadResStr("IDS_ERR_ERRORWHILECREATINGJOINDAT"));
-			}
+		// still being packed? (see OnDynamicPacked)
+		if (fSuccess && pDynamicPacker) return;
+		OnDynamicCreated(fSuccess);
+	}
+}
+
+void C4Network2::OnDynamicPacked()
+{
+	// might be outdated
+	if (!pDynamicPacker || !pDynamicPacker->isDone()) return;
+	C4Network2Res::Ref pRes = pDynamicPacker->getRes();
+	delete pDynamicPacker; pDynamicPacker = nullptr;
+	// add resource
+	if (pRes)
+	{
+		pRes->ChangeID(ResList.nextResID());
+		ResList.Add(pRes);
+		ResDynamic = pRes->getCore();
+		fDynamicNeeded = false;
+	}
+	else
+	{
+		Log(LoadResStr("IDS_NET_SAVE_ERR_ADDDYNDATARES"));
+		pControl->setKeepCtrlTick(-1);
 	}
+	OnDynamicCreated(!!pRes);
+}
+
+void C4Network2::OnDynamicCreated(bool fSuccess)
+{
+	// check for clients that still need join-data
+	C4Network2Client *pClient = nullptr;
+	while ((pClient = Clients.GetNextClient(pClient)))
+		if (!pClient->hasJoinData())
+		{
+			if (fSuccess)
+				// now we can provide join data: send it
+				SendJoinData(pClient);
+			else
+				// join data could not be created: emergency kick
+				Game.Clients.CtrlRemove(pClient->getClient(), LoadResStr("IDS_ERR_ERRORWHILECREATINGJOINDAT"));
+		}
 }
 
 void C4Network2::DrawStatus(C4TargetFacet &cgo)
@@ -1646,8 +1686,10 @@ void C4Network2::SendJoinData(C4Network2Client *pClient)
 	if (pClient->hasJoinData()) return;
 	// host only, scenario must be available
 	assert(isHost());
-	// dynamic available?
-	if (ResDynamic.isNull() || iDynamicTick < ::Control.ControlTick)
+	// dynamic being packed? Join data will be sent when it's done
+	if (pDynamicPacker) return;
+	// dynamic available? (outdated ones can be used as long as the control since then is kept)
+	if (ResDynamic.isNull() || (iDynamicTick < ::Control.ControlTick && pControl->getKeepCtrlTick() != iDynamicTick))
 	{
 		fDynamicNeeded = true;
 		// add synchronization control (will callback, see C4Game::Synchronize)
@@ -1779,6 +1821,28 @@ bool C4Network2::CreateDynamic(bool fInit)
 	sprintf(szDynamicBase, Config.AtNetworkPath("Dyn%s"), GetFilename(Game.ScenarioFilename), _MAX_PATH);
 	if (!ResList.FindTempResFileName(szDynamicBase, szDynamicFilename))
 		Log(LoadResStr("IDS_NET_SAVE_ERR_CREATEDYNFILE"));
+	// runtime join: save unpacked, so the game only stops for the savegame itself.
+	// It's packed in the background and join data is sent when it's done (see OnDynamicPacked).
+	if (!fInit)
+	{
+		C4Group DynamicGrp;
+		if (!CreatePath(szDynamicFilename) || !DynamicGrp.Open(szDynamicFilename))
+			{ Log(LoadResStr("IDS_NET_SAVE_ERR_CREATEDYNFILE")); return false; }
+		C4GameSaveNetwork SaveGame(false);
+		if (!SaveGame.Save(DynamicGrp, false) || !SaveGame.Close() || !DynamicGrp.Close())
+			{ Log(LoadResStr("IDS_NET_SAVE_ERR_SAVEDYNFILE")); EraseItem(szDynamicFilename); return false; }
+		iDynamicTick = ::Control.getNextControlTick();
+		// keep the control since then for the joining clients
+		pControl->setKeepCtrlTick(iDynamicTick);
+		pDynamicPacker = new C4Network2DynamicPacker(&ResList, szDynamicFilename, Config.AtRelativePath(szDynamicFilename));
+		if (!pDynamicPacker->Start())
+		{
+			delete pDynamicPacker; pDynamicPacker = nullptr;
+			pControl->setKeepCtrlTick(-1);
+			Log(LoadResStr("IDS_NET_SAVE_ERR_ADDDYNDATARES")); return false;
+		}
+		return true;
+	}
 	// save dynamic data
 	C4GameSaveNetwork SaveGame(fInit);
 	if (!SaveGame.Save(szDynamicFilename) || !SaveGame.Close())
@@ -3051,3 +3115,22 @@ bool C4Network2::isStreaming() const
 	// Streaming must be active and there must still be anything to stream
 	return fStreaming;
 }
+
+// *** C4Network2DynamicPacker
+
+C4Network2DynamicPacker::C4Network2DynamicPacker(C4Network2ResList *pResList, const char *szFilename, const char *szResName)
+		: pRes(new C4Network2Res(pResList)), Filename(szFilename), ResName(szResName)
+{
+}
+
+void C4Network2DynamicPacker::Execute()
+{
+	// pack in place and calculate checksums; the resource ID is set by the main thread
+	fSuccess = pRes->SetByFile(Filename.getData(), true, NRT_Dynamic, C4NetResIDAnonymous, ResName.getData(), true) &&
+	           pRes->GetStandalone(nullptr, 0, true, false, true);
+	if (!fSuccess) EraseItem(Filename.getData());
+	fDone = true;
+	// notify main thread
+	Application.InteractiveThread.ThreadPostAsync([] { ::Network.OnDynamicPacked(); });
+	SignalStop();
+}
@@ -98,6 +98,28 @@ public:
 	void CompileFunc(StdCompiler *pComp) override;
 };
 
+// Packs a runtime join savegame and calculates its checksums in the background,
+// so the host only has to stop the game for saving it unpacked
+class C4Network2DynamicPacker : public StdThread
+{
+public:
+	C4Network2DynamicPacker(C4Network2ResList *pResList, const char *szFilename, const char *szResName);
+	~C4Network2DynamicPacker() override { Stop(); }
+
+private:
+	C4Network2Res::Ref pRes;
+	StdCopyStrBuf Filename, ResName;
+	std::atomic<bool> fDone{false};
+	bool fSuccess{false};
+
+protected:
+	void Execute() override;
+
+public:
+	bool isDone() const { return fDone; }
+	C4Network2Res::Ref getRes() const { return fSuccess ? pRes : C4Network2Res::Ref(); } // after isDone
+};
+
 class C4Network2 : private C4ApplicationSec1Timer
 {
 	friend class C4Network2IO;
@@ -135,6 +157,7 @@ protected:
 	// resources
 	int32_t iDynamicTick{-1};
 	bool fDynamicNeeded{false};
+	C4Network2DynamicPacker *pDynamicPacker{nullptr}; // runtime join dynamic being packed
 
 	// game status flags
 	bool fStatusAck{false}, fStatusReached{false};
@@ -262,6 +285,7 @@ public:
 
 	// runtime join stuff
 	void OnGameSynchronized();
+	void OnDynamicPacked(); // by main thread
 
 	// status
 	void DrawStatus(C4TargetFacet &cgo);
@@ -338,6 +362,7 @@ protected:
 	// resource list
 	bool CreateDynamic(bool fInit);
 	void RemoveDynamic();
+	void OnDynamicCreated(bool fSuccess);
 
 	// status changes
 	bool PauseGame(bool fAutoContinue);
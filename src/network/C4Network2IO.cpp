@@ -66,6 +66,9 @@ bool C4Network2IO::Init(int16_t iPortTCP, int16_t iPortUDP, int16_t iPortDiscove
 	Thread.SetCallback(Ev_Net_Disconn, this);
 	Thread.SetCallback(Ev_Net_Packet, this);
 
+	// wait for connections by epoll, if selected (and available)
+	Thread.SetUseEpoll(!!Config.Network.UseEpoll);
+
 	// initialize UPnP manager
 	if (enable_upnp && (iPortTCP > 0 || iPortUDP > 0))
 	{
@@ -30,6 +30,7 @@
 #include "landscape/C4SolidMask.h"
 #include "lib/StdColors.h"
 #include "lib/StdMeshLoader.h"
+#include "object/C4DefList.h"
 #include "object/C4Object.h"
 #include "platform/C4FileMonitor.h"
 #include "platform/C4SoundSystem.h"
@@ -180,6 +181,8 @@ bool C4Def::Decompile(StdStrBuf *pOut, const char *szName)
 
 void C4Def::CompileFunc(StdCompiler *pComp)
 {
+	// Some values are adjusted to the graphics, so reading them must not depend on whether these have been needed yet
+	if (pComp->isSerializer()) GetGraphics();
 
 	pComp->Value(mkNamingAdapt(id,                "id",                 C4ID::None          ));
 	pComp->Value(mkNamingAdapt(toC4CArr(rC4XVer),             "Version"                               ));
@@ -300,6 +303,8 @@ void C4Def::Default()
 	DefaultDefCore();
 	Next=nullptr;
 	Temporary=false;
+	GraphicsPending=false;
+	GraphicsSourceTime=0; GraphicsSourceSize=0;
 	Filename[0]=0;
 	Creation=0;
 	Count=0;
@@ -325,6 +330,7 @@ void C4Def::Clear()
 	C4PropList::Clear();
 
 	Graphics.Clear();
+	GraphicsPending = false;
 
 	StringTable.Clear();
 	
@@ -344,6 +350,20 @@ void C4Def::Clear()
 	delete pSolidMask; pSolidMask = nullptr;
 }
 
+// The file that holds a definition: its folder, or the packed group file it is in
+static void GetSourceFileStamp(const char *szFilename, int32_t *piTime, size_t *piSize)
+{
+	char szPath[_MAX_PATH_LEN]; SCopy(szFilename, szPath, _MAX_PATH);
+	while (!FileExists(szPath))
+		if (!TruncatePath(szPath))
+		{
+			*piTime = 0; *piSize = 0;
+			return;
+		}
+	*piTime = FileTime(szPath);
+	*piSize = DirectoryExists(szPath) ? 0 : FileSize(szPath);
+}
+
 bool C4Def::Load(C4Group &hGroup,
 	StdMeshSkeletonLoader &loader,
 	DWORD dwLoadWhat,
@@ -367,7 +387,7 @@ bool C4Def::Load(C4Group &hGroup,
 
 	// Pre-read all images and shader stuff because they ar eaccessed in unpredictable order during loading
 	hGroup.PreCacheEntries(C4CFN_ShaderFiles);
-	hGroup.PreCacheEntries(C4CFN_ImageFiles);
+	if (!(dwLoadWhat & C4D_Load_LazyGraphics)) hGroup.PreCacheEntries(C4CFN_ImageFiles);
 
 	LoadMeshMaterials(hGroup, gfx_backup);
 	bool fSuccess = LoadParticleDef(hGroup);
@@ -387,8 +407,19 @@ bool C4Def::Load(C4Group &hGroup,
 	// Read and parse SolidMask bitmap
 	if (!LoadSolidMask(hGroup)) return false;
 
-	// Read surface bitmap, meshes, skeletons
-	if ((dwLoadWhat & C4D_Load_Bitmap) && !LoadGraphics(hGroup, loader)) return false;
+	// Read skeletons, surface bitmap, meshes
+	if (dwLoadWhat & C4D_Load_Bitmap)
+	{
+		// skeletons are always read right away, because meshes of other definitions may use them
+		Graphics.LoadSkeletons(hGroup, loader);
+		if (dwLoadWhat & C4D_Load_LazyGraphics)
+		{
+			GraphicsPending = true;
+			GetSourceFileStamp(Filename, &GraphicsSourceTime, &GraphicsSourceSize);
+		}
+		else if (!LoadGraphics(hGroup, loader))
+			return false;
+	}
 
 	// Read string table
 	C4Language::LoadComponentHost(&StringTable, hGroup, C4CFN_ScriptStringTbl, szLanguage);
@@ -497,7 +528,12 @@ bool C4Def::LoadGraphics(C4Group &hGroup, StdMeshSkeletonLoader &loader)
 	// Try to load graphics
 	// No fail on error - just have an object without graphics.
 	Graphics.Load(hGroup, loader, !!ColorByOwner);
+	AdjustToGraphics();
+	return true;
+}
 
+void C4Def::AdjustToGraphics()
+{
 	if (Graphics.Type == C4DefGraphics::TYPE_Bitmap)
 	{
 		// Bitmap post-load settings
@@ -523,8 +559,26 @@ bool C4Def::LoadGraphics(C4Group &hGroup, StdMeshSkeletonLoader &loader)
 	{
 		TopFace.Default();
 	}
+}
 
-	return true;
+bool C4Def::LoadPendingGraphics()
+{
+	if (!GraphicsPending) return true;
+	GraphicsPending = false;
+	// Graphics of another version of the definition would not match the rest of it
+	int32_t iTime; size_t iSize;
+	GetSourceFileStamp(Filename, &iTime, &iSize);
+	C4Group hGroup;
+	if (!iTime || iTime != GraphicsSourceTime || iSize != GraphicsSourceSize || !hGroup.Open(Filename))
+	{
+		LogF("WARNING: Graphics of %s (%s) not loaded, because the definition has been changed or removed", Filename, id.ToString());
+		// Go on like with a definition without graphics
+		AdjustToGraphics();
+		return false;
+	}
+	if (Config.Graphics.VerboseObjectLoading>=2)
+		LogF("Loading graphics of %s", id.ToString());
+	return LoadGraphics(hGroup, ::Definitions.GetSkeletonLoader());
 }
 
 void C4Def::LoadScript(C4Group &hGroup, const char* szLanguage)
@@ -609,7 +663,7 @@ void C4Def::Draw(C4Facet &cgo, bool fSelected, DWORD iColor, C4Object *pObj, int
 	if(fSelected)
 		pDraw->DrawBoxDw(cgo.Surface, cgo.X, cgo.Y, cgo.X + cgo.Wdt - 1, cgo.Y + cgo.Hgt - 1, C4RGB(0xca, 0, 0));
 
-	C4DefGraphics* graphics = pObj ? pObj->GetGraphics() : &Graphics;
+	C4DefGraphics* graphics = pObj ? pObj->GetGraphics() : &GetGraphics();
 	if (graphicsName)
 	{
 		C4DefGraphics *other = graphics->Get(graphicsName);
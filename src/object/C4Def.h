@@ -89,7 +89,8 @@ C4D_Load_RankNames = 256,
 C4D_Load_RankFaces = 512,
 C4D_Load_FE        = C4D_Load_Image,
 C4D_Load_RX        = C4D_Load_Bitmap | C4D_Load_Script | C4D_Load_ClonkNames | C4D_Load_Sounds | C4D_Load_RankNames | C4D_Load_RankFaces,
-C4D_Load_Temporary = 1024;
+C4D_Load_Temporary = 1024,
+C4D_Load_LazyGraphics = 2048; // with C4D_Load_Bitmap: load meshes and bitmaps when first used
 
 #define C4D_Blit_Normal     0
 #define C4D_Blit_Additive   1
@@ -159,6 +160,7 @@ private:
 	bool LoadParticleDef(C4Group &hGroup);
 	bool LoadSolidMask(C4Group &hGroup);
 	bool LoadGraphics(C4Group &hGroup, StdMeshSkeletonLoader &loader);
+	void AdjustToGraphics(); // DefCore values that depend on the loaded graphics
 	void LoadScript(C4Group &hGroup, const char* szLanguage);
 	void LoadClonkNames(C4Group &hGroup, C4ComponentHost* pClonkNames, const char* szLanguage);
 	void LoadRankNames(C4Group &hGroup, const char* szLanguage);
@@ -188,7 +190,7 @@ public:
 	C4RankSystem *pRankNames; bool fRankNamesOwned;
 	C4FacetSurface *pRankSymbols; bool fRankSymbolsOwned;
 	int32_t iNumRankSymbols;    // number of rank symbols available, if loaded
-	C4DefGraphics Graphics; // base graphics. points to additional graphics
+	C4DefGraphics Graphics; // base graphics. points to additional graphics; use GetGraphics() unless they are known to be loaded
 	CSurface8 *pSolidMask; // SolidMask-bitmap. Nonzero pixels are solid.
 
 protected:
@@ -197,6 +199,8 @@ protected:
 protected:
 	C4Def *Next;
 	bool Temporary;
+	bool GraphicsPending; // loaded with C4D_Load_LazyGraphics and graphics not needed yet
+	int32_t GraphicsSourceTime; size_t GraphicsSourceSize; // file holding the definition when its graphics were deferred
 public:
 	void Clear();
 	void Default();
@@ -207,6 +211,9 @@ public:
 		C4DefGraphicsPtrBackup *gfx_backup = nullptr);
 	void Draw(C4Facet &cgo, bool fSelected=false, DWORD iColor=0, C4Object *pObj=nullptr, int32_t iPhaseX=0, int32_t iPhaseY=0, C4DrawTransform* trans=nullptr, const char * graphicsName=nullptr);
 
+	C4DefGraphics &GetGraphics() { if (GraphicsPending) LoadPendingGraphics(); return Graphics; }
+	bool HasPendingGraphics() const { return GraphicsPending; }
+	bool LoadPendingGraphics();
 	inline C4Facet &GetMainFace(C4DefGraphics *pGraphics, DWORD dwClr=0) { MainFace.Surface=pGraphics->GetBitmap(dwClr); return MainFace; }
 	int32_t GetPlane() { return GetPropertyInt(P_Plane); }
 	int32_t GetValue(C4Object *pInBase, int32_t iBuyPlayer);         // get value of def; calling script functions if defined
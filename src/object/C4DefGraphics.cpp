@@ -223,17 +223,20 @@ bool C4DefGraphics::LoadSkeleton(C4Group &hGroup, const char* szFileName, StdMes
 	return true;
 }
 
-bool C4DefGraphics::Load(C4Group &hGroup, StdMeshSkeletonLoader &loader, bool fColorByOwner)
+void C4DefGraphics::LoadSkeletons(C4Group &hGroup, StdMeshSkeletonLoader &loader)
 {
 	char Filename[_MAX_PATH_LEN]; *Filename=0;
-
-	// load skeletons
 	hGroup.ResetSearch();
 	while (hGroup.FindNextEntry("*", Filename, nullptr, !!*Filename))
 	{
 		if (!WildcardMatch(C4CFN_DefSkeleton, Filename) && !WildcardMatch(C4CFN_DefSkeletonXml, Filename)) continue;
 		LoadSkeleton(hGroup, Filename, loader);
 	}
+}
+
+bool C4DefGraphics::Load(C4Group &hGroup, StdMeshSkeletonLoader &loader, bool fColorByOwner)
+{
+	char Filename[_MAX_PATH_LEN]; *Filename=0;
 
 	// Try from Mesh first
 	if (!LoadMesh(hGroup, C4CFN_DefMesh, loader))
@@ -404,7 +407,7 @@ void C4DefGraphicsAdapt::CompileFunc(StdCompiler *pComp)
 		// search definition, throw expection if not found
 		C4Def *pDef = ::Definitions.ID2Def(id);
 		// search def-graphics
-		if (!pDef || !( pDefGraphics = pDef->Graphics.Get(Name.getData()) ))
+		if (!pDef || !( pDefGraphics = pDef->GetGraphics().Get(Name.getData()) ))
 			pComp->excCorrupt(R"(DefGraphics: could not find graphics "%s" in %s(%s)!)", Name.getData(), id.ToString(), pDef ? pDef->GetName() : "def not found");
 	}
 }
@@ -462,7 +465,7 @@ void C4DefGraphicsPtrBackupEntry::AssignUpdate()
 							assert(&pObj->pMeshInstance->GetMesh() == &pMeshUpdate->GetOldMesh()); // mesh instance of correct type even
 
 							// Get new mesh from reloaded graphics
-							C4DefGraphics *pGrp = pDef->Graphics.Get(Name);
+							C4DefGraphics *pGrp = pDef->GetGraphics().Get(Name);
 							if(pGrp && pGrp->Type == C4DefGraphics::TYPE_Mesh)
 								pMeshUpdate->Update(pObj->pMeshInstance, *pGrp->Mesh);
 						}
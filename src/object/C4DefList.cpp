@@ -43,7 +43,7 @@ namespace
 			}
 
 			// append animations, if the definition has a mesh
-			if (!def->Graphics.IsMesh())
+			if (!def->GetGraphics().IsMesh())
 			{
 				DebugLogF("WARNING: Looking up skeleton from definition '%s' failed, because the definition has no mesh", definition);
 				return nullptr;
@@ -445,6 +445,32 @@ bool C4DefList::Reload(C4Def *pDef, DWORD dwLoadWhat, const char *szLanguage, C4
 	return true;
 }
 
+int32_t C4DefList::LoadGraphicsManifest(const char *szFilename)
+{
+	// one ID per line
+	StdStrBuf Manifest;
+	if (!Manifest.LoadFromFile(szFilename)) return 0;
+	int32_t iLoaded = 0;
+	char szID[C4MaxName + 1];
+	for (int32_t i = 0; SCopySegment(Manifest.getData(), i, szID, '\n', C4MaxName); ++i)
+	{
+		SClearFrontBack(szID, '\r');
+		C4Def *pDef = ID2Def(C4ID(std::string(szID)));
+		if (pDef && pDef->HasPendingGraphics() && pDef->LoadPendingGraphics())
+			++iLoaded;
+	}
+	return iLoaded;
+}
+
+bool C4DefList::SaveGraphicsManifest(const char *szFilename)
+{
+	StdStrBuf Manifest;
+	for (C4Def *pDef = FirstDef; pDef; pDef = pDef->Next)
+		if (!pDef->HasPendingGraphics())
+			Manifest.AppendFormat("%s\n", pDef->id.ToString());
+	return Manifest.SaveToFile(szFilename);
+}
+
 bool C4DefList::DrawFontImage(const char* szImageTag, C4Facet& cgo, C4DrawTransform* pTransform)
 {
 	return Game.DrawTextSpecImage(cgo, szImageTag, pTransform);
@@ -62,6 +62,8 @@ public:
 	void Remove(C4Def *def);
 	bool Remove(C4ID id);
 	bool Reload(C4Def *pDef, DWORD dwLoadWhat, const char *szLanguage, C4SoundSystem *pSoundSystem = nullptr);
+	int32_t LoadGraphicsManifest(const char *szFilename); // load the pending graphics of all definitions listed in the file
+	bool SaveGraphicsManifest(const char *szFilename); // list all definitions with loaded graphics
 	bool Add(C4Def *ndef, bool fOverload);
 	void BuildTable();
 	void ResetIncludeDependencies(); // resets all pointers into foreign definitions caused by include chains
@@ -22,6 +22,39 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 #include "player/C4PlayerList.h"
+#include "script/C4AulExec.h"
+
+// *** C4FindObjectStats
+
+C4FindObjectStats C4FindObject::Stats;
+
+void C4FindObjectStats::Reset()
+{
+	*this = C4FindObjectStats();
+}
+
+void C4FindObjectStats::Show()
+{
+	if (!Searches) return;
+	Log("FindObject statistics:");
+	Log("==============================");
+	LogF("%u searches: %u full, %u sector, %u container, %u index, %u ring scans, %u objects visited", Searches, FullScans, SectorScans, ContainerScans, IndexScans, RingScans, Candidates);
+	for (int32_t i = 0; i < C4SO_First; i++)
+		if (Checks[i])
+			LogF("condition %d: %u checks, %u%% passed", i, Checks[i], static_cast<uint32_t>(uint64_t(Passes[i]) * 100 / Checks[i]));
+	Log("==============================");
+}
+
+namespace
+{
+	// Reset and show statistics along with the script profiler
+	class C4FindObjectProfilerStats : public C4AulProfiler::StatsSource
+	{
+	public:
+		void ResetStats() override { C4FindObject::Stats.Reset(); }
+		void ShowStats() override { C4FindObject::Stats.Show(); }
+	} FindObjectProfilerStats;
+}
 
 // *** C4FindObject
 
@@ -324,152 +357,281 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
 	return pArray;
 }
 
-int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
+template<typename Fn> void C4FindObject::ForEachCandidate(const C4ObjectList &Objs, Fn fn, const BestResult *pNearest)
 {
-	// Trivial cases
-	if (IsImpossible())
-		return 0;
-	if (IsEnsured())
-		return Objs.ObjectCount();
-	// Check bounds
+	const bool fStats = C4AulProfiler::IsProfiling();
+	if (fStats) ++Stats.Searches;
+	auto fnVisit = [fStats, &fn](C4Object *obj)
+	{
+		if (fStats) ++Stats.Candidates;
+		return fn(obj);
+	};
+	// Objects in a given container: Only its contents can match
+	if (C4Object *pContainer = GetContainer())
+	{
+		if (fStats) ++Stats.ContainerScans;
+		// Visit in main list order like a full scan would
+		std::vector<C4Object *> Contents;
+		for (C4Object *obj : pContainer->Contents)
+			// Inactive objects might still be in the contents list
+			if (obj->Status == C4OS_NORMAL)
+				Contents.push_back(obj);
+		::Objects.SortByListOrder(Contents);
+		for (C4Object *obj : Contents)
+			if (obj->Status)
+				if (!fnVisit(obj))
+					return;
+		return;
+	}
+	// Objects of a definition or category: Use the object index of the main list if it holds fewer candidates
 	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return Count(Objs);
-	else if (UseShapes())
+	if (&Objs == &::Objects)
 	{
-		// Get area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
-		// Check if a single-sector check is enough
-		if (!Area.Next(pSct))
-			return Count(pSct->ObjectShapes);
-		// Create marker, count over all areas
-		uint32_t iMarker = ::Objects.GetNextMarker();
-		int32_t iCount = 0;
-		for (; pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			for (C4Object *obj : Objs)
-				if (obj->Status)
-					if (obj->Marker != iMarker)
+		// Estimate the number of objects visited by a sector or full scan
+		int64_t iScanCnt = ::Objects.GetIndexedCount();
+		const C4LSectors &Sct = ::Objects.Sectors;
+		if (pBounds && Sct.PxWdt > 0 && Sct.PxHgt > 0)
+			iScanCnt = iScanCnt * std::min<int64_t>(int64_t(pBounds->Wdt) * pBounds->Hgt, int64_t(Sct.PxWdt) * Sct.PxHgt) / (int64_t(Sct.PxWdt) * Sct.PxHgt);
+		const std::vector<C4Object *> *pDefObjs = nullptr;
+		C4PropList *pDef = GetDefinition();
+		if (pDef)
+		{
+			pDefObjs = ::Objects.GetObjectsByPrototype(pDef);
+			// Nothing has this prototype
+			if (!pDefObjs) return;
+		}
+		uint32_t dwCategory = GetCategory();
+		int64_t iCategoryCnt = 0;
+		if (dwCategory)
+			for (int32_t iBit = 0; iBit < 32; ++iBit)
+				if (dwCategory & (1u << iBit))
+					iCategoryCnt += ::Objects.GetObjectsByCategoryBit(iBit).size();
+		bool fUseDef = pDefObjs && int64_t(pDefObjs->size()) <= iScanCnt && (!dwCategory || int64_t(pDefObjs->size()) <= iCategoryCnt);
+		bool fUseCategory = !fUseDef && dwCategory && iCategoryCnt <= iScanCnt;
+		if (fUseDef || fUseCategory)
+		{
+			if (fStats) ++Stats.IndexScans;
+			// The index is ordered by object number: Gather the candidates and visit them in main list order like a full scan would
+			// Iterating over this copy also keeps the search safe from script conditions or sort functions adding or removing objects
+			std::vector<C4Object *> Candidates;
+			if (fUseDef)
+				Candidates = *pDefObjs;
+			else
+				for (int32_t iBit = 0; iBit < 32; ++iBit)
+					if (dwCategory & (1u << iBit))
 					{
-						obj->Marker = iMarker;
-						if (Check(obj))
-							iCount++;
+						// Objects with several of the category bits are only taken from the list of the lowest of them
+						uint32_t dwSkipCategory = dwCategory & ((1u << iBit) - 1);
+						for (C4Object *obj : ::Objects.GetObjectsByCategoryBit(iBit))
+							if (!(obj->Category & dwSkipCategory))
+								Candidates.push_back(obj);
 					}
-		return iCount;
+			::Objects.SortByListOrder(Candidates);
+			for (C4Object *obj : Candidates)
+				if (obj->Status)
+					if (!fnVisit(obj))
+						return;
+			return;
+		}
+	}
+	// Nearest object: Search sectors outward from the point
+	// Shape conditions may match objects positioned outside their bounds, so these use the regular search
+	int32_t iNearX, iNearY;
+	if (pNearest && &Objs == &::Objects && !(pBounds && UseShapes()) && pSort->GetDistanceOrigin(iNearX, iNearY))
+	{
+		if (fStats) ++Stats.RingScans;
+		ForEachNearCandidate(iNearX, iNearY, fnVisit, *pNearest);
+		return;
+	}
+	// No bounds: Search everything
+	if (!pBounds)
+	{
+		if (fStats) ++Stats.FullScans;
+		for (C4Object *obj : Objs)
+			if (obj->Status)
+				if (!fnVisit(obj))
+					return;
+		return;
+	}
+	// Traverse sectors of the bounds area
+	if (fStats) ++Stats.SectorScans;
+	C4LArea Area(&::Objects.Sectors, *pBounds);
+	C4LSector *pSct = Area.First();
+	if (!UseShapes())
+	{
+		for (; pSct; pSct = Area.Next(pSct))
+			if (!pSct->ForEachObject([&fnVisit](C4Object *obj) { return !obj->Status || fnVisit(obj); }))
+				return;
+	}
+	// Check if a single-sector check is enough
+	else if (!Area.Next(pSct))
+	{
+		pSct->ForEachObjectShape([&fnVisit](C4Object *obj) { return !obj->Status || fnVisit(obj); });
 	}
 	else
 	{
-		// Count objects per area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		int32_t iCount = 0;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
-			iCount += Count(*pLst);
-		return iCount;
+		// Shapes may overlap several sectors: Create marker to visit each object only once
+		uint32_t iMarker = ::Objects.GetNextMarker();
+		for (; pSct; pSct = Area.Next(pSct))
+			if (!pSct->ForEachObjectShape([&fnVisit, iMarker](C4Object *obj)
+				{
+					if (!obj->Status || obj->Marker == iMarker) return true;
+					obj->Marker = iMarker;
+					return fnVisit(obj);
+				}))
+				return;
 	}
 }
 
-C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
+template<typename Fn> void C4FindObject::ForEachNearCandidate(int32_t iX, int32_t iY, Fn fnVisit, const BestResult &Nearest)
 {
-	// Trivial case
-	if (IsImpossible())
-		return nullptr;
-	C4Object *pBestResult = nullptr;
-	// Check bounds
-	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return Find(Objs);
-	// Traverse areas, return first matching object w/o sort or best with sort
-	else if (UseShapes())
+	C4LSectors &Sct = ::Objects.Sectors;
+	// Sectors that may hold matches
+	C4Rect Area(0, 0, Sct.PxWdt, Sct.PxHgt);
+	bool fOut = true;
+	if (C4Rect *pBounds = GetBounds())
 	{
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjectShapes(&pSct); pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			if ((pObj = Find(*pLst)))
-			{
-				if (!pSort)
-					return pObj;
-				else if (!pBestResult || pSort->Compare(pObj, pBestResult) > 0)
-					if (pObj->Status)
-						pBestResult = pObj;
-			}
+		C4Rect Bounds(*pBounds);
+		Bounds.Normalize();
+		fOut = !Area.Contains(Bounds);
+		Area.Intersect(Bounds);
 	}
-	else
+	// Objects outside the landscape first; there are usually few of them
+	if (fOut)
+		if (!Sct.SectorOut.ForEachObject([&fnVisit](C4Object *obj) { return !obj->Status || fnVisit(obj); }))
+			return;
+	if (Area.Wdt <= 0 || Area.Hgt <= 0) return;
+	int32_t iSx0 = Area.x / Sct.SectorWdt, iSx1 = (Area.x + Area.Wdt - 1) / Sct.SectorWdt;
+	int32_t iSy0 = Area.y / Sct.SectorHgt, iSy1 = (Area.y + Area.Hgt - 1) / Sct.SectorHgt;
+	// Center sector of the rings
+	int32_t iCx = Clamp<int32_t>(Clamp<int32_t>(iX, 0, Sct.PxWdt - 1) / Sct.SectorWdt, iSx0, iSx1);
+	int32_t iCy = Clamp<int32_t>(Clamp<int32_t>(iY, 0, Sct.PxHgt - 1) / Sct.SectorHgt, iSy0, iSy1);
+	int32_t iMaxRing = std::max(std::max(iCx - iSx0, iSx1 - iCx), std::max(iCy - iSy0, iSy1 - iCy));
+	auto fnVisitSector = [&Sct, &fnVisit](int32_t iSx, int32_t iSy)
 	{
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
+		return Sct.Sectors[iSy * Sct.Wdt + iSx].ForEachObject([&fnVisit](C4Object *obj) { return !obj->Status || fnVisit(obj); });
+	};
+	for (int32_t iRing = 0; iRing <= iMaxRing; ++iRing)
+	{
+		// Objects in this ring are at least as far away as the border of the sectors within it
+		// Those exactly as far away as the nearest object so far may still come first in the main list
+		if (iRing && Nearest.pObj)
 		{
-			if ((pObj = Find(*pLst)))
+			int64_t iMinDist = std::min(
+				std::min<int64_t>(iX - (iCx - iRing + 1) * Sct.SectorWdt, (iCx + iRing) * Sct.SectorWdt - iX),
+				std::min<int64_t>(iY - (iCy - iRing + 1) * Sct.SectorHgt, (iCy + iRing) * Sct.SectorHgt - iY));
+			if (iMinDist > 0 && Nearest.iValue < iMinDist * iMinDist)
+				return;
+		}
+		for (int32_t iSy = std::max(iCy - iRing, iSy0); iSy <= std::min(iCy + iRing, iSy1); ++iSy)
+		{
+			if (iSy == iCy - iRing || iSy == iCy + iRing)
 			{
-				if (!pSort)
-					return pObj;
-				else if (!pBestResult || pSort->Compare(pObj, pBestResult) > 0)
-					if (pObj->Status)
-						pBestResult = pObj;
+				// Top and bottom row of the ring
+				for (int32_t iSx = std::max(iCx - iRing, iSx0); iSx <= std::min(iCx + iRing, iSx1); ++iSx)
+					if (!fnVisitSector(iSx, iSy))
+						return;
+			}
+			else
+			{
+				// Left and right column of the ring
+				if (iCx - iRing >= iSx0)
+					if (!fnVisitSector(iCx - iRing, iSy))
+						return;
+				if (iCx + iRing <= iSx1)
+					if (!fnVisitSector(iCx + iRing, iSy))
+						return;
 			}
 		}
 	}
-	return pBestResult;
 }
 
-// return is to be freed by the caller
-C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors &Sct)
+int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
+{
+	// Trivial cases
+	if (IsImpossible())
+		return 0;
+	if (IsEnsured())
+		return Objs.ObjectCount();
+	// Count
+	int32_t iCount = 0;
+	ForEachCandidate(Objs, [this, &iCount](C4Object *obj)
+	{
+		if (Check(obj))
+			iCount++;
+		return true;
+	});
+	return iCount;
+}
+
+C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
 {
 	// Trivial case
 	if (IsImpossible())
-		return new C4ValueArray();
-	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return FindMany(Objs);
-	// Prepare for array that may be generated
-	C4ValueArray *pArray; int32_t iSize;
-	// Check shape lists?
-	if (UseShapes())
+		return nullptr;
+	// Search, return first matching object w/o sort or best with sort
+	// Double-check object status, as object might be deleted after Check()!
+	BestResult Best;
+	// Plain sort values need to be computed only once per object
+	C4SortObjectByValue *pPlainSort = pSort ? pSort->GetPlainValueSort() : nullptr;
+	// Sector and ring scans do not visit the main list in order: Ties go to the first object in the main list like in a full scan
+	const bool fMainList = &Objs == &::Objects;
+	ForEachCandidate(Objs, [this, pPlainSort, fMainList, &Best](C4Object *obj)
 	{
-		// Get area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
-		// Check if a single-sector check is enough
-		if (!Area.Next(pSct))
-			return FindMany(pSct->ObjectShapes);
-		// Set up array
-		pArray = new C4ValueArray(32); iSize = 0;
-		// Create marker, search all areas
-		uint32_t iMarker = ::Objects.GetNextMarker();
-		for (; pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			for (C4Object *obj : *pLst)
-				if (obj->Status)
-					if (obj->Marker != iMarker)
+		if (Check(obj))
+			if (obj->Status)
+			{
+				// no sorting: Use first object found
+				if (!pSort)
+				{
+					Best.pObj = obj;
+					return false;
+				}
+				// Sorting: Check if found object is better
+				if (pPlainSort)
+				{
+					int32_t iValue = pPlainSort->CompareGetValue(obj);
+					if (!Best.pObj || Best.iValue - iValue > 0 || (Best.iValue == iValue && fMainList && ::Objects.IsBeforeInList(obj, Best.pObj)))
 					{
-						obj->Marker = iMarker;
-						if (Check(obj))
-						{
-							// Grow the array, if neccessary
-							if (iSize >= pArray->GetSize())
-								pArray->SetSize(iSize * 2);
-							// Add object
-							(*pArray)[iSize++] = C4VObj(obj);
-						}
+						Best.pObj = obj;
+						Best.iValue = iValue;
 					}
-	}
-	else
+				}
+				else
+				{
+					int32_t iCmp = Best.pObj ? pSort->Compare(obj, Best.pObj) : 1;
+					if (iCmp > 0 || (!iCmp && fMainList && ::Objects.IsBeforeInList(obj, Best.pObj)))
+						if (obj->Status)
+							Best.pObj = obj;
+				}
+			}
+		return true;
+	}, pPlainSort ? &Best : nullptr);
+	return Best.pObj;
+}
+
+// return is to be freed by the caller
+C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors &Sct)
+{
+	// Trivial case
+	if (IsImpossible())
+		return new C4ValueArray();
+	// Set up array
+	C4ValueArray *pArray = new C4ValueArray(32);
+	int32_t iSize = 0;
+	// Search
+	ForEachCandidate(Objs, [this, pArray, &iSize](C4Object *obj)
 	{
-		// Set up array
-		pArray = new C4ValueArray(32); iSize = 0;
-		// Search
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
-			for (C4Object *obj : *pLst)
-				if (obj->Status)
-					if (Check(obj))
-					{
-						// Grow the array, if neccessary
-						if (iSize >= pArray->GetSize())
-							pArray->SetSize(iSize * 2);
-						// Add object
-						(*pArray)[iSize++] = C4VObj(obj);
-					}
-	}
+		if (Check(obj))
+		{
+			// Grow the array, if neccessary
+			if (iSize >= pArray->GetSize())
+				pArray->SetSize(iSize * 2);
+			// Add object
+			(*pArray)[iSize++] = C4VObj(obj);
+		}
+		return true;
+	});
 	// Shrink array
 	pArray->SetSize(iSize);
 	// Recheck object status (may shrink array again)
@@ -552,6 +714,9 @@ C4FindObjectAnd::C4FindObjectAnd(int32_t inCnt, C4FindObject **ppConds, bool fFr
 			// the objects will be filtered out later
 		}
 	}
+	// Check cheap conditions first, so they can reject objects before expensive ones (e.g. script calls) run.
+	// The order only depends on the conditions, so it is the same on all clients.
+	std::stable_sort(ppConds, ppConds + iCnt, [](C4FindObject *pCond1, C4FindObject *pCond2) { return pCond1->GetCost() < pCond2->GetCost(); });
 }
 
 C4FindObjectAnd::~C4FindObjectAnd()
@@ -564,12 +729,57 @@ C4FindObjectAnd::~C4FindObjectAnd()
 
 bool C4FindObjectAnd::Check(C4Object *pObj)
 {
+	if (C4AulProfiler::IsProfiling())
+	{
+		// Same as below, but count selectivity of the conditions
+		for (int32_t i = 0; i < iCnt; i++)
+		{
+			const int32_t id = ppConds[i]->GetID();
+			++Stats.Checks[id];
+			if (!ppConds[i]->Check(pObj))
+				return false;
+			++Stats.Passes[id];
+		}
+		return true;
+	}
 	for (int32_t i = 0; i < iCnt; i++)
 		if (!ppConds[i]->Check(pObj))
 			return false;
 	return true;
 }
 
+int32_t C4FindObjectAnd::GetCost()
+{
+	int32_t iCost = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+		iCost += ppConds[i]->GetCost();
+	return iCost;
+}
+
+C4Object *C4FindObjectAnd::GetContainer()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (C4Object *pContainer = ppConds[i]->GetContainer())
+			return pContainer;
+	return nullptr;
+}
+
+C4PropList *C4FindObjectAnd::GetDefinition()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (C4PropList *pDef = ppConds[i]->GetDefinition())
+			return pDef;
+	return nullptr;
+}
+
+int32_t C4FindObjectAnd::GetCategory()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (int32_t iCategory = ppConds[i]->GetCategory())
+			return iCategory;
+	return 0;
+}
+
 bool C4FindObjectAnd::IsImpossible()
 {
 	for (int32_t i = 0; i < iCnt; i++)
@@ -630,6 +840,14 @@ bool C4FindObjectOr::Check(C4Object *pObj)
 	return false;
 }
 
+int32_t C4FindObjectOr::GetCost()
+{
+	int32_t iCost = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+		iCost += ppConds[i]->GetCost();
+	return iCost;
+}
+
 bool C4FindObjectOr::IsEnsured()
 {
 	for (int32_t i = 0; i < iCnt; i++)
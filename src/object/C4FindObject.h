@@ -65,6 +65,32 @@ enum C4SortObjectCondID
 	C4SO_Last         = 50  // no sort condition larger than this
 };
 
+// Estimated relative cost of a single Check(), used to order the conditions of C4FindObjectAnd
+enum C4FindObjectCost
+{
+	C4FOC_Trivial  = 1,  // compare a member or test bits
+	C4FOC_Geometry = 2,  // position and shape arithmetic
+	C4FOC_Lookup   = 4,  // action, property or string lookups
+	C4FOC_Scan     = 8,  // linear scans over script data
+	C4FOC_Script   = 64, // script function calls
+};
+
+// Search planner statistics. Only collected while the script profiler is running.
+struct C4FindObjectStats
+{
+	uint32_t Searches;       // number of searches through the sector-aware entry points
+	uint32_t FullScans;      // searches over the whole object list
+	uint32_t SectorScans;    // searches driven by sector areas
+	uint32_t ContainerScans; // searches driven by container contents
+	uint32_t IndexScans;     // searches driven by the definition or category index of the main object list
+	uint32_t RingScans;      // nearest-object searches through sectors around a point
+	uint32_t Candidates;     // objects visited by all searches
+	uint32_t Checks[C4SO_First], Passes[C4SO_First]; // conditions evaluated within And, by condition type
+
+	void Reset();
+	void Show();
+};
+
 // Base class
 class C4FindObject
 {
@@ -89,16 +115,35 @@ public:
 
 	void SetSort(C4SortObject *pToSort);
 
+	static C4FindObjectStats Stats;
+
 protected:
 	// Overridables
 	virtual bool Check(C4Object *pObj) = 0;
+	virtual C4FindObjectCondID GetID() = 0;
+	virtual int32_t GetCost() { return C4FOC_Lookup; }
 	virtual C4Rect *GetBounds() { return nullptr; }
 	virtual bool UseShapes() { return false; }
+	virtual C4Object *GetContainer() { return nullptr; } // if set, only objects directly contained in it can match
+	virtual C4PropList *GetDefinition() { return nullptr; } // if set, only objects with this prototype can match
+	virtual int32_t GetCategory() { return 0; } // if set, only objects with any of these category bits can match
 	virtual bool IsImpossible() { return false; }
 	virtual bool IsEnsured() { return false; }
 
 private:
+	// Best match found so far by Find
+	struct BestResult
+	{
+		C4Object *pObj{nullptr};
+		int32_t iValue{0}; // sort value for sorts by plain values
+	};
+
 	void CheckObjectStatus(C4ValueArray *pArray);
+	// Pick the smallest set of objects that may contain all matches and call fn for each of them until it returns false
+	// If pNearest is given and the search is sorted by distance, sectors are visited outward from the point and the
+	// search stops once no remaining sector can hold an object closer than pNearest
+	template<typename Fn> void ForEachCandidate(const C4ObjectList &Objs, Fn fn, const BestResult *pNearest = nullptr);
+	template<typename Fn> void ForEachNearCandidate(int32_t iX, int32_t iY, Fn fn, const BestResult &Nearest);
 };
 
 // Combinators
@@ -112,6 +157,8 @@ private:
 	C4FindObject *pCond;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Not; }
+	int32_t GetCost() override { return pCond->GetCost(); }
 	bool IsImpossible() override { return pCond->IsEnsured(); }
 	bool IsEnsured() override { return pCond->IsImpossible(); }
 };
@@ -127,8 +174,13 @@ private:
 	C4Rect Bounds; bool fHasBounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_And; }
+	int32_t GetCost() override;
 	C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	bool UseShapes() override { return fUseShapes; }
+	C4Object *GetContainer() override;
+	C4PropList *GetDefinition() override;
+	int32_t GetCategory() override;
 	bool IsEnsured() override { return !iCnt; }
 	bool IsImpossible() override;
 	void ForgetConditions() { ppConds=nullptr; iCnt=0; }
@@ -154,6 +206,8 @@ private:
 	C4Rect Bounds; bool fHasBounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Or; }
+	int32_t GetCost() override;
 	C4Rect *GetBounds() override { return fHasBounds ? &Bounds : nullptr; }
 	bool UseShapes() override { return fUseShapes; }
 	bool IsEnsured() override;
@@ -170,6 +224,8 @@ private:
 	C4Object *pExclude;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Exclude; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 };
 
 class C4FindObjectDef : public C4FindObject
@@ -181,6 +237,9 @@ private:
 	C4PropList * def;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_ID; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
+	C4PropList *GetDefinition() override { return def; }
 	bool IsImpossible() override;
 };
 
@@ -193,6 +252,8 @@ private:
 	C4Rect rect;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_InRect; }
+	int32_t GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &rect; }
 	bool IsImpossible() override;
 };
@@ -206,6 +267,8 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_AtPoint; }
+	int32_t GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -219,6 +282,8 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_AtRect; }
+	int32_t GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -233,6 +298,8 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_OnLine; }
+	int32_t GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
 };
@@ -247,6 +314,8 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Distance; }
+	int32_t GetCost() override { return C4FOC_Geometry; }
 	C4Rect *GetBounds() override { return &bounds; }
 };
 
@@ -260,6 +329,8 @@ private:
 	C4Rect bounds;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Cone; }
+	int32_t GetCost() override { return C4FOC_Lookup; }
 	C4Rect *GetBounds() override { return &bounds; }
 };
 
@@ -272,6 +343,8 @@ private:
 	int32_t ocf;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_OCF; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 	bool IsImpossible() override;
 };
 
@@ -284,6 +357,9 @@ private:
 	int32_t iCategory;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Category; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
+	int32_t GetCategory() override { return iCategory; }
 	bool IsEnsured() override;
 };
 
@@ -296,6 +372,8 @@ private:
 	const char *szAction;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Action; }
+	int32_t GetCost() override { return C4FOC_Lookup; }
 };
 
 class C4FindObjectActionTarget : public C4FindObject
@@ -308,6 +386,8 @@ private:
 	int index;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_ActionTarget; }
+	int32_t GetCost() override { return C4FOC_Lookup; }
 };
 
 class C4FindObjectProcedure : public C4FindObject
@@ -319,6 +399,8 @@ private:
 	C4String * procedure;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Procedure; }
+	int32_t GetCost() override { return C4FOC_Lookup; }
 	bool IsImpossible() override;
 };
 
@@ -331,6 +413,9 @@ private:
 	C4Object *pContainer;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Container; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
+	C4Object *GetContainer() override { return pContainer; }
 };
 
 class C4FindObjectAnyContainer : public C4FindObject
@@ -339,6 +424,8 @@ public:
 	C4FindObjectAnyContainer() = default;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_AnyContainer; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 };
 
 class C4FindObjectOwner : public C4FindObject
@@ -350,6 +437,8 @@ private:
 	int32_t iOwner;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Owner; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 	bool IsImpossible() override;
 };
 
@@ -362,6 +451,8 @@ private:
 	int32_t controller;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Controller; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 	bool IsImpossible() override;
 };
 
@@ -375,6 +466,8 @@ private:
 	C4AulParSet Pars;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Func; }
+	int32_t GetCost() override { return C4FOC_Script; }
 	bool IsImpossible() override;
 };
 
@@ -390,6 +483,8 @@ private:
 	C4Value Value;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Property; }
+	int32_t GetCost() override { return C4FOC_Lookup; }
 	bool IsImpossible() override;
 };
 
@@ -401,6 +496,8 @@ private:
 	C4Object *pLayer;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_Layer; }
+	int32_t GetCost() override { return C4FOC_Trivial; }
 	bool IsImpossible() override;
 };
 
@@ -412,6 +509,8 @@ private:
 	C4ValueArray *pArray;
 protected:
 	bool Check(C4Object *pObj) override;
+	C4FindObjectCondID GetID() override { return C4FO_InArray; }
+	int32_t GetCost() override { return C4FOC_Scan; }
 	bool IsImpossible() override;
 };
 
@@ -429,6 +528,11 @@ public:
 	virtual bool PrepareCache(const C4ValueArray *pObjs) { return false; }
 	virtual int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) { return Compare(pObj1, pObj2); }
 
+	// Sorts by a value that depends on the object only (no random numbers or script calls), so it can be computed once per object
+	virtual class C4SortObjectByValue *GetPlainValueSort() { return nullptr; }
+	// Sorts by distance to a point
+	virtual bool GetDistanceOrigin(int32_t &iX, int32_t &iY) { return false; }
+
 public:
 	static C4SortObject *CreateByValue(const C4Value &Data, const C4Object *context=nullptr);
 	static C4SortObject *CreateByValue(int32_t iType, const C4ValueArray &Data, const C4Object *context=nullptr);
@@ -500,6 +604,8 @@ private:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	C4SortObjectByValue *GetPlainValueSort() override { return this; }
+	bool GetDistanceOrigin(int32_t &iToX, int32_t &iToY) override { iToX = iX; iToY = iY; return true; }
 };
 
 class C4SortObjectRandom : public C4SortObjectByValue // randomize order
@@ -518,6 +624,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	C4SortObjectByValue *GetPlainValueSort() override { return this; }
 };
 
 class C4SortObjectMass : public C4SortObjectByValue // sort by mass
@@ -527,6 +634,7 @@ public:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	C4SortObjectByValue *GetPlainValueSort() override { return this; }
 };
 
 class C4SortObjectValue : public C4SortObjectByValue // sort by value
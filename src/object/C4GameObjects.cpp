@@ -42,14 +42,15 @@ C4GameObjects::~C4GameObjects()
 void C4GameObjects::Default()
 {
 	Sectors.Clear();
+	ClearIndex();
 	LastUsedMarker = 0;
 	ForeObjects.Default();
 }
 
-void C4GameObjects::Init(int32_t width, int32_t height)
+void C4GameObjects::Init(int32_t width, int32_t height, int32_t sector_size)
 {
 	// Init sectors
-	Sectors.Init(width, height);
+	Sectors.Init(width, height, sector_size);
 }
 
 bool C4GameObjects::Add(C4Object *object)
@@ -69,6 +70,8 @@ bool C4GameObjects::Add(C4Object *object)
 		return false;
 	// Add to sectors
 	Sectors.Add(object, this);
+	// Add to object index
+	AddToIndex(object);
 	return true;
 }
 
@@ -82,12 +85,160 @@ bool C4GameObjects::Remove(C4Object *object)
 	}
 	// Remove from sectors
 	Sectors.Remove(object);
+	// Remove from object index
+	RemoveFromIndex(object);
 	// Remove from forelist
 	ForeObjects.Remove(object);
 	// Manipulate main list
 	return C4ObjectList::Remove(object);
 }
 
+static bool CompareObjectNumbers(const C4Object *a, const C4Object *b)
+{
+	return a->Number < b->Number;
+}
+
+void C4GameObjects::InsertIndexed(std::vector<C4Object *> &objects, C4Object *object)
+{
+	// New objects have the highest number, so this usually appends
+	objects.insert(std::upper_bound(objects.begin(), objects.end(), object, CompareObjectNumbers), object);
+}
+
+bool C4GameObjects::IsIndexed(const std::vector<C4Object *> &objects, C4Object *object)
+{
+	auto it = std::lower_bound(objects.begin(), objects.end(), object, CompareObjectNumbers);
+	return it != objects.end() && *it == object;
+}
+
+bool C4GameObjects::EraseIndexed(std::vector<C4Object *> &objects, C4Object *object)
+{
+	auto it = std::lower_bound(objects.begin(), objects.end(), object, CompareObjectNumbers);
+	if (it == objects.end() || *it != object) return false;
+	objects.erase(it);
+	return true;
+}
+
+void C4GameObjects::AddToIndex(C4Object *object)
+{
+	InsertIndexed(PrototypeIndex[object->GetPrototype()], object);
+	for (int32_t bit = 0; bit < 32; ++bit)
+		if (object->Category & (1u << bit))
+			InsertIndexed(CategoryIndex[bit], object);
+	++IndexedCount;
+}
+
+void C4GameObjects::RemoveFromIndex(C4Object *object)
+{
+	// Objects that were never indexed (e.g. during loading) are ignored
+	auto it = PrototypeIndex.find(object->GetPrototype());
+	if (it == PrototypeIndex.end() || !EraseIndexed(it->second, object)) return;
+	for (int32_t bit = 0; bit < 32; ++bit)
+		if (object->Category & (1u << bit))
+			EraseIndexed(CategoryIndex[bit], object);
+	--IndexedCount;
+}
+
+void C4GameObjects::ClearIndex()
+{
+	PrototypeIndex.clear();
+	for (auto &objects : CategoryIndex) objects.clear();
+	IndexedCount = 0;
+	ListOrderValid = false;
+}
+
+void C4GameObjects::RebuildIndex()
+{
+	ClearIndex();
+	for (C4Object *object : *this)
+		if (object->Status != C4OS_INACTIVE)
+			AddToIndex(object);
+}
+
+const std::vector<C4Object *> *C4GameObjects::GetObjectsByPrototype(const C4PropList *prototype) const
+{
+	auto it = PrototypeIndex.find(prototype);
+	return it != PrototypeIndex.end() ? &it->second : nullptr;
+}
+
+void C4GameObjects::OnPrototypeChanged(C4Object *object, const C4PropList *old_prototype)
+{
+	// Only reindex objects that are in the index
+	auto it = PrototypeIndex.find(old_prototype);
+	if (it == PrototypeIndex.end() || !EraseIndexed(it->second, object)) return;
+	InsertIndexed(PrototypeIndex[object->GetPrototype()], object);
+}
+
+void C4GameObjects::OnCategoryChanged(C4Object *object, int32_t old_category)
+{
+	// Only reindex objects that are in the index
+	auto it = PrototypeIndex.find(object->GetPrototype());
+	if (it == PrototypeIndex.end() || !IsIndexed(it->second, object)) return;
+	for (int32_t bit = 0; bit < 32; ++bit)
+	{
+		uint32_t mask = 1u << bit;
+		if ((old_category & mask) && !(object->Category & mask))
+			EraseIndexed(CategoryIndex[bit], object);
+		else if (!(old_category & mask) && (object->Category & mask))
+			InsertIndexed(CategoryIndex[bit], object);
+	}
+}
+
+// Gap between list positions after renumbering
+static const uint64_t ListOrderSpacing = uint64_t(1) << 32;
+
+void C4GameObjects::AssignListOrder(C4ObjectLink *link)
+{
+	if (!ListOrderValid) return;
+	// Take the middle between the neighbours; appended objects keep the regular spacing
+	uint64_t lower = link->Prev ? link->Prev->Obj->ListOrder : 0;
+	if (!link->Next && lower > UINT64_MAX - 2 * ListOrderSpacing)
+	{
+		ListOrderValid = false;
+		return;
+	}
+	uint64_t upper = link->Next ? link->Next->Obj->ListOrder : lower + 2 * ListOrderSpacing;
+	if (upper - lower < 2)
+	{
+		// No gap left: Renumber everything once it is needed
+		ListOrderValid = false;
+		return;
+	}
+	link->Obj->ListOrder = lower + (upper - lower) / 2;
+}
+
+void C4GameObjects::RenumberListOrder()
+{
+	uint64_t order = 0;
+	for (C4ObjectLink *link = First; link; link = link->Next)
+		link->Obj->ListOrder = (order += ListOrderSpacing);
+	ListOrderValid = true;
+}
+
+void C4GameObjects::InsertLinkBefore(C4ObjectLink *link, C4ObjectLink *before_link)
+{
+	C4NotifyingObjectList::InsertLinkBefore(link, before_link);
+	AssignListOrder(link);
+}
+
+void C4GameObjects::InsertLink(C4ObjectLink *link, C4ObjectLink *after_link)
+{
+	C4NotifyingObjectList::InsertLink(link, after_link);
+	AssignListOrder(link);
+}
+
+void C4GameObjects::SortByListOrder(std::vector<C4Object *> &objects)
+{
+	if (objects.size() < 2) return;
+	if (!ListOrderValid) RenumberListOrder();
+	std::sort(objects.begin(), objects.end(), [](const C4Object *a, const C4Object *b) { return a->ListOrder < b->ListOrder; });
+}
+
+bool C4GameObjects::IsBeforeInList(C4Object *first, C4Object *second)
+{
+	if (!ListOrderValid) RenumberListOrder();
+	return first->ListOrder < second->ListOrder;
+}
+
 void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 {
 	// Reverse area check: Checks for all <ball> at <goal>
@@ -251,6 +402,7 @@ void C4GameObjects::UpdateSolidMasks()
 
 void C4GameObjects::DeleteObjects(bool delete_inactive_objects)
 {
+	ClearIndex();
 	C4ObjectList::DeleteObjects();
 	Sectors.ClearObjects();
 	ForeObjects.Clear();
@@ -272,6 +424,8 @@ void C4GameObjects::Clear(bool clear_inactive_objects)
 
 int C4GameObjects::PostLoad(bool keep_inactive_objects, C4ValueNumbers *numbers)
 {
+	// Loaded objects were put into the main list directly
+	RebuildIndex();
 	// Process objects
 	int32_t max_object_number = 0;
 	for (C4Object *object : reverse())
@@ -29,7 +29,7 @@ public:
 	C4GameObjects(); // constructor
 	~C4GameObjects() override; // destructor
 	void Default() override;
-	void Init(int32_t width, int32_t height);
+	void Init(int32_t width, int32_t height, int32_t sector_size);
 	void Clear(bool fClearInactive); // clear objects
 	// Don't use default parameters so we get a correct vtbl entry
 	// Don't clear internal objects, because they should not be cleared on section load
@@ -38,6 +38,29 @@ public:
 private:
 	uint32_t LastUsedMarker; // Last used value for C4Object::Marker
 
+	// Objects of the main list grouped by prototype and by category bit
+	// Each group is ordered by object number, so iteration order does not depend on the history of the list
+	std::unordered_map<const C4PropList *, std::vector<C4Object *>> PrototypeIndex;
+	std::vector<C4Object *> CategoryIndex[32];
+	int32_t IndexedCount{0};
+
+	static void InsertIndexed(std::vector<C4Object *> &objects, C4Object *game_object);
+	static bool IsIndexed(const std::vector<C4Object *> &objects, C4Object *game_object);
+	static bool EraseIndexed(std::vector<C4Object *> &objects, C4Object *game_object);
+	void AddToIndex(C4Object *game_object);
+	void RemoveFromIndex(C4Object *game_object);
+	void ClearIndex();
+	void RebuildIndex();
+
+	// Increasing values of C4Object::ListOrder along the main list, with gaps for inserted objects
+	bool ListOrderValid{false}; // if unset, positions are renumbered on the next lookup
+	void AssignListOrder(C4ObjectLink *link);
+	void RenumberListOrder();
+
+protected:
+	void InsertLinkBefore(C4ObjectLink *link, C4ObjectLink *before_link) override;
+	void InsertLink(C4ObjectLink *link, C4ObjectLink *after_link) override;
+
 public:
 	C4LSectors Sectors; // Section object lists
 	C4ObjectList InactiveObjects; // Inactive objects (Status=2)
@@ -60,6 +83,15 @@ public:
 	void UpdateScriptPointers(); // Update pointers to C4AulScript *
 	C4Value GRBroadcast(const char *function_name, C4AulParSet *parameters, bool pass_error, bool reject_test);  // Call function in all goals/rules/environment objects
 
+	// Object index lookups. Returned groups may contain objects that are being removed (Status=0).
+	const std::vector<C4Object *> *GetObjectsByPrototype(const C4PropList *prototype) const; // nullptr if there are none
+	const std::vector<C4Object *> &GetObjectsByCategoryBit(int32_t bit) const { return CategoryIndex[bit]; }
+	int32_t GetIndexedCount() const { return IndexedCount; }
+	void OnPrototypeChanged(C4Object *game_object, const C4PropList *old_prototype); // Keep index in sync with Find_ID
+	void OnCategoryChanged(C4Object *game_object, int32_t old_category); // Keep index in sync with Find_Category
+	void SortByListOrder(std::vector<C4Object *> &objects); // Restore main list order of search candidates taken from elsewhere
+	bool IsBeforeInList(C4Object *first, C4Object *second); // Whether first comes before second in the main list
+
 	void UpdatePos(C4Object *game_object);
 	void UpdatePosResort(C4Object *game_object);
 
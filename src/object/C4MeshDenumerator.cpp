@@ -65,7 +65,7 @@ void C4MeshDenumerator::CompileFunc(StdCompiler* pComp, StdMeshInstance::Attache
 		if (Def)
 		{
 			assert(attach->OwnChild);
-			C4DefGraphics* pGfx = &Def->Graphics;
+			C4DefGraphics* pGfx = &Def->GetGraphics();
 			assert(pGfx->Type == C4DefGraphics::TYPE_Mesh);
 			pComp->Value(mkNamingAdapt(C4DefGraphicsAdapt(pGfx), "ChildMesh"));
 			pComp->Value(mkParAdapt(mkNamingContextPtrAdapt(attach->Child, *pGfx->Mesh, "ChildInstance"), C4MeshDenumeratorFactory));
@@ -29,6 +29,7 @@
 #include "landscape/C4Particles.h"
 #include "landscape/C4SolidMask.h"
 #include "landscape/fow/C4FoW.h"
+#include "lib/C4Stat.h"
 #include "object/C4Command.h"
 #include "object/C4Def.h"
 #include "object/C4DefList.h"
@@ -94,6 +95,7 @@ void C4Object::Default()
 	Menu=nullptr;
 	MaterialContents=nullptr;
 	Marker=0;
+	ListOrder=0;
 	ColorMod=0xffffffff;
 	BlitMode=0;
 	CrewDisabled=false;
@@ -133,7 +135,7 @@ bool C4Object::Init(C4PropList *pDef, C4Object *pCreator,
 	if (pCreator) Layer=pCreator->Layer;
 
 	// graphics
-	pGraphics = &Def->Graphics;
+	pGraphics = &Def->GetGraphics();
 	if (pGraphics->Type == C4DefGraphics::TYPE_Mesh)
 	{
 		pMeshInstance = new StdMeshInstance(*pGraphics->Mesh, Def->GrowthType ? 1.0f : static_cast<float>(Con)/static_cast<float>(FullCon));
@@ -452,7 +454,11 @@ void C4Object::Execute()
 	// effects
 	if (pEffects)
 	{
+		// runs for every object, so too often to trace
+		static C4Stat EffectsStat("C4Object::Execute Effects", false);
+		C4ST_START(EffectsStat)
 		C4Effect::Execute(&pEffects);
+		C4ST_STOP(EffectsStat)
 		if (!Status) return;
 	}
 	// Life
@@ -538,7 +544,7 @@ bool C4Object::ChangeDef(C4ID idNew)
 	// new def: Needs to be resorted
 	Unsorted=true;
 	// graphics change
-	pGraphics = &pDef->Graphics;
+	pGraphics = &pDef->GetGraphics();
 	// blit mode adjustment
 	if (!(BlitMode & C4GFXBLIT_CUSTOM)) BlitMode = Def->BlitMode;
 	// an object may have newly become an ColorByOwner-object
@@ -915,7 +921,7 @@ void C4Object::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	pComp->Value(mkNamingAdapt( BlitMode,                         "BlitMode",           0u                ));
 	pComp->Value(mkNamingAdapt( CrewDisabled,                     "CrewDisabled",       false             ));
 	pComp->Value(mkNamingAdapt( Layer,                            "Layer",              C4ObjectPtr::Null ));
-	pComp->Value(mkNamingAdapt( C4DefGraphicsAdapt(pGraphics),    "Graphics",           &Def->Graphics    ));
+	pComp->Value(mkNamingAdapt( C4DefGraphicsAdapt(pGraphics),    "Graphics",           &Def->GetGraphics()));
 	pComp->Value(mkNamingPtrAdapt( pDrawTransform,                "DrawTransform"                         ));
 	pComp->Value(mkParAdapt(mkNamingPtrAdapt( pEffects,           "Effects"                               ), this, numbers));
 	pComp->Value(mkNamingAdapt( C4GraphicsOverlayListAdapt(pGfxOverlay),"GfxOverlay",   (C4GraphicsOverlay *)nullptr));
@@ -1118,6 +1124,15 @@ void C4Object::SyncClearance()
 	}
 }
 
+void C4Object::SetCategory(int32_t iCategory)
+{
+	int32_t iOldCategory = Category;
+	Category = iCategory;
+	::Objects.OnCategoryChanged(this, iOldCategory);
+	Resort();
+	SetOCF();
+}
+
 void C4Object::Resort()
 {
 	// Flag resort
@@ -1320,6 +1335,13 @@ void C4Object::SetPropertyByS(C4String * k, const C4Value & to)
 				if (!to.getInt()) throw C4AulExecError("invalid Plane 0");
 				SetPlane(to.getInt());
 				return;
+			case P_Prototype:
+			{
+				C4PropList *old_prototype = GetPrototype();
+				C4PropListNumbered::SetPropertyByS(k, to);
+				::Objects.OnPrototypeChanged(this, old_prototype);
+				return;
+			}
 		}
 	}
 	C4PropListNumbered::SetPropertyByS(k, to);
@@ -1334,6 +1356,13 @@ void C4Object::ResetProperty(C4String * k)
 			case P_Plane:
 				SetPlane(GetPropertyInt(P_Plane));
 				return;
+			case P_Prototype:
+			{
+				C4PropList *old_prototype = GetPrototype();
+				C4PropListNumbered::ResetProperty(k);
+				::Objects.OnPrototypeChanged(this, old_prototype);
+				return;
+			}
 		}
 	}
 	return C4PropListNumbered::ResetProperty(k);
@@ -131,6 +131,7 @@ public:
 	uint32_t t_contact; // SyncClearance-NoSave //
 	uint32_t OCF;
 	uint32_t Marker; // state var used by Objects::CrossCheck and C4FindObject - NoSave
+	uint64_t ListOrder; // position in the main object list, maintained by C4GameObjects - NoSave
 	C4ObjectPtr Layer;
 	C4DrawTransform *pDrawTransform; // assigned drawing transformation
 
@@ -253,7 +254,7 @@ public:
 	bool SetActionByName(C4String * ActName, C4Object *pTarget=nullptr, C4Object *pTarget2=nullptr, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	bool SetActionByName(const char * szActName, C4Object *pTarget=nullptr, C4Object *pTarget2=nullptr, int32_t iCalls = SAC_StartCall | SAC_AbortCall, bool fForce = false);
 	void SetDir(int32_t tdir);
-	void SetCategory(int32_t Category) { this->Category = Category; Resort(); SetOCF(); }
+	void SetCategory(int32_t Category);
 	int32_t GetProcedure() const;
 	bool Enter(C4Object *pTarget, bool fCalls=true, bool fCopyMotion=true, bool *pfRejectCollect=nullptr);
 	bool Exit(int32_t iX=0, int32_t iY=0, int32_t iR=0, C4Real iXDir=Fix0, C4Real iYDir=Fix0, C4Real iRDir=Fix0, bool fCalls=true);
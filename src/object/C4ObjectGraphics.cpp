@@ -812,7 +812,7 @@ bool C4Object::SetGraphics(const char *szGraphicsName, C4Def *pSourceDef)
 	// default def
 	if (!pSourceDef) pSourceDef = Def;
 	// get graphics
-	C4DefGraphics *pGrp = pSourceDef->Graphics.Get(szGraphicsName);
+	C4DefGraphics *pGrp = pSourceDef->GetGraphics().Get(szGraphicsName);
 	if (!pGrp) return false;
 	// set new graphics
 	pGraphics = pGrp;
@@ -1322,7 +1322,7 @@ static bool FnAddMenuItem(C4Object *Obj, C4String * szCaption, C4String * szComm
 		C4Def* pDef = C4Id2Def(C4ID(std::string(caption)));
 		if(pDef)
 		{
-			pGfx = &pDef->Graphics;
+			pGfx = &pDef->GetGraphics();
 		}
 		else
 		{
@@ -1783,7 +1783,7 @@ static bool FnSetGraphics(C4Object *Obj, C4String *pGfxName, C4Def *pSrcDef, lon
 			{
 				return Obj->RemoveGraphicsOverlay(iOverlayID);
 			}
-			pGrp = pSrcDef->Graphics.Get(FnStringPar(pGfxName));
+			pGrp = pSrcDef->GetGraphics().Get(FnStringPar(pGfxName));
 			if (!pGrp)
 			{
 				return false;
@@ -2430,7 +2430,7 @@ static Nillable<C4ValueArray*> FnGetAnimationList(C4PropList* _this, Nillable<in
 			throw NeedNonGlobalContext("GetAnimationList");
 		}
 		C4Def *def = _this->GetDef();
-		if (!def->Graphics.IsMesh())
+		if (!def->GetGraphics().IsMesh())
 		{
 			return C4Void();
 		}
@@ -2773,7 +2773,7 @@ static Nillable<int> FnAttachMesh(C4Object *Obj, C4PropList* Mesh, C4String * sz
 		{
 			return C4Void();
 		}
-		if (pDef->Graphics.Type != C4DefGraphics::TYPE_Mesh)
+		if (pDef->GetGraphics().Type != C4DefGraphics::TYPE_Mesh)
 		{
 			return C4Void();
 		}
@@ -2878,7 +2878,7 @@ static Nillable<C4ValueArray*> FnGetBoneNames(C4PropList * _this) {
 		}
 		// Called in definition context -> Use definition default mesh
 		C4Def *def = _this->GetDef();
-		if (!def->Graphics.IsMesh()) 
+		if (!def->GetGraphics().IsMesh()) 
 		{
 			return C4Void();
 		}
@@ -2911,7 +2911,7 @@ static Nillable<C4String*> FnGetMeshMaterial(C4PropList * _this, int iSubMesh)
 		}
 		// Called in definition context: Get definition default mesh material
 		C4Def *def = _this->GetDef();
-		if (!def->Graphics.IsMesh())
+		if (!def->GetGraphics().IsMesh())
 		{
 			return C4Void();
 		}
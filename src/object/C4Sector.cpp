@@ -22,6 +22,41 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 
+/* sector index */
+
+void C4LSectorIndex::Rebuild(const C4ObjectList &List)
+{
+	Objects.clear();
+	for (C4Object *obj : List)
+		Objects.push_back(obj);
+	fDirty = false;
+}
+
+void C4LSectorIndex::Added(const C4ObjectList &List, C4Object *pObj)
+{
+	if (fDirty) return;
+	// Searches iterating the copy must not see it change
+	if (iLocks) { fDirty = true; return; }
+	// Insert at the same position as in the list
+	size_t iPos = 0;
+	for (C4Object *obj : List)
+	{
+		if (obj == pObj) break;
+		++iPos;
+	}
+	if (iPos > Objects.size()) { fDirty = true; return; }
+	Objects.insert(Objects.begin() + iPos, pObj);
+}
+
+void C4LSectorIndex::Removed(C4Object *pObj)
+{
+	if (fDirty) return;
+	if (iLocks) { fDirty = true; return; }
+	auto it = std::find(Objects.begin(), Objects.end(), pObj);
+	if (it == Objects.end()) { fDirty = true; return; }
+	Objects.erase(it);
+}
+
 /* sector */
 
 void C4LSector::Init(int ix, int iy)
@@ -51,17 +86,46 @@ void C4LSector::ClearObjects()
 	// clear objects
 	Objects.Clear();
 	ObjectShapes.Clear();
+	ObjectsIndex.Invalidate();
+	ObjectShapesIndex.Invalidate();
+}
+
+void C4LSector::AddObject(C4Object *pObj, C4ObjectList *pMainList)
+{
+	if (Objects.Add(pObj, C4ObjectList::stMain, pMainList))
+		ObjectsIndex.Added(Objects, pObj);
+}
+
+bool C4LSector::RemoveObject(C4Object *pObj)
+{
+	if (!Objects.Remove(pObj)) return false;
+	ObjectsIndex.Removed(pObj);
+	return true;
+}
+
+void C4LSector::AddObjectShape(C4Object *pObj, C4ObjectList *pMainList)
+{
+	if (ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList))
+		ObjectShapesIndex.Added(ObjectShapes, pObj);
+}
+
+bool C4LSector::RemoveObjectShape(C4Object *pObj)
+{
+	if (!ObjectShapes.Remove(pObj)) return false;
+	ObjectShapesIndex.Removed(pObj);
+	return true;
 }
 
 /* sector map */
 
-void C4LSectors::Init(int iWdt, int iHgt)
+void C4LSectors::Init(int iWdt, int iHgt, int iSectorSize)
 {
 	// clear any previous initialization
 	Clear();
 	// store class members, calc size
-	Wdt = ((PxWdt=iWdt)-1)/C4LSectorWdt+1;
-	Hgt = ((PxHgt=iHgt)-1)/C4LSectorHgt+1;
+	SectorWdt = SectorHgt = std::max<int>(iSectorSize, C4LSectorMinSize);
+	Wdt = ((PxWdt=iWdt)-1)/SectorWdt+1;
+	Hgt = ((PxHgt=iHgt)-1)/SectorHgt+1;
 	// create sectors
 	Sectors = new C4LSector[Size=Wdt*Hgt];
 	// init sectors
@@ -85,7 +149,7 @@ C4LSector *C4LSectors::SectorAt(int ix, int iy)
 	if (ix<0 || iy<0 || ix>=PxWdt || iy>=PxHgt)
 		return &SectorOut;
 	// get sector
-	return Sectors+(iy/C4LSectorHgt)*Wdt+(ix/C4LSectorWdt);
+	return Sectors+(iy/SectorHgt)*Wdt+(ix/SectorWdt);
 }
 
 void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
@@ -93,14 +157,14 @@ void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
 	assert(Sectors);
 	// Add to owning sector
 	C4LSector *pSct = SectorAt(pObj->GetX(), pObj->GetY());
-	pSct->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+	pSct->AddObject(pObj, pMainList);
 	// Save position
 	pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
 	// Add to all sectors in shape area
 	pObj->Area.Set(this, pObj);
 	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
 	{
-		pSct->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+		pSct->AddObjectShape(pObj, pMainList);
 	}
 	if (Config.General.DebugRec)
 		pObj->Area.DebugRec(pObj, 'A');
@@ -123,8 +187,8 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 		pNew = SectorAt(pObj->GetX(), pObj->GetY());
 		if (pOld != pNew)
 		{
-			pOld->Objects.Remove(pObj);
-			pNew->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+			pOld->RemoveObject(pObj);
+			pNew->AddObject(pObj, pMainList);
 		}
 		// Save position
 		pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
@@ -135,12 +199,12 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 	// Remove from all old sectors in shape area
 	for (pOld = pObj->Area.First(); pOld; pOld = pObj->Area.Next(pOld))
 		if (!NewArea.Contains(pOld))
-			pOld->ObjectShapes.Remove(pObj);
+			pOld->RemoveObjectShape(pObj);
 	// Add to all new sectors in shape area
 	for (pNew = NewArea.First(); pNew; pNew = NewArea.Next(pNew))
 		if (!pObj->Area.Contains(pNew))
 		{
-			pNew->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
+			pNew->AddObjectShape(pObj, pMainList);
 		}
 	// Update area
 	pObj->Area = NewArea;
@@ -153,7 +217,7 @@ void C4LSectors::Remove(C4Object *pObj)
 	assert(Sectors); assert(pObj);
 	// Remove from owning sector
 	C4LSector *pSct = SectorAt(pObj->old_x, pObj->old_y);
-	if (!pSct->Objects.Remove(pObj))
+	if (!pSct->RemoveObject(pObj))
 	{
 #ifdef _DEBUG
 		LogF("WARNING: Object %d of type %s deleted but not found in pos sector list!", pObj->Number, pObj->id.ToString());
@@ -161,23 +225,23 @@ void C4LSectors::Remove(C4Object *pObj)
 		// if it was not found in owning sector, it must be somewhere else. yeah...
 		bool fFound = false;
 		for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-			if (pSct->Objects.Remove(pObj)) { fFound=true; break; }
+			if (pSct->RemoveObject(pObj)) { fFound=true; break; }
 		// yukh, somewhere else entirely...
 		if (!fFound)
 		{
-			fFound = !!SectorOut.Objects.Remove(pObj);
+			fFound = SectorOut.RemoveObject(pObj);
 			if (!fFound)
 			{
 				pSct = Sectors;
 				for (int cnt=0; cnt<Size; cnt++, pSct++)
-					if (pSct->Objects.Remove(pObj)) { fFound=true; break; }
+					if (pSct->RemoveObject(pObj)) { fFound=true; break; }
 			}
 			assert(fFound);
 		}
 	}
 	// Remove from all sectors in shape area
 	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-		pSct->ObjectShapes.Remove(pObj);
+		pSct->RemoveObjectShape(pObj);
 	if (Config.General.DebugRec)
 		pObj->Area.DebugRec(pObj, 'R');
 }
@@ -261,10 +325,10 @@ void C4LArea::Set(C4LSectors *pSectors, const C4Rect &Rect)
 	if (!ClippedRect.Wdt) ClippedRect.Wdt = 1;
 	if (!ClippedRect.Hgt) ClippedRect.Hgt = 1;
 	// calc bounds
-	xL = (ClippedRect.x + ClippedRect.Wdt - 1) / C4LSectorWdt;
-	yL = (ClippedRect.y + ClippedRect.Hgt - 1) / C4LSectorHgt;
+	xL = (ClippedRect.x + ClippedRect.Wdt - 1) / pSectors->SectorWdt;
+	yL = (ClippedRect.y + ClippedRect.Hgt - 1) / pSectors->SectorHgt;
 	// calc pitch
-	dpitch = pSectors->Wdt - (ClippedRect.x + ClippedRect.Wdt - 1) / C4LSectorWdt + ClippedRect.x / C4LSectorWdt;
+	dpitch = pSectors->Wdt - (ClippedRect.x + ClippedRect.Wdt - 1) / pSectors->SectorWdt + ClippedRect.x / pSectors->SectorWdt;
 }
 
 void C4LArea::Set(C4LSectors *pSectors, C4Object *pObj)
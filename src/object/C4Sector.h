@@ -28,8 +28,49 @@ class C4LSectors;
 class C4LArea;
 
 // constants
-const int32_t C4LSectorWdt = 50,
-                             C4LSectorHgt = 50;
+const int32_t C4LSectorDefaultSize = 50, // default sector edge length; scenarios may override it
+              C4LSectorMinSize = 10;
+
+// flat copy of a sector object list for fast iteration in area searches
+// kept in sync with single changes of the list, rebuilt lazily after anything else
+class C4LSectorIndex
+{
+private:
+	std::vector<C4Object *> Objects;
+	bool fDirty{true};
+	int32_t iLocks{0}; // number of searches currently iterating Objects
+
+	void Rebuild(const C4ObjectList &List);
+
+	struct Lock
+	{
+		C4LSectorIndex &Index;
+		Lock(C4LSectorIndex &Index) : Index(Index) { ++Index.iLocks; }
+		~Lock() { --Index.iLocks; }
+	};
+
+public:
+	void Invalidate() { fDirty = true; }
+	void Added(const C4ObjectList &List, C4Object *pObj); // call after pObj was added to List
+	void Removed(C4Object *pObj); // call after pObj was removed from the list
+
+	// Calls fn for every object of List until it returns false. Returns false if stopped.
+	// Uses the flat copy unless it is outdated while a nested search is still using it.
+	template<typename Fn> bool ForEach(const C4ObjectList &List, Fn fn)
+	{
+		if (fDirty && !iLocks) Rebuild(List);
+		if (fDirty)
+		{
+			for (C4Object *obj : List)
+				if (!fn(obj)) return false;
+			return true;
+		}
+		Lock lock(*this);
+		for (C4Object *obj : Objects)
+			if (!fn(obj)) return false;
+		return true;
+	}
+};
 
 // one of those object list sectors
 class C4LSector
@@ -47,6 +88,16 @@ public:
 
 	C4ObjectList Objects; // objects within this sector
 	C4ObjectList ObjectShapes; // objects with shapes that overlap this sector
+	C4LSectorIndex ObjectsIndex, ObjectShapesIndex; // flat copies of the lists above
+
+	// list manipulation that keeps the flat copies in sync
+	void AddObject(C4Object *pObj, C4ObjectList *pMainList);
+	bool RemoveObject(C4Object *pObj);
+	void AddObjectShape(C4Object *pObj, C4ObjectList *pMainList);
+	bool RemoveObjectShape(C4Object *pObj);
+
+	template<typename Fn> bool ForEachObject(Fn fn) { return ObjectsIndex.ForEach(Objects, fn); }
+	template<typename Fn> bool ForEachObjectShape(Fn fn) { return ObjectShapesIndex.ForEach(ObjectShapes, fn); }
 
 	void CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers);
 	void ClearObjects(); // remove all objects from object lists
@@ -61,11 +112,12 @@ public:
 	C4LSector *Sectors; // mem holding the sector array
 	int PxWdt, PxHgt; // size in px
 	int Wdt, Hgt, Size; // sector count
+	int SectorWdt{C4LSectorDefaultSize}, SectorHgt{C4LSectorDefaultSize}; // size of one sector in px
 
 	C4LSector SectorOut; // the sector "outside"
 
 public:
-	void Init(int Wdt, int Hgt); // init map sectors
+	void Init(int Wdt, int Hgt, int iSectorSize = C4LSectorDefaultSize); // init map sectors
 	void Clear(); // free map sectors
 	C4LSector *SectorAt(int ix, int iy); // get sector at pos
 
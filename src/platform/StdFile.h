@@ -56,6 +56,7 @@ bool GetParentPath(const char *szFilename, char *szBuffer);
 bool GetParentPath(const char *szFilename, StdStrBuf *outBuf);
 const char *GetRelativePathS(const char *strPath, const char *strRelativeTo);
 bool IsGlobalPath(const char *szPath);
+void RealPath(const char *szFilename, char *pFullFilename); // pFullFilename has to be of at least _MAX_PATH length
 
 bool DirectoryExists(const char *szFileName);
 bool FileExists(const char *szFileName);
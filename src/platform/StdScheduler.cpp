@@ -64,6 +64,9 @@ StdScheduler::StdScheduler()
 StdScheduler::~StdScheduler()
 {
 	Clear();
+#ifdef HAVE_SYS_EPOLL_H
+	ClearEpoll();
+#endif
 }
 
 void StdScheduler::Clear()
@@ -152,6 +155,15 @@ void StdScheduler::UnBlock()
 	Unblocker.Notify();
 }
 
+void StdScheduler::SetUseEpoll(bool fUse)
+{
+#ifdef HAVE_SYS_EPOLL_H
+	fUseEpoll = fUse;
+	// switch backend with the next ScheduleProcs
+	UnBlock();
+#endif
+}
+
 // *** StdSchedulerThread
 
 StdSchedulerThread::StdSchedulerThread() = default;
@@ -33,6 +33,9 @@ struct pollfd;
 #else // _WIN32
 #ifdef HAVE_POLL_H
 #include <poll.h>
+#ifdef HAVE_SYS_EPOLL_H
+#include <atomic>
+#endif // HAVE_SYS_EPOLL_H
 #else // HAVE_POLL_H
 #include <sys/select.h>
 #endif // HAVE_POLL_H
@@ -70,6 +73,9 @@ public:
 	virtual HANDLE GetEvent() { return nullptr; }
 #else
 	virtual void GetFDs(std::vector<struct pollfd> &) { }
+	// Whether the FDs only change when Changed() is called (or when Execute() runs) and Execute() handles
+	// all pending IO on them, so they can stay registered edge-triggered instead of being polled every time
+	virtual bool HasPersistentFDs() { return false; }
 #endif
 
 	// Call Execute() after this time has elapsed
@@ -241,6 +247,23 @@ private:
 	std::vector<StdSchedulerProc*> eventProcs;
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+	// epoll backend: procs with persistent FDs stay registered in an epoll set,
+	// which is polled together with the FDs of all other procs
+	std::atomic<bool> fUseEpoll{false};
+	int iEpollFD{-1};
+	std::map<StdSchedulerProc *, std::vector<struct pollfd> > EpollFDs; // registered FDs by proc
+	std::unordered_map<int, StdSchedulerProc *> EpollFDProcs; // proc by registered FD
+	std::vector<StdSchedulerProc *> EpollChanged; // procs whose FDs have to be registered again
+	CStdCSec EpollCSec; // protects EpollChanged
+
+	bool UpdateEpoll();
+	void ClearEpoll();
+	void RegisterEpollFDs(StdSchedulerProc *pProc, std::vector<struct pollfd> &fds, bool fRenew);
+	void UnregisterEpollFDs(StdSchedulerProc *pProc);
+	void GetEpollEvents(std::map<StdSchedulerProc *, std::vector<struct pollfd> > &ready);
+#endif
+
 public:
 	int getProcCnt() const { return procs.size()-1; } // ignore internal NoopNotifyProc
 	bool hasProc(StdSchedulerProc *pProc) { return std::find(procs.begin(), procs.end(), pProc) != procs.end(); }
@@ -263,6 +286,9 @@ public:
 	bool ScheduleProcs(int iTimeout = 1000/36);
 	void UnBlock();
 
+	// wait for procs with persistent FDs using epoll where available (takes effect with the next ScheduleProcs)
+	void SetUseEpoll(bool fUse);
+
 protected:
 	// overridable
 	virtual void OnError(StdSchedulerProc *) { }
@@ -24,6 +24,9 @@
 #ifdef HAVE_SHARE_H
 #include <share.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 
 // Is this process currently signaled?
 bool StdSchedulerProc::IsSignaled()
@@ -110,15 +113,193 @@ void CStdNotifyProc::GetFDs(std::vector<struct pollfd> & checkfds)
 	checkfds.push_back(pfd);
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+namespace
+{
+	uint32_t PollToEpollEvents(short events)
+	{
+		uint32_t r = 0;
+		if (events & POLLIN) r |= EPOLLIN;
+		if (events & POLLOUT) r |= EPOLLOUT;
+		return r;
+	}
+	short EpollToPollEvents(uint32_t events)
+	{
+		short r = 0;
+		if (events & EPOLLIN) r |= POLLIN;
+		if (events & EPOLLOUT) r |= POLLOUT;
+		if (events & EPOLLERR) r |= POLLERR;
+		if (events & EPOLLHUP) r |= POLLHUP;
+		return r;
+	}
+}
+
+// Create or drop the epoll set as selected and register the FDs of changed procs.
+// Returns whether procs with persistent FDs are waited for by the epoll set.
+bool StdScheduler::UpdateEpoll()
+{
+	if (!fUseEpoll)
+	{
+		ClearEpoll();
+		return false;
+	}
+	std::vector<StdSchedulerProc *> changed;
+	if (iEpollFD == -1)
+	{
+		iEpollFD = epoll_create1(EPOLL_CLOEXEC);
+		if (iEpollFD == -1)
+		{
+			Fail("epoll_create1 failed");
+			fUseEpoll = false;
+			return false;
+		}
+		// register everything
+		CStdLock EpollLock(&EpollCSec);
+		EpollChanged.clear();
+		for (auto proc : procs)
+			if (proc->HasPersistentFDs())
+				changed.push_back(proc);
+	}
+	else
+	{
+		CStdLock EpollLock(&EpollCSec);
+		changed.swap(EpollChanged);
+	}
+	for (auto proc : changed)
+	{
+		std::vector<struct pollfd> fds;
+		proc->GetFDs(fds);
+		// FD numbers might have been reused since the last registration, so renew all of them
+		RegisterEpollFDs(proc, fds, true);
+	}
+	return true;
+}
+
+void StdScheduler::ClearEpoll()
+{
+	if (iEpollFD == -1) return;
+	close(iEpollFD);
+	iEpollFD = -1;
+	EpollFDs.clear();
+	EpollFDProcs.clear();
+}
+
+void StdScheduler::RegisterEpollFDs(StdSchedulerProc *pProc, std::vector<struct pollfd> &fds, bool fRenew)
+{
+	std::vector<struct pollfd> &registered = EpollFDs[pProc];
+	std::unordered_map<int, short> old_events, new_events;
+	for (auto &pfd : registered)
+		old_events[pfd.fd] |= pfd.events;
+	for (auto &pfd : fds)
+		new_events[pfd.fd] |= pfd.events;
+	// remove FDs that are gone, unless they belong to another proc by now
+	for (auto &old : old_events)
+		if (!new_events.count(old.first))
+		{
+			auto owner = EpollFDProcs.find(old.first);
+			if (owner == EpollFDProcs.end() || owner->second != pProc)
+				continue;
+			// (fails for closed FDs, which epoll has removed already)
+			epoll_ctl(iEpollFD, EPOLL_CTL_DEL, old.first, nullptr);
+			EpollFDProcs.erase(owner);
+		}
+	// add new FDs and update changed ones
+	for (auto &cur : new_events)
+	{
+		auto old = old_events.find(cur.first);
+		if (!fRenew && old != old_events.end() && old->second == cur.second)
+			continue;
+		epoll_event ev = {};
+		ev.events = PollToEpollEvents(cur.second) | EPOLLET;
+		ev.data.fd = cur.first;
+		if (epoll_ctl(iEpollFD, EPOLL_CTL_MOD, cur.first, &ev) == -1 && errno == ENOENT)
+			epoll_ctl(iEpollFD, EPOLL_CTL_ADD, cur.first, &ev);
+		EpollFDProcs[cur.first] = pProc;
+	}
+	registered = fds;
+}
+
+void StdScheduler::UnregisterEpollFDs(StdSchedulerProc *pProc)
+{
+	auto registered = EpollFDs.find(pProc);
+	if (registered == EpollFDs.end()) return;
+	for (auto &pfd : registered->second)
+	{
+		auto owner = EpollFDProcs.find(pfd.fd);
+		if (owner == EpollFDProcs.end() || owner->second != pProc)
+			continue;
+		epoll_ctl(iEpollFD, EPOLL_CTL_DEL, pfd.fd, nullptr);
+		EpollFDProcs.erase(owner);
+	}
+	EpollFDs.erase(registered);
+}
+
+// Get the procs that have events in the epoll set, along with their current FDs (in the order
+// Execute() expects them) and the events as poll would have reported them
+void StdScheduler::GetEpollEvents(std::map<StdSchedulerProc *, std::vector<struct pollfd> > &ready)
+{
+	const int iMaxEvents = 64;
+	epoll_event events[iMaxEvents];
+	std::unordered_map<int, short> revents;
+	int cnt;
+	do
+	{
+		cnt = epoll_wait(iEpollFD, events, iMaxEvents, 0);
+		for (int i = 0; i < cnt; ++i)
+		{
+			auto owner = EpollFDProcs.find(events[i].data.fd);
+			if (owner == EpollFDProcs.end())
+				continue;
+			revents[events[i].data.fd] |= EpollToPollEvents(events[i].events);
+			ready[owner->second];
+		}
+	}
+	while (cnt == iMaxEvents);
+	for (auto it = ready.begin(); it != ready.end(); )
+	{
+		std::vector<struct pollfd> &fds = it->second;
+		it->first->GetFDs(fds);
+		if (fds.empty())
+		{
+			it = ready.erase(it);
+			continue;
+		}
+		// pick up changes that weren't announced by Changed(), like sockets waiting to send data
+		RegisterEpollFDs(it->first, fds, false);
+		for (auto &pfd : fds)
+		{
+			auto rev = revents.find(pfd.fd);
+			if (rev != revents.end())
+				pfd.revents = rev->second & (pfd.events | POLLERR | POLLHUP);
+		}
+		++it;
+	}
+}
+#endif // HAVE_SYS_EPOLL_H
+
 bool StdScheduler::DoScheduleProcs(int iTimeout)
 {
 	// Initialize file descriptor sets
 	std::vector<struct pollfd> fds;
 	std::map<StdSchedulerProc *, std::pair<unsigned int, unsigned int> > fds_for_proc;
 
+#ifdef HAVE_SYS_EPOLL_H
+	// Procs with persistent FDs are waited for by the epoll set
+	bool fEpoll = UpdateEpoll();
+	if (fEpoll)
+	{
+		pollfd pfd = { iEpollFD, POLLIN, 0 };
+		fds.push_back(pfd);
+	}
+#endif
+
 	// Collect file descriptors
 	for (auto proc : procs)
 	{
+#ifdef HAVE_SYS_EPOLL_H
+		if (fEpoll && proc->HasPersistentFDs())
+			continue;
+#endif
 		unsigned int os = fds.size();
 		proc->GetFDs(fds);
 		if (os != fds.size())
@@ -132,12 +313,32 @@ bool StdScheduler::DoScheduleProcs(int iTimeout)
 
 	if (cnt >= 0)
 	{
+#ifdef HAVE_SYS_EPOLL_H
+		std::map<StdSchedulerProc *, std::vector<struct pollfd> > epoll_ready;
+		if (fEpoll && (fds[0].revents & POLLIN))
+			GetEpollEvents(epoll_ready);
+#endif
 		bool any_executed = false;
 		auto tNow = C4TimeMilliseconds::Now();
 		// Which process?
 		for (size_t i = 0; i < procs.size(); i++)
 		{
 			auto proc = procs[i];
+#ifdef HAVE_SYS_EPOLL_H
+			// Edge-triggered events are reported only once, so they must not be skipped
+			auto ready = epoll_ready.find(proc);
+			if (ready != epoll_ready.end())
+			{
+				if (!proc->Execute(0, &ready->second[0]))
+				{
+					OnError(proc);
+					fSuccess = false;
+				}
+				any_executed = true;
+				epoll_ready.erase(ready);
+				continue;
+			}
+#endif
 			auto tProcTick = proc->GetNextTick(tNow);
 			if (tProcTick <= tNow)
 			{
@@ -232,9 +433,34 @@ void CStdMultimediaTimerProc::GetFDs(std::vector<struct pollfd> & checkfds)
 #endif // HAVE_SYS_TIMERFD_H
 
 #if !defined(USE_COCOA)
+#ifdef HAVE_SYS_EPOLL_H
+void StdScheduler::Added(StdSchedulerProc *pProc)
+{
+	// register with the epoll set
+	Changed(pProc);
+}
+void StdScheduler::Removing(StdSchedulerProc *pProc)
+{
+	CStdLock EpollLock(&EpollCSec);
+	EpollChanged.erase(std::remove(EpollChanged.begin(), EpollChanged.end(), pProc), EpollChanged.end());
+	EpollLock.Clear();
+	UnregisterEpollFDs(pProc);
+}
+void StdScheduler::Changed(StdSchedulerProc* pProc)
+{
+	// (may be called by any thread: register again with the next ScheduleProcs)
+	if (!pProc->HasPersistentFDs()) return;
+	CStdLock EpollLock(&EpollCSec);
+	if (std::find(EpollChanged.begin(), EpollChanged.end(), pProc) == EpollChanged.end())
+		EpollChanged.push_back(pProc);
+	EpollLock.Clear();
+	if (fUseEpoll) UnBlock();
+}
+#else
 void StdScheduler::Added(StdSchedulerProc *pProc) {}
 void StdScheduler::Removing(StdSchedulerProc *pProc) {}
 void StdScheduler::Changed(StdSchedulerProc* pProc) {}
+#endif
 void StdScheduler::StartOnCurrentThread() {}
 #endif
 #endif // HAVE_POLL_H
@@ -1776,6 +1776,7 @@ void C4Player::HostilitySet::CompileFunc(StdCompiler *pComp)
 		while (entries--)
 		{
 			int number;
+			pComp->Separator();
 			pComp->Value(number);
 			assert(::Players.Valid(number));
 			C4Player *plr = ::Players.Get(number);
@@ -1789,6 +1790,7 @@ void C4Player::HostilitySet::CompileFunc(StdCompiler *pComp)
 		for (auto it : *this)
 		{
 			int32_t num = it->Number;
+			pComp->Separator();
 			pComp->Value(num); // Can't use (*it)->Number directly because StdCompiler is dumb about constness
 		}
 	}
@@ -127,9 +127,15 @@ protected:
 
 	C4AulErrorHandler *ErrorHandler;
 
+	// scripts loaded since the last preparse, in load order
+	std::vector<C4ScriptHost *> PendingPreparse;
+	void AddPendingPreparse(C4ScriptHost *pScript);
+	void RemovePendingPreparse(C4ScriptHost *pScript);
+
 public:
 	int warnCnt{0}, errCnt{0}; // number of warnings/errors
 	int lineCnt{0}; // line count parsed
+	bool fDumpByteCode{false}; // print the byte code of every compiled function to stderr
 
 	C4ValueMapNames GlobalNamedNames;
 	C4ValueMapData GlobalNamed;
@@ -146,6 +152,7 @@ public:
 	C4AulScriptEngine(); // constructor
 	~C4AulScriptEngine() override; // destructor
 	void Clear(); // clear data
+	void PreparseScripts(); // preparse newly loaded scripts, done by Link
 	void Link(C4DefList *rDefs); // link and parse all scripts
 	void ReLink(C4DefList *rDefs); // unlink, link and parse all scripts
 	C4PropListStatic * GetPropList() { return this; }
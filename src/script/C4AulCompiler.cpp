@@ -767,6 +767,9 @@ int C4AulCompiler::CodegenAstVisitor::GetStackValue(C4AulBCCType eType, intptr_t
 	case AB_EOFN:
 	case AB_JUMP:
 	case AB_DEBUG:
+	case AB_CMPJUMP_LOCALN_INT:
+	case AB_CMPJUMP_DUP_INT:
+	case AB_CMPJUMP_DUP_DUP:
 		return 0;
 
 	case AB_STACK:
@@ -1626,11 +1629,15 @@ void C4AulCompiler::CodegenAstVisitor::EmitFunctionCode(const ::aul::ast::Functi
 		AddBCC(n->loc, AB_NIL);
 		AddBCC(n->loc, AB_RETURN);
 	}
-	Fn->DumpByteCode();
 	// This instruction should never be reached but we'll add it just in
 	// case.
 	AddBCC(n->loc, AB_EOFN);
 	assert(stack_height == 0);
+	Fn->DumpByteCode("unoptimized");
+	Fn->OptimizeCode();
+	Fn->DumpByteCode("optimized");
+	Fn->FuseSuperInstructions();
+	Fn->AddLookupCaches();
 }
 
 void C4AulCompiler::CodegenAstVisitor::visit(const ::aul::ast::DoLoop *n)
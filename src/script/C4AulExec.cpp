@@ -18,6 +18,7 @@
 #include "C4Include.h"
 #include "script/C4AulExec.h"
 
+#include "c4group/CStdFile.h"
 #include "control/C4Record.h"
 #include "object/C4Def.h"
 #include "object/C4Object.h"
@@ -26,6 +27,11 @@
 #include "script/C4AulDebug.h"
 #include "script/C4ScriptHost.h"
 
+// Threaded dispatch jumps from each instruction handler directly to the next one using labels as values
+#if defined(__GNUC__) && !defined(C4AUL_NO_THREADED_DISPATCH)
+#define C4AUL_THREADED_DISPATCH
+#endif
+
 C4AulExec AulExec;
 
 C4AulExecError::C4AulExecError(const char *szError)
@@ -156,7 +162,6 @@ C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value *pnPars
 
 		// Push a new context
 		C4AulScriptContext ctx;
-		ctx.tTime = 0;
 		ctx.Obj = p;
 		ctx.Return = nullptr;
 		ctx.Pars = pPars;
@@ -190,622 +195,730 @@ C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value *pnPars
 	return C4VNull;
 }
 
+// Instruction handlers: AUL_NEXT continues with the following instruction, AUL_JUMP with the one at pCPos
+#ifdef C4AUL_THREADED_DISPATCH
+#define AUL_OP(op) case op: op_##op
+#define AUL_NEXT goto *DispatchTable[(++pCPos)->bccType]
+#define AUL_JUMP goto *DispatchTable[pCPos->bccType]
+#else
+#define AUL_OP(op) case op
+#define AUL_NEXT do { ++pCPos; goto dispatch; } while (0)
+#define AUL_JUMP goto dispatch
+#endif
+
 C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 {
 	try
 	{
+#ifdef C4AUL_THREADED_DISPATCH
+		// Handler of each instruction type; types without an own handler go through the switch
+		static void *DispatchTable[AB_EOFN + 1];
+		static bool fDispatchTableReady = false;
+		if (!fDispatchTableReady)
+		{
+			for (auto &pHandler : DispatchTable)
+				pHandler = &&dispatch;
+#define AUL_REGISTER(op) DispatchTable[op] = &&op_##op
+			AUL_REGISTER(AB_INT);
+			AUL_REGISTER(AB_BOOL);
+			AUL_REGISTER(AB_STRING);
+			AUL_REGISTER(AB_CPROPLIST);
+			AUL_REGISTER(AB_CARRAY);
+			AUL_REGISTER(AB_CFUNCTION);
+			AUL_REGISTER(AB_NIL);
+			AUL_REGISTER(AB_DUP);
+			AUL_REGISTER(AB_STACK_SET);
+			AUL_REGISTER(AB_POP_TO);
+			AUL_REGISTER(AB_EOFN);
+			AUL_REGISTER(AB_ERR);
+			AUL_REGISTER(AB_DUP_CONTEXT);
+			AUL_REGISTER(AB_LOCALN);
+			AUL_REGISTER(AB_LOCALN_SET);
+			AUL_REGISTER(AB_PROP);
+			AUL_REGISTER(AB_PROP_SET);
+			AUL_REGISTER(AB_GLOBALN);
+			AUL_REGISTER(AB_GLOBALN_SET);
+			AUL_REGISTER(AB_BitNot);
+			AUL_REGISTER(AB_Not);
+			AUL_REGISTER(AB_Neg);
+			AUL_REGISTER(AB_Inc);
+			AUL_REGISTER(AB_Dec);
+			AUL_REGISTER(AB_Pow);
+			AUL_REGISTER(AB_Div);
+			AUL_REGISTER(AB_Mul);
+			AUL_REGISTER(AB_Mod);
+			AUL_REGISTER(AB_Sub);
+			AUL_REGISTER(AB_Sum);
+			AUL_REGISTER(AB_LeftShift);
+			AUL_REGISTER(AB_RightShift);
+			AUL_REGISTER(AB_LessThan);
+			AUL_REGISTER(AB_LessThanEqual);
+			AUL_REGISTER(AB_GreaterThan);
+			AUL_REGISTER(AB_GreaterThanEqual);
+			AUL_REGISTER(AB_Equal);
+			AUL_REGISTER(AB_NotEqual);
+			AUL_REGISTER(AB_BitAnd);
+			AUL_REGISTER(AB_BitXOr);
+			AUL_REGISTER(AB_BitOr);
+			AUL_REGISTER(AB_NEW_ARRAY);
+			AUL_REGISTER(AB_NEW_PROPLIST);
+			AUL_REGISTER(AB_ARRAYA);
+			AUL_REGISTER(AB_ARRAYA_SET);
+			AUL_REGISTER(AB_ARRAY_SLICE);
+			AUL_REGISTER(AB_ARRAY_SLICE_SET);
+			AUL_REGISTER(AB_STACK);
+			AUL_REGISTER(AB_JUMP);
+			AUL_REGISTER(AB_JUMPAND);
+			AUL_REGISTER(AB_JUMPOR);
+			AUL_REGISTER(AB_JUMPNNIL);
+			AUL_REGISTER(AB_CONDN);
+			AUL_REGISTER(AB_COND);
+			AUL_REGISTER(AB_CMPJUMP_LOCALN_INT);
+			AUL_REGISTER(AB_CMPJUMP_DUP_INT);
+			AUL_REGISTER(AB_CMPJUMP_DUP_DUP);
+			AUL_REGISTER(AB_RETURN);
+			AUL_REGISTER(AB_FUNC);
+			AUL_REGISTER(AB_PAR);
+			AUL_REGISTER(AB_THIS);
+			AUL_REGISTER(AB_FOREACH_NEXT);
+			AUL_REGISTER(AB_CALL);
+			AUL_REGISTER(AB_CALLFS);
+			AUL_REGISTER(AB_DEBUG);
+#undef AUL_REGISTER
+			fDispatchTableReady = true;
+		}
+#endif
 
-		for (;;)
+dispatch:
+		switch (pCPos->bccType)
+		{
+		AUL_OP(AB_INT):
+			PushInt(pCPos->Par.i);
+			AUL_NEXT;
+
+		AUL_OP(AB_BOOL):
+			PushBool(!!pCPos->Par.i);
+			AUL_NEXT;
+
+		AUL_OP(AB_STRING):
+			PushString(pCPos->Par.s);
+			AUL_NEXT;
+
+		AUL_OP(AB_CPROPLIST):
+			PushPropList(pCPos->Par.p);
+			AUL_NEXT;
+
+		AUL_OP(AB_CARRAY):
+			PushArray(pCPos->Par.a);
+			AUL_NEXT;
+
+		AUL_OP(AB_CFUNCTION):
+			PushFunction(pCPos->Par.f);
+			AUL_NEXT;
+
+		AUL_OP(AB_NIL):
+			PushValue(C4VNull);
+			AUL_NEXT;
+
+		AUL_OP(AB_DUP):
+			PushValue(pCurVal[pCPos->Par.i]);
+			AUL_NEXT;
+		AUL_OP(AB_STACK_SET):
+			pCurVal[pCPos->Par.i] = pCurVal[0];
+			AUL_NEXT;
+		AUL_OP(AB_POP_TO):
+			pCurVal[pCPos->Par.i] = pCurVal[0];
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_EOFN):
+			throw C4AulExecError("internal error: function didn't return");
+
+		AUL_OP(AB_ERR):
+			if (pCPos->Par.s)
+				throw C4AulExecError((std::string("syntax error: ") + pCPos->Par.s->GetCStr()).c_str());
+			else
+				throw C4AulExecError("syntax error: see above for details");
+
+		AUL_OP(AB_DUP_CONTEXT):
+			PushValue(AulExec.GetContext(AulExec.GetContextDepth()-2)->Pars[pCPos->Par.i]);
+			AUL_NEXT;
+
+		AUL_OP(AB_LOCALN):
+			if (!pCurCtx->Obj)
+				throw C4AulExecError("can't access local variables without this");
+			PushNullVals(1);
+			GetPropertyCached(pCurCtx->Obj, pCPos, pCurVal);
+			AUL_NEXT;
+		AUL_OP(AB_LOCALN_SET):
+			if (!pCurCtx->Obj)
+				throw C4AulExecError("can't access local variables without this");
+			if (pCurCtx->Obj->IsFrozen())
+				throw C4AulExecError("local variable: this is readonly");
+			pCurCtx->Obj->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
+			AUL_NEXT;
+
+		AUL_OP(AB_PROP):
+			if (!pCurVal->CheckConversion(C4V_PropList))
+				throw C4AulExecError(FormatString("proplist access: proplist expected, got %s", pCurVal->GetTypeName()).getData());
+			if (!GetPropertyCached(pCurVal->_getPropList(), pCPos, pCurVal))
+				pCurVal->Set0();
+			AUL_NEXT;
+		AUL_OP(AB_PROP_SET):
 		{
+			C4Value *pPropList = pCurVal - 1;
+			if (!pPropList->CheckConversion(C4V_PropList))
+				throw C4AulExecError(FormatString("proplist write: proplist expected, got %s", pPropList->GetTypeName()).getData());
+			if (pPropList->_getPropList()->IsFrozen())
+				throw C4AulExecError("proplist write: proplist is readonly");
+			pPropList->_getPropList()->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
+			pPropList->Set(pCurVal[0]);
+			PopValue();
+			AUL_NEXT;
+		}
 
-			bool fJump = false;
-			switch (pCPos->bccType)
-			{
-			case AB_INT:
-				PushInt(pCPos->Par.i);
-				break;
-
-			case AB_BOOL:
-				PushBool(!!pCPos->Par.i);
-				break;
-
-			case AB_STRING:
-				PushString(pCPos->Par.s);
-				break;
-
-			case AB_CPROPLIST:
-				PushPropList(pCPos->Par.p);
-				break;
-
-			case AB_CARRAY:
-				PushArray(pCPos->Par.a);
-				break;
-
-			case AB_CFUNCTION:
-				PushFunction(pCPos->Par.f);
-				break;
-
-			case AB_NIL:
-				PushValue(C4VNull);
-				break;
-
-			case AB_DUP:
-				PushValue(pCurVal[pCPos->Par.i]);
-				break;
-			case AB_STACK_SET:
-				pCurVal[pCPos->Par.i] = pCurVal[0];
-				break;
-			case AB_POP_TO:
-				pCurVal[pCPos->Par.i] = pCurVal[0];
-				PopValue();
-				break;
+		AUL_OP(AB_GLOBALN):
+			PushValue(*::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i));
+			AUL_NEXT;
+		AUL_OP(AB_GLOBALN_SET):
+			::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i)->Set(pCurVal[0]);
+			AUL_NEXT;
+			
+		// prefix
+		AUL_OP(AB_BitNot): // ~
+			CheckOpPar(C4V_Int, "~");
+			pCurVal->SetInt(~pCurVal->_getInt());
+			AUL_NEXT;
+		AUL_OP(AB_Not):  // !
+			pCurVal->SetBool(!pCurVal->getBool());
+			AUL_NEXT;
+		AUL_OP(AB_Neg):  // -
+			CheckOpPar(C4V_Int, "-");
+			pCurVal->SetInt(-pCurVal->_getInt());
+			AUL_NEXT;
+		AUL_OP(AB_Inc): // ++
+			CheckOpPar(C4V_Int, "++");
+			pCurVal->SetInt(pCurVal->_getInt() + 1);
+			AUL_NEXT;
+		AUL_OP(AB_Dec): // --
+			CheckOpPar(C4V_Int, "--");
+			pCurVal->SetInt(pCurVal->_getInt() - 1);
+			AUL_NEXT;
+		// postfix
+		AUL_OP(AB_Pow):  // **
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "**");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(Pow(pPar1->_getInt(), pPar2->_getInt()));
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Div):  // /
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "/");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			if (!pPar2->_getInt())
+				throw C4AulExecError("division by zero");
+			// INT_MIN/-1 cannot be represented in an int and would cause an uncaught exception
+			if (pPar1->_getInt()==INT32_MIN && pPar2->_getInt()==-1)
+				throw C4AulExecError("division overflow");
+			pPar1->SetInt(pPar1->_getInt() / pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Mul):  // *
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "*");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() * pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Mod):  // %
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "%");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			// INT_MIN%-1 cannot be represented in an int and would cause an uncaught exception
+			if (pPar1->_getInt()==INT32_MIN && pPar2->_getInt()==-1)
+				throw C4AulExecError("modulo division overflow");
+			if (pPar2->_getInt())
+				pPar1->SetInt(pPar1->_getInt() % pPar2->_getInt());
+			else
+				pPar1->Set0();
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Sub):  // -
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "-");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() - pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Sum):  // +
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "+");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() + pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_LeftShift):  // <<
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "<<");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() << pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_RightShift): // >>
+		{
+			CheckOpPars(C4V_Int, C4V_Int, ">>");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() >> pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_LessThan): // <
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "<");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(pPar1->_getInt() < pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_LessThanEqual):  // <=
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "<=");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(pPar1->_getInt() <= pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_GreaterThan):  // >
+		{
+			CheckOpPars(C4V_Int, C4V_Int, ">");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(pPar1->_getInt() > pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_GreaterThanEqual): // >=
+		{
+			CheckOpPars(C4V_Int, C4V_Int, ">=");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(pPar1->_getInt() >= pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_Equal):  // ==
+		{
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(pPar1->IsIdenticalTo(*pPar2));
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_NotEqual): // !=
+		{
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetBool(!pPar1->IsIdenticalTo(*pPar2));
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_BitAnd): // &
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "&");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() & pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_BitXOr): // ^
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "^");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() ^ pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_BitOr):  // |
+		{
+			CheckOpPars(C4V_Int, C4V_Int, "|");
+			C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
+			pPar1->SetInt(pPar1->_getInt() | pPar2->_getInt());
+			PopValue();
+			AUL_NEXT;
+		}
 
-			case AB_EOFN:
-				throw C4AulExecError("internal error: function didn't return");
+		AUL_OP(AB_NEW_ARRAY):
+		{
+			// Create array
+			C4ValueArray *pArray = new C4ValueArray(pCPos->Par.i);
 
-			case AB_ERR:
-				if (pCPos->Par.s)
-					throw C4AulExecError((std::string("syntax error: ") + pCPos->Par.s->GetCStr()).c_str());
-				else
-					throw C4AulExecError("syntax error: see above for details");
+			// Pop values from stack
+			for (int i = 0; i < pCPos->Par.i; i++)
+				(*pArray)[i] = pCurVal[i - pCPos->Par.i + 1];
 
-			case AB_DUP_CONTEXT:
-				PushValue(AulExec.GetContext(AulExec.GetContextDepth()-2)->Pars[pCPos->Par.i]);
-				break;
+			// Push array
+			PopValues(pCPos->Par.i);
+			PushArray(pArray);
 
-			case AB_LOCALN:
-				if (!pCurCtx->Obj)
-					throw C4AulExecError("can't access local variables without this");
-				PushNullVals(1);
-				pCurCtx->Obj->GetPropertyByS(pCPos->Par.s, pCurVal);
-				break;
-			case AB_LOCALN_SET:
-				if (!pCurCtx->Obj)
-					throw C4AulExecError("can't access local variables without this");
-				if (pCurCtx->Obj->IsFrozen())
-					throw C4AulExecError("local variable: this is readonly");
-				pCurCtx->Obj->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
-				break;
-
-			case AB_PROP:
-				if (!pCurVal->CheckConversion(C4V_PropList))
-					throw C4AulExecError(FormatString("proplist access: proplist expected, got %s", pCurVal->GetTypeName()).getData());
-				if (!pCurVal->_getPropList()->GetPropertyByS(pCPos->Par.s, pCurVal))
-					pCurVal->Set0();
-				break;
-			case AB_PROP_SET:
-			{
-				C4Value *pPropList = pCurVal - 1;
-				if (!pPropList->CheckConversion(C4V_PropList))
-					throw C4AulExecError(FormatString("proplist write: proplist expected, got %s", pPropList->GetTypeName()).getData());
-				if (pPropList->_getPropList()->IsFrozen())
-					throw C4AulExecError("proplist write: proplist is readonly");
-				pPropList->_getPropList()->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
-				pPropList->Set(pCurVal[0]);
-				PopValue();
-				break;
-			}
+			AUL_NEXT;
+		}
 
-			case AB_GLOBALN:
-				PushValue(*::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i));
-				break;
-			case AB_GLOBALN_SET:
-				::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i)->Set(pCurVal[0]);
-				break;
-				
-			// prefix
-			case AB_BitNot: // ~
-				CheckOpPar(C4V_Int, "~");
-				pCurVal->SetInt(~pCurVal->_getInt());
-				break;
-			case AB_Not:  // !
-				pCurVal->SetBool(!pCurVal->getBool());
-				break;
-			case AB_Neg:  // -
-				CheckOpPar(C4V_Int, "-");
-				pCurVal->SetInt(-pCurVal->_getInt());
-				break;
-			case AB_Inc: // ++
-				CheckOpPar(C4V_Int, "++");
-				pCurVal->SetInt(pCurVal->_getInt() + 1);
-				break;
-			case AB_Dec: // --
-				CheckOpPar(C4V_Int, "--");
-				pCurVal->SetInt(pCurVal->_getInt() - 1);
-				break;
-			// postfix
-			case AB_Pow:  // **
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "**");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(Pow(pPar1->_getInt(), pPar2->_getInt()));
-				PopValue();
-				break;
-			}
-			case AB_Div:  // /
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "/");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				if (!pPar2->_getInt())
-					throw C4AulExecError("division by zero");
-				// INT_MIN/-1 cannot be represented in an int and would cause an uncaught exception
-				if (pPar1->_getInt()==INT32_MIN && pPar2->_getInt()==-1)
-					throw C4AulExecError("division overflow");
-				pPar1->SetInt(pPar1->_getInt() / pPar2->_getInt());
-				PopValue();
-				break;
-			}
-			case AB_Mul:  // *
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "*");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() * pPar2->_getInt());
-				PopValue();
-				break;
-			}
-			case AB_Mod:  // %
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "%");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				// INT_MIN%-1 cannot be represented in an int and would cause an uncaught exception
-				if (pPar1->_getInt()==INT32_MIN && pPar2->_getInt()==-1)
-					throw C4AulExecError("modulo division overflow");
-				if (pPar2->_getInt())
-					pPar1->SetInt(pPar1->_getInt() % pPar2->_getInt());
-				else
-					pPar1->Set0();
-				PopValue();
-				break;
-			}
-			case AB_Sub:  // -
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "-");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() - pPar2->_getInt());
-				PopValue();
-				break;
-			}
-			case AB_Sum:  // +
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "+");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() + pPar2->_getInt());
-				PopValue();
-				break;
-			}
-			case AB_LeftShift:  // <<
-			{
-				CheckOpPars(C4V_Int, C4V_Int, "<<");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() << pPar2->_getInt());
-				PopValue();
-				break;
-			}
-			case AB_RightShift: // >>
+		AUL_OP(AB_NEW_PROPLIST):
+		{
+			C4PropList * pPropList = C4PropList::New();
+
+			for (int i = 0; i < pCPos->Par.i; i++)
+				pPropList->SetPropertyByS(pCurVal[-2 * i - 1]._getStr(), pCurVal[-2 * i]);
+
+			PopValues(pCPos->Par.i * 2);
+			PushPropList(pPropList);
+			AUL_NEXT;
+		}
+
+		AUL_OP(AB_ARRAYA):
+		{
+			C4Value *pIndex = pCurVal, *pStruct = pCurVal - 1, *pResult = pCurVal - 1;
+			// Typcheck to determine whether it's an array or a proplist
+			if(CheckArrayAccess(pStruct, pIndex) == C4V_Array)
 			{
-				CheckOpPars(C4V_Int, C4V_Int, ">>");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() >> pPar2->_getInt());
-				PopValue();
-				break;
+				*pResult = pStruct->_getArray()->GetItem(pIndex->_getInt());
 			}
-			case AB_LessThan: // <
+			else
 			{
-				CheckOpPars(C4V_Int, C4V_Int, "<");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(pPar1->_getInt() < pPar2->_getInt());
-				PopValue();
-				break;
+				assert(pStruct->GetType() == C4V_PropList);
+				C4PropList *pPropList = pStruct->_getPropList();
+				if (!pPropList->GetPropertyByS(pIndex->_getStr(), pResult))
+					pResult->Set0();
 			}
-			case AB_LessThanEqual:  // <=
+			// Remove index
+			PopValue();
+			AUL_NEXT;
+		}
+		AUL_OP(AB_ARRAYA_SET):
+		{
+			C4Value *pValue = pCurVal, *pIndex = pCurVal - 1, *pStruct = pCurVal - 2, *pResult = pCurVal - 2;
+			// Typcheck to determine whether it's an array or a proplist
+			if(CheckArrayAccess(pStruct, pIndex) == C4V_Array)
 			{
-				CheckOpPars(C4V_Int, C4V_Int, "<=");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(pPar1->_getInt() <= pPar2->_getInt());
-				PopValue();
-				break;
+				if (pStruct->_getArray()->IsFrozen())
+					throw C4AulExecError("array write: array is readonly");
+				pStruct->_getArray()->SetItem(pIndex->_getInt(), *pValue);
 			}
-			case AB_GreaterThan:  // >
+			else
 			{
-				CheckOpPars(C4V_Int, C4V_Int, ">");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(pPar1->_getInt() > pPar2->_getInt());
-				PopValue();
-				break;
+				assert(pStruct->GetType() == C4V_PropList);
+				C4PropList *pPropList = pStruct->_getPropList();
+				if (pPropList->IsFrozen())
+					throw C4AulExecError("proplist write: proplist is readonly");
+				pPropList->SetPropertyByS(pIndex->_getStr(), *pValue);
 			}
-			case AB_GreaterThanEqual: // >=
+			// Set result, remove array and index from stack
+			*pResult = *pValue;
+			PopValues(2);
+			AUL_NEXT;
+		}
+		AUL_OP(AB_ARRAY_SLICE):
+		{
+			C4Value &Array = pCurVal[-2];
+			C4Value &StartIndex = pCurVal[-1];
+			C4Value &EndIndex = pCurVal[0];
+
+			// Typcheck
+			if (!Array.CheckConversion(C4V_Array))
+				throw C4AulExecError(FormatString("array slice: can't access %s as an array", Array.GetTypeName()).getData());
+			if (!StartIndex.CheckConversion(C4V_Int))
+				throw C4AulExecError(FormatString("array slice: start index of type %s, int expected", StartIndex.GetTypeName()).getData());
+			if (!EndIndex.CheckConversion(C4V_Int))
+				throw C4AulExecError(FormatString("array slice: end index of type %s, int expected", EndIndex.GetTypeName()).getData());
+
+			Array.SetArray(Array.GetData().Array->GetSlice(StartIndex._getInt(), EndIndex._getInt()));
+
+			// Remove both indices
+			PopValues(2);
+			AUL_NEXT;
+		}
+
+		AUL_OP(AB_ARRAY_SLICE_SET):
+		{
+			C4Value &Array = pCurVal[-3];
+			C4Value &StartIndex = pCurVal[-2];
+			C4Value &EndIndex = pCurVal[-1];
+			C4Value &Value = pCurVal[0];
+
+			// Typcheck
+			if (!Array.CheckConversion(C4V_Array))
+				throw C4AulExecError(FormatString("array slice: can't access %s as an array", Array.GetTypeName()).getData());
+			if (!StartIndex.CheckConversion(C4V_Int))
+				throw C4AulExecError(FormatString("array slice: start index of type %s, int expected", StartIndex.GetTypeName()).getData());
+			if (!EndIndex.CheckConversion(C4V_Int))
+				throw C4AulExecError(FormatString("array slice: end index of type %s, int expected", EndIndex.GetTypeName()).getData());
+
+			C4ValueArray *pArray = Array._getArray();
+			if (pArray->IsFrozen()) throw C4AulExecError("array write: array is readonly");
+			pArray->SetSlice(StartIndex._getInt(), EndIndex._getInt(), Value);
+
+			// Set value as result, remove both indices and first copy of value
+			Array = Value;
+			PopValues(3);
+			AUL_NEXT;
+		}
+
+		AUL_OP(AB_STACK):
+			if (pCPos->Par.i < 0)
+				PopValues(-pCPos->Par.i);
+			else
+				PushNullVals(pCPos->Par.i);
+			AUL_NEXT;
+
+		AUL_OP(AB_JUMP):
+			pCPos += pCPos->Par.i;
+			AUL_JUMP;
+
+		AUL_OP(AB_JUMPAND):
+			if (!pCurVal[0])
 			{
-				CheckOpPars(C4V_Int, C4V_Int, ">=");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(pPar1->_getInt() >= pPar2->_getInt());
-				PopValue();
-				break;
+				pCPos += pCPos->Par.i;
+				AUL_JUMP;
 			}
-			case AB_Equal:  // ==
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_JUMPOR):
+			if (!!pCurVal[0])
 			{
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(pPar1->IsIdenticalTo(*pPar2));
-				PopValue();
-				break;
+				pCPos += pCPos->Par.i;
+				AUL_JUMP;
 			}
-			case AB_NotEqual: // !=
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_JUMPNNIL): // ??
+			if (pCurVal[0].GetType() != C4V_Nil)
 			{
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetBool(!pPar1->IsIdenticalTo(*pPar2));
-				PopValue();
-				break;
+				pCPos += pCPos->Par.i;
+				AUL_JUMP;
 			}
-			case AB_BitAnd: // &
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_CONDN):
+			if (!pCurVal[0])
 			{
-				CheckOpPars(C4V_Int, C4V_Int, "&");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() & pPar2->_getInt());
 				PopValue();
-				break;
+				pCPos += pCPos->Par.i;
+				AUL_JUMP;
 			}
-			case AB_BitXOr: // ^
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_COND):
+			if (pCurVal[0])
 			{
-				CheckOpPars(C4V_Int, C4V_Int, "^");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() ^ pPar2->_getInt());
 				PopValue();
-				break;
+				pCPos += pCPos->Par.i;
+				AUL_JUMP;
 			}
-			case AB_BitOr:  // |
+			PopValue();
+			AUL_NEXT;
+
+		AUL_OP(AB_CMPJUMP_LOCALN_INT):
+			// Fast path for int properties, otherwise continue with the INT
+			if (!pCurCtx->Obj)
+				throw C4AulExecError("can't access local variables without this");
+			PushNullVals(1);
+			GetPropertyCached(pCurCtx->Obj, pCPos, pCurVal);
+			if (pCurVal->GetType() == C4V_Int && pCurVal - Values < MAX_VALUE_STACK - 1)
 			{
-				CheckOpPars(C4V_Int, C4V_Int, "|");
-				C4Value *pPar1 = pCurVal - 1, *pPar2 = pCurVal;
-				pPar1->SetInt(pPar1->_getInt() | pPar2->_getInt());
+				int32_t iLeft = pCurVal->_getInt();
 				PopValue();
-				break;
+				pCPos = FusedCompareJump(pCPos, iLeft, pCPos[1].Par.i);
+				AUL_JUMP;
 			}
+			AUL_NEXT;
 
-			case AB_NEW_ARRAY:
+		AUL_OP(AB_CMPJUMP_DUP_INT):
+			// Fast path for int variables, otherwise continue with the INT
+			if (pCurVal[pCPos->Par.i].GetType() == C4V_Int && pCurVal - Values < MAX_VALUE_STACK - 2)
 			{
-				// Create array
-				C4ValueArray *pArray = new C4ValueArray(pCPos->Par.i);
-
-				// Pop values from stack
-				for (int i = 0; i < pCPos->Par.i; i++)
-					(*pArray)[i] = pCurVal[i - pCPos->Par.i + 1];
-
-				// Push array
-				PopValues(pCPos->Par.i);
-				PushArray(pArray);
-
-				break;
+				pCPos = FusedCompareJump(pCPos, pCurVal[pCPos->Par.i]._getInt(), pCPos[1].Par.i);
+				AUL_JUMP;
 			}
+			PushValue(pCurVal[pCPos->Par.i]);
+			AUL_NEXT;
 
-			case AB_NEW_PROPLIST:
+		AUL_OP(AB_CMPJUMP_DUP_DUP):
+		{
+			// Fast path for int variables, otherwise continue with the second DUP
+			// The second DUP is relative to the stack after the first one
+			const C4Value &Left = pCurVal[pCPos->Par.i], &Right = pCurVal[pCPos[1].Par.i + 1];
+			if (Left.GetType() == C4V_Int && Right.GetType() == C4V_Int && pCurVal - Values < MAX_VALUE_STACK - 2)
 			{
-				C4PropList * pPropList = C4PropList::New();
-
-				for (int i = 0; i < pCPos->Par.i; i++)
-					pPropList->SetPropertyByS(pCurVal[-2 * i - 1]._getStr(), pCurVal[-2 * i]);
-
-				PopValues(pCPos->Par.i * 2);
-				PushPropList(pPropList);
-				break;
+				pCPos = FusedCompareJump(pCPos, Left._getInt(), Right._getInt());
+				AUL_JUMP;
 			}
+			PushValue(pCurVal[pCPos->Par.i]);
+			AUL_NEXT;
+		}
 
-			case AB_ARRAYA:
-			{
-				C4Value *pIndex = pCurVal, *pStruct = pCurVal - 1, *pResult = pCurVal - 1;
-				// Typcheck to determine whether it's an array or a proplist
-				if(CheckArrayAccess(pStruct, pIndex) == C4V_Array)
-				{
-					*pResult = pStruct->_getArray()->GetItem(pIndex->_getInt());
-				}
-				else
-				{
-					assert(pStruct->GetType() == C4V_PropList);
-					C4PropList *pPropList = pStruct->_getPropList();
-					if (!pPropList->GetPropertyByS(pIndex->_getStr(), pResult))
-						pResult->Set0();
-				}
-				// Remove index
-				PopValue();
-				break;
-			}
-			case AB_ARRAYA_SET:
-			{
-				C4Value *pValue = pCurVal, *pIndex = pCurVal - 1, *pStruct = pCurVal - 2, *pResult = pCurVal - 2;
-				// Typcheck to determine whether it's an array or a proplist
-				if(CheckArrayAccess(pStruct, pIndex) == C4V_Array)
-				{
-					if (pStruct->_getArray()->IsFrozen())
-						throw C4AulExecError("array write: array is readonly");
-					pStruct->_getArray()->SetItem(pIndex->_getInt(), *pValue);
-				}
-				else
-				{
-					assert(pStruct->GetType() == C4V_PropList);
-					C4PropList *pPropList = pStruct->_getPropList();
-					if (pPropList->IsFrozen())
-						throw C4AulExecError("proplist write: proplist is readonly");
-					pPropList->SetPropertyByS(pIndex->_getStr(), *pValue);
-				}
-				// Set result, remove array and index from stack
-				*pResult = *pValue;
-				PopValues(2);
-				break;
-			}
-			case AB_ARRAY_SLICE:
+		AUL_OP(AB_RETURN):
+		{
+			// Trace
+			if (iTraceStart >= 0)
 			{
-				C4Value &Array = pCurVal[-2];
-				C4Value &StartIndex = pCurVal[-1];
-				C4Value &EndIndex = pCurVal[0];
-
-				// Typcheck
-				if (!Array.CheckConversion(C4V_Array))
-					throw C4AulExecError(FormatString("array slice: can't access %s as an array", Array.GetTypeName()).getData());
-				if (!StartIndex.CheckConversion(C4V_Int))
-					throw C4AulExecError(FormatString("array slice: start index of type %s, int expected", StartIndex.GetTypeName()).getData());
-				if (!EndIndex.CheckConversion(C4V_Int))
-					throw C4AulExecError(FormatString("array slice: end index of type %s, int expected", EndIndex.GetTypeName()).getData());
-
-				Array.SetArray(Array.GetData().Array->GetSlice(StartIndex._getInt(), EndIndex._getInt()));
-
-				// Remove both indices
-				PopValues(2);
-				break;
+				StdStrBuf Buf("T");
+				Buf.AppendChars('>', ContextStackSize() - iTraceStart);
+				LogF("%s%s returned %s", Buf.getData(), pCurCtx->Func->GetName(), pCurVal->GetDataString().getData());
 			}
 
-			case AB_ARRAY_SLICE_SET:
+			C4Value *pReturn = pCurCtx->Return;
+
+			// External call?
+			if (!pReturn)
 			{
-				C4Value &Array = pCurVal[-3];
-				C4Value &StartIndex = pCurVal[-2];
-				C4Value &EndIndex = pCurVal[-1];
-				C4Value &Value = pCurVal[0];
-
-				// Typcheck
-				if (!Array.CheckConversion(C4V_Array))
-					throw C4AulExecError(FormatString("array slice: can't access %s as an array", Array.GetTypeName()).getData());
-				if (!StartIndex.CheckConversion(C4V_Int))
-					throw C4AulExecError(FormatString("array slice: start index of type %s, int expected", StartIndex.GetTypeName()).getData());
-				if (!EndIndex.CheckConversion(C4V_Int))
-					throw C4AulExecError(FormatString("array slice: end index of type %s, int expected", EndIndex.GetTypeName()).getData());
-
-				C4ValueArray *pArray = Array._getArray();
-				if (pArray->IsFrozen()) throw C4AulExecError("array write: array is readonly");
-				pArray->SetSlice(StartIndex._getInt(), EndIndex._getInt(), Value);
-
-				// Set value as result, remove both indices and first copy of value
-				Array = Value;
-				PopValues(3);
-				break;
+				// Get return value and stop executing.
+				C4Value rVal = *pCurVal;
+				PopValuesUntil(pCurCtx->Pars - 1);
+				PopContext();
+				return rVal;
 			}
 
-			case AB_STACK:
-				if (pCPos->Par.i < 0)
-					PopValues(-pCPos->Par.i);
-				else
-					PushNullVals(pCPos->Par.i);
-				break;
+			// Save return value
+			if (pCurVal != pReturn)
+				pReturn->Set(*pCurVal);
 
-			case AB_JUMP:
-				fJump = true;
-				pCPos += pCPos->Par.i;
-				break;
+			// Pop context
+			PopContext();
 
-			case AB_JUMPAND:
-				if (!pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
-				else
-				{
-					PopValue();
-				}
-				break;
+			// Clear value stack, except return value
+			PopValuesUntil(pReturn);
 
-			case AB_JUMPOR:
-				if (!!pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
-				else
-				{
-					PopValue();
-				}
-				break;
+			// Jump back, continue.
+			pCPos = pCurCtx->CPos + 1;
+			AUL_JUMP;
+		}
 
-			case AB_JUMPNNIL: // ??
+		AUL_OP(AB_FUNC):
+		{
+			// Get function call data
+			C4AulFunc *pFunc = pCPos->Par.f;
+			C4Value *pPars = pCurVal - pFunc->GetParCount() + 1;
+			// Save current position
+			pCurCtx->CPos = pCPos;
+			assert(pCurCtx->Func->GetCode() <= pCPos);
+			// Do the call
+			C4AulBCC *pJump = Call(pFunc, pPars, pPars, nullptr);
+			if (pJump)
 			{
-				if (pCurVal[0].GetType() != C4V_Nil)
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
-				else
-				{
-					PopValue();
-				}
-				break;
+				pCPos = pJump;
+				AUL_JUMP;
 			}
+			AUL_NEXT;
+		}
 
-			case AB_CONDN:
-				if (!pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
-				PopValue();
-				break;
-
-			case AB_COND:
-				if (pCurVal[0])
-				{
-					fJump = true;
-					pCPos += pCPos->Par.i;
-				}
-				PopValue();
-				break;
-
-			case AB_RETURN:
-			{
-				// Trace
-				if (iTraceStart >= 0)
-				{
-					StdStrBuf Buf("T");
-					Buf.AppendChars('>', ContextStackSize() - iTraceStart);
-					LogF("%s%s returned %s", Buf.getData(), pCurCtx->Func->GetName(), pCurVal->GetDataString().getData());
-				}
-
-				C4Value *pReturn = pCurCtx->Return;
-
-				// External call?
-				if (!pReturn)
-				{
-					// Get return value and stop executing.
-					C4Value rVal = *pCurVal;
-					PopValuesUntil(pCurCtx->Pars - 1);
-					PopContext();
-					return rVal;
-				}
-
-				// Save return value
-				if (pCurVal != pReturn)
-					pReturn->Set(*pCurVal);
-
-				// Pop context
-				PopContext();
-
-				// Clear value stack, except return value
-				PopValuesUntil(pReturn);
-
-				// Jump back, continue.
-				pCPos = pCurCtx->CPos + 1;
-				fJump = true;
+		AUL_OP(AB_PAR):
+			if (!pCurVal->CheckConversion(C4V_Int))
+				throw C4AulExecError(FormatString("Par: index of type %s, int expected", pCurVal->GetTypeName()).getData());
+			// Push reference to parameter on the stack
+			if (pCurVal->_getInt() >= 0 && pCurVal->_getInt() < pCurCtx->Func->GetParCount())
+				pCurVal->Set(pCurCtx->Pars[pCurVal->_getInt()]);
+			else
+				pCurVal->Set0();
+			AUL_NEXT;
 
-				break;
-			}
+		AUL_OP(AB_THIS):
+			if (!pCurCtx->Obj || !pCurCtx->Obj->Status)
+				PushNullVals(1);
+			else
+				PushPropList(pCurCtx->Obj);
+			AUL_NEXT;
 
-			case AB_FUNC:
+		AUL_OP(AB_FOREACH_NEXT):
+		{
+			// This should always hold
+			assert(pCurVal->CheckConversion(C4V_Int));
+			int iItem = pCurVal->_getInt();
+			// Check array the first time only
+			if (!iItem)
 			{
-				// Get function call data
-				C4AulFunc *pFunc = pCPos->Par.f;
-				C4Value *pPars = pCurVal - pFunc->GetParCount() + 1;
-				// Save current position
-				pCurCtx->CPos = pCPos;
-				assert(pCurCtx->Func->GetCode() <= pCPos);
-				// Do the call
-				C4AulBCC *pJump = Call(pFunc, pPars, pPars, nullptr);
-				if (pJump)
-				{
-					pCPos = pJump;
-					fJump = true;
-				}
-				break;
+				if (!pCurVal[-1].CheckConversion(C4V_Array))
+					throw C4AulExecError(FormatString("for: array expected, but got %s", pCurVal[-1].GetTypeName()).getData());
 			}
+			C4ValueArray *pArray = pCurVal[-1]._getArray();
+			// No more entries?
+			if (pCurVal->_getInt() >= pArray->GetSize())
+				AUL_NEXT;
+			// Get next
+			pCurVal[pCPos->Par.i] = pArray->GetItem(iItem);
+			// Save position
+			pCurVal->SetInt(iItem + 1);
+			// Jump over next instruction
+			pCPos += 2;
+			AUL_JUMP;
+		}
 
-			case AB_PAR:
-				if (!pCurVal->CheckConversion(C4V_Int))
-					throw C4AulExecError(FormatString("Par: index of type %s, int expected", pCurVal->GetTypeName()).getData());
-				// Push reference to parameter on the stack
-				if (pCurVal->_getInt() >= 0 && pCurVal->_getInt() < pCurCtx->Func->GetParCount())
-					pCurVal->Set(pCurCtx->Pars[pCurVal->_getInt()]);
-				else
-					pCurVal->Set0();
-				break;
+		AUL_OP(AB_CALL):
+		AUL_OP(AB_CALLFS):
+		{
 
-			case AB_THIS:
-				if (!pCurCtx->Obj || !pCurCtx->Obj->Status)
-					PushNullVals(1);
-				else
-					PushPropList(pCurCtx->Obj);
-				break;
+			C4Value *pPars = pCurVal - C4AUL_MAX_Par + 1;
+			C4Value *pTargetVal = pCurVal - C4AUL_MAX_Par;
 
-			case AB_FOREACH_NEXT:
+			C4PropList *pDest;
+			if (pTargetVal->CheckConversion(C4V_PropList))
 			{
-				// This should always hold
-				assert(pCurVal->CheckConversion(C4V_Int));
-				int iItem = pCurVal->_getInt();
-				// Check array the first time only
-				if (!iItem)
-				{
-					if (!pCurVal[-1].CheckConversion(C4V_Array))
-						throw C4AulExecError(FormatString("for: array expected, but got %s", pCurVal[-1].GetTypeName()).getData());
-				}
-				C4ValueArray *pArray = pCurVal[-1]._getArray();
-				// No more entries?
-				if (pCurVal->_getInt() >= pArray->GetSize())
-					break;
-				// Get next
-				pCurVal[pCPos->Par.i] = pArray->GetItem(iItem);
-				// Save position
-				pCurVal->SetInt(iItem + 1);
-				// Jump over next instruction
-				pCPos += 2;
-				fJump = true;
-				break;
+				pDest = pTargetVal->_getPropList();
 			}
+			else
+				throw C4AulExecError(FormatString("'->': invalid target type %s, expected proplist", pTargetVal->GetTypeName()).getData());
 
-			case AB_CALL:
-			case AB_CALLFS:
+			// Search function for given context
+			C4AulFunc * pFunc = GetFuncCached(pDest, pCPos);
+			if (!pFunc && pCPos->bccType == AB_CALLFS)
 			{
+				PopValuesUntil(pTargetVal);
+				pTargetVal->Set0();
+				AUL_NEXT;
+			}
 
-				C4Value *pPars = pCurVal - C4AUL_MAX_Par + 1;
-				C4Value *pTargetVal = pCurVal - C4AUL_MAX_Par;
-
-				C4PropList *pDest;
-				if (pTargetVal->CheckConversion(C4V_PropList))
-				{
-					pDest = pTargetVal->_getPropList();
-				}
-				else
-					throw C4AulExecError(FormatString("'->': invalid target type %s, expected proplist", pTargetVal->GetTypeName()).getData());
-
-				// Search function for given context
-				C4AulFunc * pFunc = pDest->GetFunc(pCPos->Par.s);
-				if (!pFunc && pCPos->bccType == AB_CALLFS)
-				{
-					PopValuesUntil(pTargetVal);
-					pTargetVal->Set0();
-					break;
-				}
-
-				// Function not found?
-				if (!pFunc)
-					throw C4AulExecError(FormatString(R"('->': no function "%s" in object "%s")", pCPos->Par.s->GetCStr(), pTargetVal->GetDataString().getData()).getData());
-
-				// Save current position
-				pCurCtx->CPos = pCPos;
-				assert(pCurCtx->Func->GetCode() <= pCPos);
+			// Function not found?
+			if (!pFunc)
+				throw C4AulExecError(FormatString(R"('->': no function "%s" in object "%s")", pCPos->Par.s->GetCStr(), pTargetVal->GetDataString().getData()).getData());
 
-				// adjust parameter count
-				if (pCurVal + 1 - pPars > pFunc->GetParCount())
-					PopValues(pCurVal + 1 - pPars - pFunc->GetParCount());
-				else
-					PushNullVals(pFunc->GetParCount() - (pCurVal + 1 - pPars));
+			// Save current position
+			pCurCtx->CPos = pCPos;
+			assert(pCurCtx->Func->GetCode() <= pCPos);
 
-				// Call function
-				C4AulBCC *pNewCPos = Call(pFunc, pTargetVal, pPars, pDest);
-				if (pNewCPos)
-				{
-					// Jump
-					pCPos = pNewCPos;
-					fJump = true;
-				}
+			// adjust parameter count
+			if (pCurVal + 1 - pPars > pFunc->GetParCount())
+				PopValues(pCurVal + 1 - pPars - pFunc->GetParCount());
+			else
+				PushNullVals(pFunc->GetParCount() - (pCurVal + 1 - pPars));
 
-				break;
+			// Call function
+			C4AulBCC *pNewCPos = Call(pFunc, pTargetVal, pPars, pDest);
+			if (pNewCPos)
+			{
+				// Jump
+				pCPos = pNewCPos;
+				AUL_JUMP;
 			}
 
-			case AB_DEBUG:
+			AUL_NEXT;
+		}
+
+		AUL_OP(AB_DEBUG):
 #ifndef NOAULDEBUG
-				if (C4AulDebug *pDebug = C4AulDebug::GetDebugger())
-					pDebug->DebugStep(pCPos, pCurVal);
+			if (C4AulDebug *pDebug = C4AulDebug::GetDebugger())
+				pDebug->DebugStep(pCPos, pCurVal);
 #endif
-				break;
-			}
-
-			// Continue
-			if (!fJump)
-				pCPos++;
+			AUL_NEXT;
 		}
-
+		// Every handler continues with AUL_NEXT or AUL_JUMP
+		throw C4AulExecError("internal error: unknown bytecode");
 	}
 	catch (C4AulError &)
 	{
@@ -816,6 +929,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 	}
 }
 
+#undef AUL_OP
+#undef AUL_NEXT
+#undef AUL_JUMP
+
 C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4PropList *pContext)
 {
 	// No object given? Use current context
@@ -885,6 +1002,7 @@ C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4
 #ifdef _DEBUG
 		C4AulScriptContext *pCtx = pCurCtx;
 #endif
+		C4AulCallGraph::Scope ProfilerScope(&CallGraph, pFunc);
 		if (pReturn > pCurVal)
 			PushValue(pFunc->Exec(pContext, pPars, true));
 		else
@@ -911,15 +1029,10 @@ void C4AulExec::StartTrace()
 void C4AulExec::StartProfiling(C4ScriptHost *pProfiledScript)
 {
 	// stop previous profiler run
-	if (fProfiling) StopProfiling();
-	fProfiling = true;
-	// resets profling times and starts recording the times
-	this->pProfiledScript = pProfiledScript;
-	C4TimeMilliseconds tNow = C4TimeMilliseconds::Now();
-	tDirectExecStart = tNow; // in case profiling is started from DirectExec
-	tDirectExecTotal = 0;
+	CallGraph.Start(pProfiledScript ? pProfiledScript->GetPropList() : nullptr);
+	// the functions that are already running are timed from now on
 	for (C4AulScriptContext *pCtx = Contexts; pCtx <= pCurCtx; ++pCtx)
-		pCtx->tTime = tNow;
+		CallGraph.Enter(pCtx->Func);
 }
 
 void C4AulExec::PushContext(const C4AulScriptContext &rContext)
@@ -934,21 +1047,16 @@ void C4AulExec::PushContext(const C4AulScriptContext &rContext)
 		Buf.AppendChars('>', ContextStackSize() - iTraceStart);
 		pCurCtx->dump(Buf);
 	}
-	// Profiler: Safe time to measure difference afterwards
-	if (fProfiling) pCurCtx->tTime = C4TimeMilliseconds::Now();
+	// Profiler
+	if (CallGraph.IsRunning()) CallGraph.Enter(pCurCtx->Func);
 }
 
 void C4AulExec::PopContext()
 {
 	if (pCurCtx < Contexts)
 		throw C4AulExecError("internal error: context stack underflow");
-	// Profiler adding up times
-	if (fProfiling)
-	{
-		uint32_t dt = C4TimeMilliseconds::Now() - pCurCtx->tTime;
-		if (pCurCtx->Func)
-			pCurCtx->Func->tProfileTime += dt;
-	}
+	// Profiler
+	if (CallGraph.IsRunning()) CallGraph.Leave();
 	// Trace done?
 	if (iTraceStart >= 0)
 	{
@@ -960,38 +1068,83 @@ void C4AulExec::PopContext()
 	pCurCtx--;
 }
 
+std::vector<C4AulProfiler::StatsSource *> &C4AulProfiler::GetStatsSources()
+{
+	// function-local to be usable from static initialization
+	static std::vector<StatsSource *> Sources;
+	return Sources;
+}
+
+void C4AulProfiler::AddStatsSource(StatsSource *pSource)
+{
+	GetStatsSources().push_back(pSource);
+}
+
+void C4AulProfiler::RemoveStatsSource(StatsSource *pSource)
+{
+	auto &Sources = GetStatsSources();
+	Sources.erase(std::remove(Sources.begin(), Sources.end(), pSource), Sources.end());
+}
+
 void C4AulProfiler::StartProfiling(C4ScriptHost *pScript)
 {
 	AulExec.StartProfiling(pScript);
-	if(pScript)
-		ResetTimes(pScript->GetPropList());
-	else
-		ResetTimes();
+	for (StatsSource *pSource : GetStatsSources())
+		pSource->ResetStats();
 }
 
-void C4AulProfiler::StopProfiling()
+void C4AulProfiler::StopProfiling(const char *szFilenameBase)
 {
 	if (!AulExec.IsProfiling()) return;
 	AulExec.StopProfiling();
 	// collect profiler times
 	C4AulProfiler Profiler;
-	Profiler.CollectEntry(nullptr, AulExec.tDirectExecTotal);
-	if(AulExec.pProfiledScript)
-		Profiler.CollectTimes(AulExec.pProfiledScript->GetPropList());
-	else
-		Profiler.CollectTimes();
+	Profiler.CollectTimes(AulExec.CallGraph);
 	Profiler.Show();
+	for (StatsSource *pSource : GetStatsSources())
+		pSource->ShowStats();
+	// export call graph
+	if (szFilenameBase && *szFilenameBase)
+	{
+		StdStrBuf sFilename;
+		sFilename.Format("%s.folded", szFilenameBase);
+		if (AulExec.CallGraph.SaveCollapsedStacks(sFilename.getData()))
+			LogF("Script profiler: Saved flame graph stacks to %s", sFilename.getData());
+		else
+			LogF("Script profiler: Error writing %s", sFilename.getData());
+		sFilename.Format("%s.json", szFilenameBase);
+		if (AulExec.CallGraph.SaveChromeTrace(sFilename.getData()))
+			LogF("Script profiler: Saved trace to %s", sFilename.getData());
+		else
+			LogF("Script profiler: Error writing %s", sFilename.getData());
+	}
 }
 
-void C4AulProfiler::CollectEntry(C4AulScriptFunc *pFunc, uint32_t tProfileTime)
+void C4AulProfiler::CollectTimes(const C4AulCallGraph &Graph)
 {
-	// zero entries are not collected to have a cleaner list
-	if (!tProfileTime) return;
-	// add entry to list
-	Entry e;
-	e.pFunc = pFunc;
-	e.tProfileTime = tProfileTime;
-	Times.push_back(e);
+	// sum up all nodes of each function
+	// Time spent in recursive calls is only counted once for the inclusive time.
+	const std::vector<C4AulCallGraph::Node> &Nodes = Graph.GetNodes();
+	std::map<std::string, size_t> Index;
+	for (size_t i = 1; i < Nodes.size(); ++i)
+	{
+		const C4AulCallGraph::Node &n = Nodes[i];
+		if (!n.fSelected || !n.Calls) continue;
+		auto it = Index.find(n.Name);
+		if (it == Index.end())
+		{
+			it = Index.emplace(n.Name, Times.size()).first;
+			Times.push_back({n.Name, 0, 0, 0});
+		}
+		Entry &e = Times[it->second];
+		e.tExclusive += n.tExclusive;
+		e.Calls += n.Calls;
+		bool fRecursive = false;
+		for (int32_t iAncestor = n.Parent; iAncestor > 0 && !fRecursive; iAncestor = Nodes[iAncestor].Parent)
+			fRecursive = Nodes[iAncestor].Name == n.Name;
+		if (!fRecursive)
+			e.tInclusive += n.tInclusive;
+	}
 }
 
 void C4AulProfiler::Show()
@@ -999,16 +1152,137 @@ void C4AulProfiler::Show()
 	// sort by time
 	std::sort(Times.rbegin(), Times.rend());
 	// display them
-	Log("Profiler statistics:");
+	Log("Profiler statistics (self / total time in ms, calls):");
 	Log("==============================");
 	for (auto & e : Times)
 	{
-		LogF("%05ums\t%s", e.tProfileTime, e.pFunc ? (e.pFunc->GetFullName().getData()) : "Direct exec");
+		LogF("%9.3f\t%9.3f\t%u\t%s", e.tExclusive / 1e6, e.tInclusive / 1e6, e.Calls, e.Name.c_str());
 	}
 	Log("==============================");
 	// done!
 }
 
+void C4AulCallGraph::Start(const C4PropListStatic *pProfiledScript)
+{
+	Stop();
+	fRunning = true;
+	++iSession;
+	this->pProfiledScript = pProfiledScript;
+	tStart = Clock::now();
+	Nodes.clear();
+	Nodes.emplace_back();
+	Nodes[0].Parent = -1;
+	Nodes[0].Func = nullptr;
+	Nodes[0].fSelected = false;
+	Trace.clear();
+	fTraceTruncated = false;
+}
+
+void C4AulCallGraph::Stop()
+{
+	while (!Stack.empty())
+		Leave();
+	fRunning = false;
+}
+
+void C4AulCallGraph::Enter(C4AulFunc *pFunc)
+{
+	Clock::time_point tNow = Clock::now();
+	int32_t iParent = Stack.empty() ? 0 : Stack.back().Node;
+	// DirectExec functions are temporary and have no name, so they all share one node
+	const C4AulFunc *pKey = (pFunc && pFunc->GetName()) ? pFunc : nullptr;
+	int32_t iNode = -1;
+	for (const auto &Child : Nodes[iParent].Children)
+		if (Child.first == pKey)
+		{
+			iNode = Child.second;
+			break;
+		}
+	if (iNode < 0)
+	{
+		iNode = Nodes.size();
+		Nodes.emplace_back();
+		Node &n = Nodes.back();
+		n.Parent = iParent;
+		n.Name = pKey ? pFunc->GetFullName().getData() : "Direct exec";
+		n.Func = pKey;
+		n.fSelected = !pProfiledScript || (pKey && pFunc->Parent == pProfiledScript);
+		Nodes[iParent].Children.emplace_back(pKey, iNode);
+	}
+	++Nodes[iNode].Calls;
+	Stack.push_back({iNode, tNow, 0});
+}
+
+void C4AulCallGraph::Leave()
+{
+	if (Stack.empty()) return;
+	Clock::time_point tNow = Clock::now();
+	Frame f = Stack.back();
+	Stack.pop_back();
+	uint64_t dt = std::chrono::duration_cast<std::chrono::nanoseconds>(tNow - f.tStart).count();
+	Node &n = Nodes[f.Node];
+	n.tInclusive += dt;
+	n.tExclusive += dt - std::min(dt, f.tChildren);
+	if (!Stack.empty())
+		Stack.back().tChildren += dt;
+	if (Trace.size() < MaxTraceEvents)
+		Trace.push_back({f.Node, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(f.tStart - tStart).count(), dt});
+	else
+		fTraceTruncated = true;
+}
+
+bool C4AulCallGraph::SaveCollapsedStacks(const char *szFilename) const
+{
+	// one line per call stack: "outer;inner;innermost <self time>"
+	CStdFile File;
+	if (!File.Create(szFilename)) return false;
+	std::vector<std::string> Paths(Nodes.size());
+	for (size_t i = 1; i < Nodes.size(); ++i)
+	{
+		// parents always precede their children
+		std::string Name = Nodes[i].Name;
+		std::replace(Name.begin(), Name.end(), ';', ':');
+		std::replace(Name.begin(), Name.end(), ' ', '_');
+		Paths[i] = Nodes[i].Parent > 0 ? Paths[Nodes[i].Parent] + ";" + Name : Name;
+		if (!Nodes[i].tExclusive) continue;
+		std::string Line = Paths[i] + " " + std::to_string(Nodes[i].tExclusive) + "\n";
+		if (!File.Write(Line.c_str(), Line.size())) return false;
+	}
+	return File.Close();
+}
+
+bool C4AulCallGraph::SaveChromeTrace(const char *szFilename) const
+{
+	// trace event format with complete events; timestamps are in microseconds
+	CStdFile File;
+	if (!File.Create(szFilename)) return false;
+	std::vector<std::string> Names(Nodes.size());
+	for (size_t i = 1; i < Nodes.size(); ++i)
+	{
+		for (char c : Nodes[i].Name)
+		{
+			if (c == '"' || c == '\\') Names[i] += '\\';
+			if ((unsigned char) c >= ' ') Names[i] += c;
+		}
+	}
+	std::string Buf = "{\"traceEvents\":[\n";
+	bool fFirst = true;
+	for (const TraceEvent &e : Trace)
+	{
+		Buf += FormatString(R"(%s{"name":"%s","cat":"script","ph":"X","ts":%.3f,"dur":%.3f,"pid":1,"tid":1})",
+		                     fFirst ? "" : ",\n", Names[e.Node].c_str(), e.tStart / 1e3, e.tDuration / 1e3).getData();
+		fFirst = false;
+		if (Buf.size() > 65536)
+		{
+			if (!File.Write(Buf.c_str(), Buf.size())) return false;
+			Buf.clear();
+		}
+	}
+	Buf += "\n]}\n";
+	if (!File.Write(Buf.c_str(), Buf.size())) return false;
+	return File.Close();
+}
+
 C4Value C4AulExec::DirectExec(C4PropList *p, const char *szScript, const char *szContext, bool fPassErrors, C4AulScriptContext* context, bool parse_function)
 {
 	if (DEBUGREC_SCRIPT && Config.General.DebugRec)
@@ -1017,8 +1291,6 @@ C4Value C4AulExec::DirectExec(C4PropList *p, const char *szScript, const char *s
 		int32_t iObjNumber = p && p->GetPropListNumbered() ? p->GetPropListNumbered()->Number : -1;
 		AddDbgRec(RCT_DirectExec, &iObjNumber, sizeof(int32_t));
 	}
-	// profiler
-	StartDirectExec();
 	C4PropListStatic * script = ::GameScript.GetPropList();
 	if (p && p->IsStatic())
 		script = p->IsStatic();
@@ -1041,8 +1313,6 @@ C4Value C4AulExec::DirectExec(C4PropList *p, const char *szScript, const char *s
 		}
 		C4AulParSet Pars;
 		C4Value vRetVal(Exec(pFunc.get(), p, Pars.Par, fPassErrors));
-		// profiler
-		StopDirectExec();
 		return vRetVal;
 	}
 	catch (C4AulError &ex)
@@ -1051,43 +1321,6 @@ C4Value C4AulExec::DirectExec(C4PropList *p, const char *szScript, const char *s
 			throw;
 		::ScriptEngine.GetErrorHandler()->OnError(ex.what());
 		LogCallStack();
-		StopDirectExec();
 		return C4VNull;
 	}
 }
-
-void C4AulProfiler::ResetTimes(C4PropListStatic * p)
-{
-	// zero all profiler times of owned functions
-	C4AulScriptFunc *pSFunc;
-	for (C4String *pFn = p->EnumerateOwnFuncs(); pFn; pFn = p->EnumerateOwnFuncs(pFn))
-		if ((pSFunc = p->GetFunc(pFn)->SFunc()))
-			pSFunc->tProfileTime = 0;
-}
-
-void C4AulProfiler::CollectTimes(C4PropListStatic * p)
-{
-	// collect all profiler times of owned functions
-	C4AulScriptFunc *pSFunc;
-	for (C4String *pFn = p->EnumerateOwnFuncs(); pFn; pFn = p->EnumerateOwnFuncs(pFn))
-		if ((pSFunc = p->GetFunc(pFn)->SFunc()))
-			CollectEntry(pSFunc, pSFunc->tProfileTime);
-}
-
-void C4AulProfiler::ResetTimes()
-{
-	// zero all profiler times of owned functions
-	ResetTimes(::ScriptEngine.GetPropList());
-	// reset sub-scripts
-	for (C4ScriptHost *pScript = ::ScriptEngine.Child0; pScript; pScript = pScript->Next)
-		ResetTimes(pScript->GetPropList());
-}
-
-void C4AulProfiler::CollectTimes()
-{
-	// collect all profiler times of owned functions
-	CollectTimes(::ScriptEngine.GetPropList());
-	// collect sub-scripts
-	for (C4ScriptHost *pScript = ::ScriptEngine.Child0; pScript; pScript = pScript->Next)
-		CollectTimes(pScript->GetPropList());
-}
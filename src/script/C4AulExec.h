@@ -19,10 +19,11 @@
 #ifndef C4AULEXEC_H
 #define C4AULEXEC_H
 
-#include "platform/C4TimeMilliseconds.h"
 #include "script/C4Aul.h"
 #include "script/C4AulScriptFunc.h"
 
+#include <chrono>
+
 const int MAX_CONTEXT_STACK = 512;
 const int MAX_VALUE_STACK = 1024;
 
@@ -45,12 +46,75 @@ struct C4AulScriptContext
 	C4Value *Pars;
 	C4AulScriptFunc *Func;
 	C4AulBCC *CPos;
-	C4TimeMilliseconds tTime; // initialized only by profiler if active
 
 	void dump(StdStrBuf Dump = StdStrBuf(""));
 	StdStrBuf ReturnDump(StdStrBuf Dump = StdStrBuf(""));
 };
 
+// calling context tree recorded by the script profiler
+// Each node is one distinct call stack of script and engine functions. Times are in nanoseconds.
+class C4AulCallGraph
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	static const size_t MaxTraceEvents = 1 << 20; // later calls are still summed up, but not traced
+
+	struct Node
+	{
+		int32_t Parent;
+		std::string Name;
+		const C4AulFunc *Func; // only for comparison; the function may be deleted by now
+		bool fSelected; // belongs to the profiled script
+		uint32_t Calls{0};
+		uint64_t tInclusive{0}, tExclusive{0};
+		std::vector<std::pair<const C4AulFunc *, int32_t> > Children;
+	};
+
+	// engine function call; does nothing if the profiler was restarted or stopped in between
+	class Scope
+	{
+		C4AulCallGraph *pGraph;
+		uint32_t iSession;
+	public:
+		Scope(C4AulCallGraph *pGraph, C4AulFunc *pFunc): pGraph(pGraph), iSession(pGraph->iSession) { if (pGraph->fRunning) pGraph->Enter(pFunc); }
+		~Scope() { if (pGraph->fRunning && pGraph->iSession == iSession) pGraph->Leave(); }
+	};
+
+	void Start(const C4PropListStatic *pProfiledScript);
+	void Stop(); // closes the calls that are still running
+	bool IsRunning() const { return fRunning; }
+
+	void Enter(C4AulFunc *pFunc);
+	void Leave();
+
+	const std::vector<Node> &GetNodes() const { return Nodes; }
+	bool IsTraceTruncated() const { return fTraceTruncated; }
+	bool SaveCollapsedStacks(const char *szFilename) const; // for flame graph tools
+	bool SaveChromeTrace(const char *szFilename) const; // for chrome://tracing and compatible viewers
+
+private:
+	struct Frame
+	{
+		int32_t Node;
+		Clock::time_point tStart;
+		uint64_t tChildren;
+	};
+	struct TraceEvent
+	{
+		int32_t Node;
+		uint64_t tStart, tDuration;
+	};
+
+	bool fRunning{false};
+	uint32_t iSession{0};
+	const C4PropListStatic *pProfiledScript{nullptr};
+	Clock::time_point tStart;
+	std::vector<Node> Nodes; // Nodes[0] is the root
+	std::vector<Frame> Stack;
+	std::vector<TraceEvent> Trace;
+	bool fTraceTruncated{false};
+};
+
 class C4AulExec
 {
 
@@ -64,25 +128,20 @@ private:
 	C4Value *pCurVal;
 
 	int iTraceStart{-1};
-	bool fProfiling;
-	C4TimeMilliseconds tDirectExecStart;
-	uint32_t tDirectExecTotal; // profiler time for DirectExec
-	C4ScriptHost *pProfiledScript;
+	C4AulCallGraph CallGraph; // recorded by the profiler
 
 	C4AulScriptContext Contexts[MAX_CONTEXT_STACK];
 	C4Value Values[MAX_VALUE_STACK];
 
 	void StartProfiling(C4ScriptHost *pScript); // starts recording the times
-	bool IsProfiling() { return fProfiling; }
-	void StopProfiling() { fProfiling=false; }
+	bool IsProfiling() const { return CallGraph.IsRunning(); }
+	void StopProfiling() { CallGraph.Stop(); }
 	friend class C4AulProfiler;
 public:
 	C4Value Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value pPars[], bool fPassErrors);
 	C4Value DirectExec(C4PropList *p, const char *szScript, const char *szContext, bool fPassErrors = false, C4AulScriptContext* context = nullptr, bool parse_function = false);
 
 	void StartTrace();
-	inline void StartDirectExec() { if (fProfiling) tDirectExecStart = C4TimeMilliseconds::Now(); }
-	inline void StopDirectExec() { if (fProfiling) tDirectExecTotal += C4TimeMilliseconds::Now() - tDirectExecStart; }
 
 	int GetContextDepth() const { return pCurCtx - Contexts + 1; }
 	C4AulScriptContext *GetContext(int iLevel) { return iLevel >= 0 && iLevel < GetContextDepth() ? Contexts + iLevel : nullptr; }
@@ -227,6 +286,40 @@ private:
 			throw C4AulExecError(FormatString("can't access %s as array or proplist", pStructure->GetTypeName()).getData());
 	}
 	C4AulBCC *Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4PropList * pContext = nullptr);
+
+	// Lookups of the key of pCPos, through its inline cache if it has one
+	ALWAYS_INLINE bool GetPropertyCached(const C4PropList *p, const C4AulBCC *pCPos, C4Value *pResult)
+	{
+		if (pCPos->LookupCache < 0)
+			return p->GetPropertyByS(pCPos->Par.s, pResult);
+		return p->GetPropertyByS(pCPos->Par.s, pResult, pCurCtx->Func->GetLookupCache(pCPos));
+	}
+	ALWAYS_INLINE C4AulFunc *GetFuncCached(const C4PropList *p, const C4AulBCC *pCPos)
+	{
+		if (pCPos->LookupCache < 0)
+			return p->GetFunc(pCPos->Par.s);
+		return p->GetFunc(pCPos->Par.s, pCurCtx->Func->GetLookupCache(pCPos));
+	}
+
+	// Rest of an AB_CMPJUMP_* superinstruction: Compare like pCPos[2] and return the next instruction after the COND/CONDN at pCPos[3]
+	static ALWAYS_INLINE C4AulBCC *FusedCompareJump(C4AulBCC *pCPos, int32_t iLeft, int32_t iRight)
+	{
+		bool fResult;
+		switch (pCPos[2].bccType)
+		{
+		case AB_LessThan: fResult = iLeft < iRight; break;
+		case AB_LessThanEqual: fResult = iLeft <= iRight; break;
+		case AB_GreaterThan: fResult = iLeft > iRight; break;
+		case AB_GreaterThanEqual: fResult = iLeft >= iRight; break;
+		case AB_Equal: fResult = iLeft == iRight; break;
+		case AB_NotEqual: fResult = iLeft != iRight; break;
+		default: assert(!"FusedCompareJump: not a comparison"); fResult = false; break;
+		}
+		C4AulBCC *pCond = pCPos + 3;
+		if (fResult == (pCond->bccType == AB_COND))
+			return pCond + pCond->Par.i;
+		return pCond + 1;
+	}
 };
 
 extern C4AulExec AulExec;
@@ -234,29 +327,43 @@ extern C4AulExec AulExec;
 // script profiler entry
 class C4AulProfiler
 {
+public:
+	// statistics of other engine parts that are reset and shown along with the script times
+	class StatsSource
+	{
+	public:
+		StatsSource() { AddStatsSource(this); }
+		virtual ~StatsSource() { RemoveStatsSource(this); }
+		virtual void ResetStats() = 0;
+		virtual void ShowStats() = 0;
+	};
+	static void AddStatsSource(StatsSource *pSource);
+	static void RemoveStatsSource(StatsSource *pSource);
+
 private:
-	// map entry
+	static std::vector<StatsSource *> &GetStatsSources();
+
+	// summed up over all call stacks of a function
 	struct Entry
 	{
-		C4AulScriptFunc *pFunc;
-		uint32_t tProfileTime;
+		std::string Name;
+		uint64_t tInclusive, tExclusive;
+		uint32_t Calls;
 
-		bool operator < (const Entry &e2) const { return tProfileTime < e2.tProfileTime ; }
+		bool operator < (const Entry &e2) const { return tExclusive < e2.tExclusive; }
 	};
 
 	// items
 	std::vector<Entry> Times;
 
-	void CollectEntry(C4AulScriptFunc *pFunc, uint32_t tProfileTime);
-	void CollectTimes(C4PropListStatic * p);
-	void CollectTimes();
-	static void ResetTimes(C4PropListStatic * p);
-	static void ResetTimes();
+	void CollectTimes(const C4AulCallGraph &Graph);
 	void Show();
 public:
 	static void Abort() { AulExec.StopProfiling(); }
+	static bool IsProfiling() { return AulExec.IsProfiling(); }
 	static void StartProfiling(C4ScriptHost *pScript); // reset times and start collecting new ones
-	static void StopProfiling(); // stop the profiler and displays results
+	// stop the profiler and display results; also saves <base>.folded and <base>.json if a file name base is given
+	static void StopProfiling(const char *szFilenameBase = nullptr);
 };
 
 #endif // C4AULEXEC_H
@@ -25,6 +25,9 @@
 #include "object/C4GameObjects.h"
 #include "script/C4Effect.h"
 
+#include <atomic>
+#include <thread>
+
 void C4ScriptHost::DoAppend(C4Def *def)
 {
 	if (std::find(def->Script.SourceScripts.begin(), def->Script.SourceScripts.end(), this) == def->Script.SourceScripts.end())
@@ -162,10 +165,53 @@ void C4AulScriptEngine::UnLink()
 	// variable or constant at runtime by removing it from the script.
 }
 
+void C4AulScriptEngine::AddPendingPreparse(C4ScriptHost *pScript)
+{
+	// a reloaded script goes to the end, as if it was loaded only now
+	RemovePendingPreparse(pScript);
+	PendingPreparse.push_back(pScript);
+}
+
+void C4AulScriptEngine::RemovePendingPreparse(C4ScriptHost *pScript)
+{
+	PendingPreparse.erase(std::remove(PendingPreparse.begin(), PendingPreparse.end(), pScript), PendingPreparse.end());
+}
+
+// fewer scripts aren't worth starting another thread
+static const size_t MinScriptsPerPreparseThread = 8;
+
+void C4AulScriptEngine::PreparseScripts()
+{
+	std::vector<C4ScriptHost *> Scripts;
+	Scripts.swap(PendingPreparse);
+	// Building the syntax trees only touches each script itself, so spread
+	// that over all cores. Hundreds of definitions make this worthwhile.
+	std::atomic<size_t> iNext{0};
+	auto ParseScripts = [&Scripts, &iNext]()
+	{
+		for (size_t i; (i = iNext++) < Scripts.size(); )
+			Scripts[i]->ParseSyntaxTree();
+	};
+	size_t iThreads = std::min<size_t>(std::thread::hardware_concurrency(), Scripts.size() / MinScriptsPerPreparseThread);
+	std::vector<std::thread> Threads;
+	for (size_t i = 1; i < iThreads; ++i)
+		Threads.emplace_back(ParseScripts);
+	ParseScripts();
+	for (std::thread &Thread : Threads)
+		Thread.join();
+	// Functions and variables are registered in load order, so later scripts
+	// overload earlier ones and messages come out the same on every run
+	for (C4ScriptHost *s : Scripts)
+		s->FinishPreparse();
+}
+
 void C4AulScriptEngine::Link(C4DefList *rDefs)
 {
 	try
 	{
+		// preparse new scripts
+		PreparseScripts();
+
 		// resolve appends
 		for (C4ScriptHost *s = Child0; s; s = s->Next)
 			s->ResolveAppends(rDefs);
@@ -138,10 +138,29 @@ void C4AulParse::Warn(C4AulWarningId warning, ...)
 	StdStrBuf Buf = FormatStringV(C4AulWarningMessages[static_cast<size_t>(warning)], args);
 	AppendPosition(Buf);
 	Buf.AppendFormat(" [%s]", C4AulWarningIDs[static_cast<size_t>(warning)]);
-	Engine->GetErrorHandler()->OnWarning(Buf.getData());
+	ReportWarning(Buf.getData());
 	va_end(args);
 }
 
+void C4AulParse::ReportWarning(const char *szMessage)
+{
+	if (DeferredMessages)
+		DeferredMessages->emplace_back(false, szMessage);
+	else
+		Engine->GetErrorHandler()->OnWarning(szMessage);
+}
+
+void C4AulParse::ReportError(const char *szMessage)
+{
+	if (DeferredMessages)
+	{
+		DeferredMessages->emplace_back(true, szMessage);
+		return;
+	}
+	++Engine->errCnt;
+	::ScriptEngine.ErrorHandler->OnError(szMessage);
+}
+
 bool C4AulParse::IsWarningEnabled(const char *pos, C4AulWarningId warning) const
 {
 	if (pOrgScript) return pOrgScript->IsWarningEnabled(pos, warning);
@@ -360,10 +379,10 @@ int C4AulParse::GetOperator(const char* pScript)
 
 void C4AulParse::ClearToken()
 {
-	// if last token was a string, make sure its ref is deleted
-	if (TokenType == ATT_STRING && cStr)
+	// if last token was a string, free its contents
+	if (TokenType == ATT_STRING)
 	{
-		cStr->DecRef();
+		cStr.clear();
 		TokenType = ATT_INVALID;
 	}
 }
@@ -511,9 +530,9 @@ C4AulTokenType C4AulParse::GetNextToken()
 				strbuf.push_back(C);
 		}
 		++SPos;
-		cStr = Strings.RegString(StdStrBuf(strbuf.data(),strbuf.size()));
-		// hold onto string, ClearToken will deref it
-		cStr->IncRef();
+		// Not registered in the string table yet, so scripts can be parsed in
+		// parallel. Like C4Strings, the constant ends at the first null character.
+		cStr.assign(strbuf.c_str());
 		return ATT_STRING;
 	}
 	else if (C == '[') return ATT_BOPEN2; // "["
@@ -602,16 +621,19 @@ static const char * GetTTName(C4AulBCCType e)
 	case AB_RETURN: return "RETURN";  // return statement
 	case AB_ERR: return "ERR";      // parse error at this position
 	case AB_DEBUG: return "DEBUG";      // debug break
+	case AB_CMPJUMP_LOCALN_INT: return "CMPJUMP_LOCALN_INT"; // LOCALN, INT, comparison, COND or CONDN
+	case AB_CMPJUMP_DUP_INT: return "CMPJUMP_DUP_INT"; // DUP, INT, comparison, COND or CONDN
+	case AB_CMPJUMP_DUP_DUP: return "CMPJUMP_DUP_DUP"; // DUP, DUP, comparison, COND or CONDN
 	case AB_EOFN: return "EOFN";    // end of function
 	}
 	assert(false); return "UNKNOWN";
 }
 
-void C4AulScriptFunc::DumpByteCode()
+void C4AulScriptFunc::DumpByteCode(const char *szStage)
 {
-	if (DEBUG_BYTECODE_DUMP)
+	if (DEBUG_BYTECODE_DUMP || ::ScriptEngine.fDumpByteCode)
 	{
-		fprintf(stderr, "%s:\n", GetName());
+		fprintf(stderr, "%s (%s):\n", GetName(), szStage);
 		std::map<C4AulBCC *, int> labels;
 		int labeln = 0;
 		for (auto & bcc: Code)
@@ -636,6 +658,7 @@ void C4AulScriptFunc::DumpByteCode()
 			case AB_ERR:
 				if (bcc.Par.s)
 			case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+			case AB_CMPJUMP_LOCALN_INT:
 				fprintf(stderr, "\t%s\n", bcc.Par.s->GetCStr()); break;
 			case AB_STRING:
 			{
@@ -695,16 +718,15 @@ bool C4ScriptHost::Preparse()
 	// handle easiest case first
 	if (State < ASS_NONE) return false;
 
-	// clear stuff
-	Includes.clear(); Appends.clear();
-
-	GetPropList()->C4PropList::Clear();
-	GetPropList()->SetProperty(P_Prototype, C4VPropList(Engine->GetPropList()));
-	LocalValues.Clear();
-
-	// Add any engine functions specific to this script
-	AddEngineFunctions();
+	// Parsed together with the other scripts loaded before the next link,
+	// see C4AulScriptEngine::PreparseScripts
+	Engine->AddPendingPreparse(this);
+	return true;
+}
 
+void C4ScriptHost::ParseSyntaxTree()
+{
+	// This runs on worker threads, so only touch this host
 	// Insert default warnings
 	assert(enabledWarnings.empty());
 	auto &warnings = enabledWarnings[Script.getData()];
@@ -713,7 +735,32 @@ bool C4ScriptHost::Preparse()
 #undef DIAG
 
 	C4AulParse parser(this);
+	parser.DeferredMessages = &PreparseMessages;
 	ast = parser.Parse_Script(this);
+}
+
+void C4ScriptHost::FinishPreparse()
+{
+	// report what the parser found
+	for (auto &Message : PreparseMessages)
+		if (Message.first)
+		{
+			++Engine->errCnt;
+			Engine->ErrorHandler->OnError(Message.second.c_str());
+		}
+		else
+			Engine->GetErrorHandler()->OnWarning(Message.second.c_str());
+	PreparseMessages.clear();
+
+	// clear stuff
+	Includes.clear(); Appends.clear();
+
+	GetPropList()->C4PropList::Clear();
+	GetPropList()->SetProperty(P_Prototype, C4VPropList(Engine->GetPropList()));
+	LocalValues.Clear();
+
+	// Add any engine functions specific to this script
+	AddEngineFunctions();
 
 	C4AulCompiler::Preparse(this, this, ast.get());
 
@@ -722,10 +769,9 @@ bool C4ScriptHost::Preparse()
 
 	// Parse will write the properties back after the ones from included scripts
 	GetPropList()->Properties.Swap(&LocalValues);
+	C4PropList::InvalidateLookups();
 
-	// return success
 	this->State = ASS_PREPARSED;
-	return true;
 }
 
 static const char * GetTokenName(C4AulTokenType TokenType)
@@ -953,10 +999,7 @@ std::unique_ptr<::aul::ast::Script> C4AulParse::Parse_Script(C4ScriptHost * scri
 	catch (C4AulError &err)
 	{
 		if (first_error)
-		{
-			++Engine->errCnt;
-			::ScriptEngine.ErrorHandler->OnError(err.what());
-		}
+			ReportError(err.what());
 		first_error = false;
 	}
 }
@@ -1257,7 +1300,7 @@ std::unique_ptr<::aul::ast::ProplistLit> C4AulParse::Parse_PropList()
 		}
 		else if (TokenType == ATT_STRING)
 		{
-			key = cStr->GetCStr();
+			key = cStr;
 			Shift();
 		}
 		else UnexpectedToken("string or identifier");
@@ -1490,7 +1533,7 @@ std::unique_ptr<::aul::ast::Expr> C4AulParse::Parse_Expression(int iParentPrio)
 		Shift();
 		break;
 	case ATT_STRING: // reference in cStr
-		expr = ::aul::ast::StringLit::New(NodeStart, cStr->GetCStr());
+		expr = ::aul::ast::StringLit::New(NodeStart, cStr.c_str());
 		Shift();
 		break;
 	case ATT_OPERATOR:
@@ -1687,17 +1730,18 @@ std::unique_ptr<::aul::ast::VarDecl> C4AulParse::Parse_Var()
 	}
 }
 
-void C4ScriptHost::CopyPropList(C4Set<C4Property> & from, C4PropListStatic * to)
+void C4ScriptHost::CopyPropList(C4PropertyStore & from, C4PropListStatic * to)
 {
 	// append all funcs and local variable initializations
-	const C4Property * prop = from.First();
-	while (prop)
+	for (int32_t i = from.First(); i >= 0; i = from.Next(i))
 	{
-		switch(prop->Value.GetType())
+		C4String *key = from.GetKey(i);
+		const C4Value &value = from.GetValue(i);
+		switch(value.GetType())
 		{
 		case C4V_Function:
 			{
-				C4AulScriptFunc * sf = prop->Value.getFunction()->SFunc();
+				C4AulScriptFunc * sf = value.getFunction()->SFunc();
 				if (sf)
 				{
 					C4AulScriptFunc *sfc;
@@ -1706,33 +1750,32 @@ void C4ScriptHost::CopyPropList(C4Set<C4Property> & from, C4PropListStatic * to)
 					else
 						sfc = sf;
 					sfc->SetOverloaded(to->GetFunc(sf->Name));
-					to->SetPropertyByS(prop->Key, C4VFunction(sfc));
+					to->SetPropertyByS(key, C4VFunction(sfc));
 				}
 				else
 				{
 					// engine function
-					to->SetPropertyByS(prop->Key, prop->Value);
+					to->SetPropertyByS(key, value);
 				}
 			}
 			break;
 		case C4V_PropList:
 			{
-				C4PropListStatic * p = prop->Value._getPropList()->IsStatic();
+				C4PropListStatic * p = value._getPropList()->IsStatic();
 				assert(p);
-				if (prop->Key != &::Strings.P[P_Prototype])
+				if (key != &::Strings.P[P_Prototype])
 					if (!p || p->GetParent() != to)
 					{
-						p = C4PropList::NewStatic(nullptr, to, prop->Key);
-						CopyPropList(prop->Value._getPropList()->Properties, p);
+						p = C4PropList::NewStatic(nullptr, to, key);
+						CopyPropList(value._getPropList()->Properties, p);
 					}
-				to->SetPropertyByS(prop->Key, C4VPropList(p));
+				to->SetPropertyByS(key, C4VPropList(p));
 			}
 			break;
 		case C4V_Array: // FIXME: copy the array if necessary
 		default:
-			to->SetPropertyByS(prop->Key, prop->Value);
+			to->SetPropertyByS(key, value);
 		}
-		prop = from.Next(prop);
 	}
 }
 
@@ -51,6 +51,10 @@ public:
 	std::unique_ptr<::aul::ast::FunctionDecl> Parse_DirectExec(const char *code, bool whole_function);
 	std::unique_ptr<::aul::ast::Script> Parse_Script(C4ScriptHost *);
 
+	// Set when parsing on a worker thread: warnings and errors are collected
+	// there and reported later by C4ScriptHost::FinishPreparse.
+	std::vector<std::pair<bool, std::string>> *DeferredMessages{nullptr}; // (is error, message)
+
 private:
 	C4AulScriptFunc *Fn; C4ScriptHost * Host; C4ScriptHost * pOrgScript;
 	C4AulScriptEngine *Engine;
@@ -59,7 +63,7 @@ private:
 	char Idtf[C4AUL_MAX_Identifier]; // current identifier
 	C4AulTokenType TokenType; // current token type
 	int32_t cInt; // current int constant
-	C4String * cStr; // current string constant
+	std::string cStr; // current string constant
 	C4AulScriptContext* ContextToExecIn;
 	void Parse_Function(bool parse_for_direct_exec);
 	void Parse_WarningPragma();
@@ -95,6 +99,8 @@ private:
 	NORETURN void UnexpectedToken(const char * Expected);
 
 	void Warn(C4AulWarningId warning, ...);
+	void ReportWarning(const char *szMessage);
+	void ReportError(const char *szMessage);
 	bool IsWarningEnabled(const char *pos, C4AulWarningId warning) const;
 	void Error(const char *pMsg, ...) GNUC_FORMAT_ATTRIBUTE_O;
 	void AppendPosition(StdStrBuf & Buf);
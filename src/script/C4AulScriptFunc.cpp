@@ -24,8 +24,7 @@ C4AulScriptFunc::C4AulScriptFunc(C4PropListStatic * Parent, C4ScriptHost *pOrgSc
 		OwnerOverloaded(nullptr),
 		ParCount(0),
 		Script(Script),
-		pOrgScript(pOrgScript),
-		tProfileTime(0)
+		pOrgScript(pOrgScript)
 {
 	for (auto & i : ParType) i = C4V_Any;
 	AddBCC(AB_EOFN);
@@ -38,8 +37,7 @@ C4AulScriptFunc::C4AulScriptFunc(C4PropListStatic * Parent, const C4AulScriptFun
 		Script(FromFunc.Script),
 		VarNamed(FromFunc.VarNamed),
 		ParNamed(FromFunc.ParNamed),
-		pOrgScript(FromFunc.pOrgScript),
-		tProfileTime(0)
+		pOrgScript(FromFunc.pOrgScript)
 {
 	for (int i = 0; i < C4AUL_MAX_Par; i++)
 		ParType[i] = FromFunc.ParType[i];
@@ -76,9 +74,355 @@ void C4AulScriptFunc::ClearCode()
 {
 	Code.clear();
 	PosForCode.clear();
+	LookupCaches.clear();
 	// This function is now broken until an AddBCC call
 }
 
+static bool IsFusableComparison(C4AulBCCType eType)
+{
+	switch (eType)
+	{
+	case AB_LessThan: case AB_LessThanEqual: case AB_GreaterThan: case AB_GreaterThanEqual:
+	case AB_Equal: case AB_NotEqual:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void C4AulScriptFunc::FuseSuperInstructions()
+{
+	// Only the type of the first instruction of a sequence is replaced. The others stay in place,
+	// so jumps into the sequence and the code positions for error messages remain valid.
+	for (size_t i = 0; i + 3 < Code.size(); ++i)
+	{
+		C4AulBCC *pCPos = &Code[i];
+		if (!IsFusableComparison(pCPos[2].bccType) || (pCPos[3].bccType != AB_COND && pCPos[3].bccType != AB_CONDN))
+			continue;
+		if (pCPos[0].bccType == AB_LOCALN && pCPos[1].bccType == AB_INT)
+			pCPos[0].bccType = AB_CMPJUMP_LOCALN_INT;
+		else if (pCPos[0].bccType == AB_DUP && pCPos[1].bccType == AB_INT)
+			pCPos[0].bccType = AB_CMPJUMP_DUP_INT;
+		else if (pCPos[0].bccType == AB_DUP && pCPos[1].bccType == AB_DUP)
+			pCPos[0].bccType = AB_CMPJUMP_DUP_DUP;
+		else
+			continue;
+		i += 3;
+	}
+}
+
+static bool IsJump(C4AulBCCType eType)
+{
+	switch (eType)
+	{
+	case AB_JUMP: case AB_JUMPAND: case AB_JUMPOR: case AB_JUMPNNIL: case AB_CONDN: case AB_COND:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Instructions that push a single value and have no other effect
+static bool IsPurePush(C4AulBCCType eType)
+{
+	switch (eType)
+	{
+	case AB_INT: case AB_BOOL: case AB_NIL: case AB_STRING: case AB_CPROPLIST: case AB_CARRAY: case AB_CFUNCTION:
+	case AB_DUP: case AB_THIS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool GetConstant(const C4AulBCC &bcc, C4Value &value)
+{
+	switch (bcc.bccType)
+	{
+	case AB_INT: value.SetInt(bcc.Par.i); return true;
+	case AB_BOOL: value.SetBool(!!bcc.Par.i); return true;
+	case AB_NIL: value.Set0(); return true;
+	default: return false;
+	}
+}
+
+static void SetConstant(C4AulBCC &bcc, const C4Value &value)
+{
+	// Only used on INT, BOOL and NIL instructions, which hold no references
+	assert(bcc.bccType == AB_INT || bcc.bccType == AB_BOOL || bcc.bccType == AB_NIL);
+	if (value.GetType() == C4V_Bool)
+	{
+		bcc.bccType = AB_BOOL;
+		bcc.Par.X = value._getBool();
+	}
+	else
+	{
+		bcc.bccType = AB_INT;
+		bcc.Par.X = value._getInt();
+	}
+}
+
+// Evaluate an operator on constant operands the same way C4AulExec does. Returns false for
+// everything that might throw at runtime, so the error is still raised when the code runs.
+static bool FoldUnary(C4AulBCCType eType, const C4Value &a, C4Value &result)
+{
+	if (eType == AB_Not)
+	{
+		result.SetBool(!a.getBool());
+		return true;
+	}
+	if (a.GetType() != C4V_Int)
+		return false;
+	// Overflow wraps around like it does in the interpreter
+	uint32_t ua = a._getInt();
+	switch (eType)
+	{
+	case AB_BitNot: result.SetInt(~a._getInt()); return true;
+	case AB_Neg: result.SetInt(int32_t(0u - ua)); return true;
+	case AB_Inc: result.SetInt(int32_t(ua + 1u)); return true;
+	case AB_Dec: result.SetInt(int32_t(ua - 1u)); return true;
+	default: return false;
+	}
+}
+
+static bool FoldBinary(C4AulBCCType eType, const C4Value &a, const C4Value &b, C4Value &result)
+{
+	switch (eType)
+	{
+	case AB_Equal: result.SetBool(a.IsIdenticalTo(b)); return true;
+	case AB_NotEqual: result.SetBool(!a.IsIdenticalTo(b)); return true;
+	default: break;
+	}
+	if (a.GetType() != C4V_Int || b.GetType() != C4V_Int)
+		return false;
+	int32_t ia = a._getInt(), ib = b._getInt();
+	uint32_t ua = ia, ub = ib;
+	switch (eType)
+	{
+	case AB_Pow: result.SetInt(Pow(ia, ib)); return true;
+	case AB_Div:
+		if (!ib || (ia == INT32_MIN && ib == -1))
+			return false;
+		result.SetInt(ia / ib); return true;
+	case AB_Mod:
+		if (!ib || (ia == INT32_MIN && ib == -1))
+			return false;
+		result.SetInt(ia % ib); return true;
+	case AB_Mul: result.SetInt(int32_t(ua * ub)); return true;
+	case AB_Sub: result.SetInt(int32_t(ua - ub)); return true;
+	case AB_Sum: result.SetInt(int32_t(ua + ub)); return true;
+	case AB_LeftShift:
+		if (ib < 0 || ib > 31)
+			return false;
+		result.SetInt(int32_t(ua << ib)); return true;
+	case AB_RightShift:
+		if (ib < 0 || ib > 31)
+			return false;
+		result.SetInt(ia >> ib); return true;
+	case AB_LessThan: result.SetBool(ia < ib); return true;
+	case AB_LessThanEqual: result.SetBool(ia <= ib); return true;
+	case AB_GreaterThan: result.SetBool(ia > ib); return true;
+	case AB_GreaterThanEqual: result.SetBool(ia >= ib); return true;
+	case AB_BitAnd: result.SetInt(ia & ib); return true;
+	case AB_BitXOr: result.SetInt(ia ^ ib); return true;
+	case AB_BitOr: result.SetInt(ia | ib); return true;
+	default: return false;
+	}
+}
+
+// Decide whether a conditional jump on a constant is taken, and whether it pops the constant
+static bool EvalConstantJump(C4AulBCCType eType, const C4Value &cond, bool &taken, bool &pops)
+{
+	switch (eType)
+	{
+	case AB_COND: taken = cond.getBool(); pops = true; return true;
+	case AB_CONDN: taken = !cond.getBool(); pops = true; return true;
+	case AB_JUMPAND: taken = !cond.getBool(); pops = false; return true;
+	case AB_JUMPOR: taken = cond.getBool(); pops = false; return true;
+	case AB_JUMPNNIL: taken = cond.GetType() != C4V_Nil; pops = false; return true;
+	default: return false;
+	}
+}
+
+void C4AulScriptFunc::OptimizeCode()
+{
+	// Leave functions with parse errors alone
+	for (C4AulBCC &bcc : Code)
+		if (bcc.bccType == AB_ERR)
+			return;
+	while (OptimizeCodePass()) {}
+}
+
+bool C4AulScriptFunc::OptimizeCodePass()
+{
+	const size_t n = Code.size();
+	assert(n && Code.back().bccType == AB_EOFN);
+	// Find reachable code and jump targets. FOREACH_NEXT implicitly jumps over the instruction
+	// behind it, which therefore has to stay in place.
+	std::vector<bool> reachable(n), target(n), pinned(n), removed(n);
+	std::vector<size_t> todo(1, 0);
+	while (!todo.empty())
+	{
+		size_t i = todo.back(); todo.pop_back();
+		if (i >= n || reachable[i]) continue;
+		reachable[i] = true;
+		const C4AulBCC &bcc = Code[i];
+		if (IsJump(bcc.bccType))
+		{
+			target[i + bcc.Par.i] = true;
+			todo.push_back(i + bcc.Par.i);
+		}
+		if (bcc.bccType == AB_FOREACH_NEXT)
+		{
+			pinned[i + 1] = true;
+			target[i + 2] = true;
+			todo.push_back(i + 2);
+		}
+		if (bcc.bccType != AB_JUMP && bcc.bccType != AB_RETURN && bcc.bccType != AB_EOFN)
+			todo.push_back(i + 1);
+	}
+	pinned[n - 1] = true;
+	bool changed = false;
+	for (size_t i = 0; i < n; ++i)
+		if (!reachable[i] && !pinned[i])
+			removed[i] = changed = true;
+	auto Next = [&](size_t i) { do ++i; while (i < n && removed[i]); return i; };
+	auto Remove = [&](size_t i) { assert(!pinned[i]); removed[i] = changed = true; };
+
+	// Local rewrites. Apart from their first instruction, the rewritten sequences must not be
+	// jump targets, so that every path through them is known.
+	C4Value a, b, result;
+	for (size_t i = 0; i < n; i = Next(i))
+	{
+		if (removed[i] || pinned[i]) continue;
+		C4AulBCC &bcc = Code[i];
+		size_t j = Next(i);
+		if (j >= n || target[j] || pinned[j]) continue;
+		C4AulBCC &bcc2 = Code[j];
+		if (GetConstant(bcc, a))
+		{
+			// Constant unary operator
+			if (FoldUnary(bcc2.bccType, a, result))
+			{
+				SetConstant(bcc, result);
+				Remove(j);
+				continue;
+			}
+			// Constant binary operator
+			size_t k = Next(j);
+			if (GetConstant(bcc2, b) && k < n && !target[k] && !pinned[k] && FoldBinary(Code[k].bccType, a, b, result))
+			{
+				SetConstant(bcc, result);
+				Remove(j); Remove(k);
+				continue;
+			}
+			// Conditional jump on a constant
+			bool taken, pops;
+			if (EvalConstantJump(bcc2.bccType, a, taken, pops))
+			{
+				if (!taken)
+				{
+					Remove(i); Remove(j);
+				}
+				else if (pops)
+				{
+					bcc.bccType = AB_JUMP;
+					bcc.Par.X = intptr_t(j - i) + bcc2.Par.i;
+					Remove(j);
+				}
+				else
+				{
+					bcc2.bccType = AB_JUMP;
+					changed = true;
+				}
+				continue;
+			}
+		}
+		if (bcc.bccType == AB_STACK && !bcc.Par.i)
+		{
+			Remove(i);
+		}
+		else if (bcc.bccType == AB_STACK && bcc2.bccType == AB_STACK && (bcc.Par.i > 0 || bcc2.Par.i < 0))
+		{
+			// Pushing nils and popping them again, or two pushes or pops in a row
+			bcc.Par.X = bcc.Par.i + bcc2.Par.i;
+			Remove(j);
+		}
+		else if (IsPurePush(bcc.bccType) && bcc2.bccType == AB_STACK && bcc2.Par.i < 0)
+		{
+			// Values that are popped right away
+			bcc2.Par.X = bcc2.Par.i + 1;
+			Remove(i);
+		}
+	}
+
+	// Jump threading: Jumps to unconditional jumps go to their target directly
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (removed[i] || !IsJump(Code[i].bccType)) continue;
+		size_t t = i + Code[i].Par.i;
+		for (size_t hops = 0; hops < n && Code[t].bccType == AB_JUMP; ++hops)
+			t += Code[t].Par.i;
+		// Leave endless loops alone
+		if (Code[t].bccType == AB_JUMP || t == i + Code[i].Par.i) continue;
+		Code[i].Par.X = intptr_t(t) - intptr_t(i);
+		changed = true;
+	}
+	// Jumps to the next remaining instruction do nothing
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (removed[i] || pinned[i] || Code[i].bccType != AB_JUMP || Code[i].Par.i <= 0) continue;
+		size_t t = i + Code[i].Par.i;
+		if (Next(i) >= t)
+			Remove(i);
+	}
+	if (!changed)
+		return false;
+
+	// Remove the instructions and relocate jumps to the first remaining instruction at or
+	// behind their previous target
+	std::vector<size_t> new_pos(n);
+	size_t count = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		new_pos[i] = count;
+		if (!removed[i]) ++count;
+	}
+	for (size_t i = 0; i < n; ++i)
+		if (!removed[i] && IsJump(Code[i].bccType))
+			Code[i].Par.X = intptr_t(new_pos[i + Code[i].Par.i]) - intptr_t(new_pos[i]);
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (removed[i]) continue;
+		if (new_pos[i] != i)
+		{
+			Code[new_pos[i]] = std::move(Code[i]);
+			PosForCode[new_pos[i]] = PosForCode[i];
+		}
+	}
+	Code.resize(count);
+	PosForCode.resize(count);
+	return true;
+}
+
+void C4AulScriptFunc::AddLookupCaches()
+{
+	LookupCaches.clear();
+	for (C4AulBCC &bcc : Code)
+	{
+		switch (bcc.bccType)
+		{
+		case AB_LOCALN: case AB_PROP: case AB_CALL: case AB_CALLFS: case AB_CMPJUMP_LOCALN_INT:
+			bcc.LookupCache = LookupCaches.size();
+			LookupCaches.emplace_back();
+			break;
+		default:
+			bcc.LookupCache = -1;
+			break;
+		}
+	}
+}
+
 int C4AulScriptFunc::GetLineOfCode(C4AulBCC * bcc)
 {
 	return SGetLine(pOrgScript ? pOrgScript->GetScript() : Script, PosForCode[bcc - &Code[0]]);
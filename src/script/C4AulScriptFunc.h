@@ -89,7 +89,11 @@ enum C4AulBCCType : int
 	AB_RETURN,  // return statement
 	AB_ERR,     // parse error at this position
 	AB_DEBUG,   // debug break
-	AB_EOFN,    // end of function
+	// superinstructions, created after compilation; the fused instructions stay in place behind them and provide their operands
+	AB_CMPJUMP_LOCALN_INT, // LOCALN, INT, comparison, COND or CONDN
+	AB_CMPJUMP_DUP_INT,    // DUP, INT, comparison, COND or CONDN
+	AB_CMPJUMP_DUP_DUP,    // DUP, DUP, comparison, COND or CONDN
+	AB_EOFN,    // end of function; must stay the last entry
 };
 
 // byte code chunk
@@ -97,6 +101,7 @@ class C4AulBCC
 {
 public:
 	C4AulBCCType bccType{AB_EOFN}; // chunk type
+	int32_t LookupCache{-1}; // index into the function's LookupCaches, or -1
 	union
 	{
 		intptr_t X;
@@ -111,16 +116,17 @@ public:
 	{
 		IncRef();
 	}
-	C4AulBCC(const C4AulBCC & from): C4AulBCC(from.bccType, from.Par.X) { }
+	C4AulBCC(const C4AulBCC & from): C4AulBCC(from.bccType, from.Par.X) { LookupCache = from.LookupCache; }
 	C4AulBCC & operator = (const C4AulBCC & from)
 	{
 		DecRef();
 		bccType = from.bccType;
+		LookupCache = from.LookupCache;
 		Par = from.Par;
 		IncRef();
 		return *this;
 	}
-	C4AulBCC(C4AulBCC && from): bccType(from.bccType), Par(from.Par)
+	C4AulBCC(C4AulBCC && from): bccType(from.bccType), LookupCache(from.LookupCache), Par(from.Par)
 	{
 		from.bccType = AB_EOFN;
 	}
@@ -128,6 +134,7 @@ public:
 	{
 		DecRef();
 		bccType = from.bccType;
+		LookupCache = from.LookupCache;
 		Par = from.Par;
 		from.bccType = AB_EOFN;
 		return *this;
@@ -144,6 +151,7 @@ private:
 		case AB_ERR:
 			if (Par.s)
 		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_CMPJUMP_LOCALN_INT:
 			Par.s->IncRef();
 			break;
 		case AB_CARRAY:
@@ -159,6 +167,7 @@ private:
 		case AB_ERR:
 			if (Par.s)
 		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_CMPJUMP_LOCALN_INT:
 			Par.s->DecRef();
 			break;
 		case AB_CARRAY:
@@ -183,8 +192,13 @@ protected:
 	int GetCodePos() const { return Code.size(); }
 	C4AulBCC *GetCodeByPos(int iPos) { return &Code[iPos]; }
 	C4AulBCC *GetLastCode() { return Code.empty() ? nullptr : &Code.back(); }
-	void DumpByteCode();
+	void DumpByteCode(const char *szStage);
+	void OptimizeCode(); // constant folding, dead code elimination and jump threading on the byte code
+	bool OptimizeCodePass();
+	void FuseSuperInstructions(); // replace common instruction sequences by superinstructions
+	void AddLookupCaches(); // give every property and function lookup its inline cache
 	std::vector<C4AulBCC> Code;
+	std::vector<C4PropListLookupCache> LookupCaches;
 	std::vector<const char *> PosForCode;
 	int ParCount;
 	C4V_Type ParType[C4AUL_MAX_Par]; // parameter types
@@ -218,8 +232,7 @@ public:
 
 	int GetLineOfCode(C4AulBCC * bcc);
 	C4AulBCC * GetCode();
-
-	uint32_t tProfileTime; // internally set by profiler
+	C4PropListLookupCache &GetLookupCache(const C4AulBCC *bcc) { return LookupCaches[bcc->LookupCache]; }
 
 	friend class C4AulCompiler;
 	friend class C4AulParse;
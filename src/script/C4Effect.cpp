@@ -47,7 +47,7 @@ C4Effect::C4Effect(C4Effect **ppEffectList, C4String *szName, int32_t iPrio, int
 	// assign values
 	iPriority = 0; // effect is not yet valid; some callbacks to other effects are done before
 	iInterval = iTimerInterval;
-	iTime = 0;
+	iTimeBase = 0;
 	CommandTarget.SetPropList(pCmdTarget);
 	AcquireNumber();
 	Register(ppEffectList, iPrio);
@@ -61,7 +61,7 @@ C4Effect::C4Effect(C4Effect **ppEffectList, C4PropList * prototype, int32_t iPri
 	// assign values
 	iPriority = 0; // effect is not yet valid; some callbacks to other effects are done before
 	iInterval = iTimerInterval;
-	iTime = 0;
+	iTimeBase = 0;
 	CommandTarget.Set0();
 	AcquireNumber();
 	Register(ppEffectList, iPrio);
@@ -70,6 +70,12 @@ C4Effect::C4Effect(C4Effect **ppEffectList, C4PropList * prototype, int32_t iPri
 
 void C4Effect::Register(C4Effect **ppEffectList, int32_t iPrio)
 {
+	// share the clock of the list, keeping the effect time
+	int32_t iTime = GetTime();
+	Clock = *ppEffectList ? (*ppEffectList)->Clock : std::make_shared<C4EffectListClock>();
+	SetTime(iTime);
+	// the effect is dead until it has been initialized
+	Clock->fDirty = true;
 	// get effect target
 	C4Effect *pCheck, *pPrev = *ppEffectList;
 	if (pPrev && Abs(pPrev->iPriority) < iPrio)
@@ -156,7 +162,7 @@ C4Effect * C4Effect::Init(C4PropList *pForObj, int32_t iPrio, const C4Value &rVa
 C4Effect::C4Effect()
 {
 	// defaults
-	iPriority=iTime=iInterval=0;
+	iPriority=iInterval=iTimeBase=0;
 	CommandTarget.Set0();
 	pNext = nullptr;
 }
@@ -202,9 +208,27 @@ void C4Effect::ClearPointers(C4PropList *pObj)
 	while ((pEff=pEff->pNext));
 }
 
+void C4Effect::SetTime(int32_t iTime)
+{
+	if (!Clock) return;
+	iTimeBase = Clock->Ticks - iTime;
+	ScheduleTimer();
+}
+
+void C4Effect::ScheduleTimer()
+{
+	if (!Clock || !iInterval) return;
+	// the timer is due at the next nonzero multiple of the interval
+	int64_t iTime = GetTime(), iAbsInterval = Abs<int64_t>(iInterval);
+	int64_t iNextTime = iTime - ((iTime % iAbsInterval) + iAbsInterval) % iAbsInterval + iAbsInterval;
+	if (!iNextTime) iNextTime = iAbsInterval;
+	Clock->NextDue = std::min<int64_t>(Clock->NextDue, Clock->Ticks + (iNextTime - iTime));
+}
+
 void C4Effect::SetDead()
 {
 	iPriority = 0;
+	if (Clock) Clock->fDirty = true;
 }
 
 C4Effect *C4Effect::Get(const char *szName, int32_t iIndex, int32_t iMaxPriority)
@@ -296,13 +320,16 @@ C4Effect* C4Effect::Check(const char *szCheckEffect, int32_t iPrio, int32_t iTim
 
 void C4Effect::Execute(C4Effect **ppEffectList)
 {
+	if (!*ppEffectList) return;
 	// advance all effect timers first; then do execution
 	// this prevents a possible endless loop if timers register into the same effect list with interval 1 while it is being executed
-	for (C4Effect *pEffect = *ppEffectList; pEffect; pEffect = pEffect->pNext)
-	{
-		// ignore dead status; adjusting their time doesn't hurt
-		++pEffect->iTime;
-	}
+	// ignore dead status; adjusting their time doesn't hurt
+	std::shared_ptr<C4EffectListClock> Clock = (*ppEffectList)->Clock;
+	++Clock->Ticks;
+	// nothing due and nothing to delete?
+	if (!Clock->fDirty && Clock->Ticks < Clock->NextDue) return;
+	Clock->fDirty = false;
+	Clock->NextDue = INT32_MAX;
 	// get effect list
 	// execute all effects not marked as dead
 	C4Effect *pEffect = *ppEffectList, **ppPrevEffect=ppEffectList;
@@ -321,18 +348,20 @@ void C4Effect::Execute(C4Effect **ppEffectList)
 		else
 		{
 			// check timer execution
-			if (pEffect->iInterval && !(pEffect->iTime % pEffect->iInterval) && pEffect->iTime)
+			int32_t iTime = pEffect->GetTime();
+			if (pEffect->iInterval && !(iTime % pEffect->iInterval) && iTime)
 			{
-				if (pEffect->CallTimer(pEffect->iTime) == C4Fx_Execute_Kill)
+				if (pEffect->CallTimer(iTime) == C4Fx_Execute_Kill)
 				{
 					// safety: this class got deleted!
-					if (pEffect->Target && !pEffect->Target->Status) return;
+					if (pEffect->Target && !pEffect->Target->Status) { Clock->fDirty = true; return; }
 					// timer function decided to finish it
 					pEffect->Kill();
 				}
 				// safety: this class got deleted!
-				if (pEffect->Target && !pEffect->Target->Status) return;
+				if (pEffect->Target && !pEffect->Target->Status) { Clock->fDirty = true; return; }
 			}
+			pEffect->ScheduleTimer();
 			// next effect
 			ppPrevEffect = &pEffect->pNext;
 			pEffect = pEffect->pNext;
@@ -546,6 +575,7 @@ void C4Effect::CompileFunc(StdCompiler *pComp, C4PropList * Owner, C4ValueNumber
 	// read priority
 	pComp->Value(iPriority); pComp->Separator();
 	// read time and intervall
+	int32_t iTime = GetTime();
 	pComp->Value(iTime); pComp->Separator();
 	pComp->Value(iInterval); pComp->Separator();
 	// read object number
@@ -589,9 +619,15 @@ void C4Effect::CompileFunc(StdCompiler *pComp, C4PropList * Owner, C4ValueNumber
 	}
 	else
 		pComp->Value(fNext);
-	if (!fNext) return;
 	// read next
-	pComp->Value(mkParAdapt(mkPtrAdaptNoNull(pNext), Owner, numbers));
+	if (fNext)
+		pComp->Value(mkParAdapt(mkPtrAdaptNoNull(pNext), Owner, numbers));
+	// all effects in the list share the clock of the last one
+	if (pComp->isDeserializer())
+	{
+		Clock = pNext ? pNext->Clock : std::make_shared<C4EffectListClock>();
+		SetTime(iTime);
+	}
 	// denumeration and callback assignment will be done later
 }
 
@@ -609,12 +645,12 @@ void C4Effect::SetPropertyByS(C4String * k, const C4Value & to)
 				return;
 			case P_Priority:
 				throw C4AulExecError("effect: Priority is readonly");
-			case P_Interval: iInterval = to.getInt(); return;
+			case P_Interval: iInterval = to.getInt(); ScheduleTimer(); return;
 			case P_CommandTarget:
 				throw C4AulExecError("effect: CommandTarget is readonly");
 			case P_Target:
 				throw C4AulExecError("effect: Target is readonly");
-			case P_Time: iTime = to.getInt(); return;
+			case P_Time: SetTime(to.getInt()); return;
 			case P_Prototype:
 				throw new C4AulExecError("effect: Prototype is readonly");
 		}
@@ -637,7 +673,7 @@ void C4Effect::ResetProperty(C4String * k)
 				throw C4AulExecError("effect: CommandTarget is readonly");
 			case P_Target:
 				throw C4AulExecError("effect: Target is readonly");
-			case P_Time: iTime = 0; return;
+			case P_Time: SetTime(0); return;
 			case P_Prototype:
 				throw new C4AulExecError("effect: Prototype is readonly");
 		}
@@ -656,7 +692,7 @@ bool C4Effect::GetPropertyByS(const C4String *k, C4Value *pResult) const
 			case P_Interval: *pResult = C4VInt(iInterval); return true;
 			case P_CommandTarget: *pResult = CommandTarget; return true;
 			case P_Target: *pResult = C4Value(Target); return true;
-			case P_Time: *pResult = C4VInt(iTime); return true;
+			case P_Time: *pResult = C4VInt(GetTime()); return true;
 		}
 	}
 	return C4PropListNumbered::GetPropertyByS(k, pResult);
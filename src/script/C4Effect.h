@@ -65,16 +65,27 @@
 #define C4Fx_FireParticle1   "Fire"
 #define C4Fx_FireParticle2   "Fire2"
 
+// Counts the executions of one effect list. All effects in a list share its clock and measure
+// their time against it, so executing the list only has to touch effects that are due.
+struct C4EffectListClock
+{
+	int32_t Ticks{0};
+	int32_t NextDue{0}; // no effect in the list is due before this tick
+	bool fDirty{true}; // walk the whole list on its next execution, e.g. to delete dead effects
+};
+
 // generic object effect
 class C4Effect: public C4PropListNumbered
 {
 public:
 	int32_t iPriority;          // effect priority for sorting into effect list; -1 indicates a dead effect
-	int32_t iTime, iInterval;  // effect time; effect callback intervall
+	int32_t iInterval;          // effect callback intervall
 
 	C4Effect *pNext;        // next effect in linked list
 
 protected:
+	std::shared_ptr<C4EffectListClock> Clock; // shared by all effects in the list
+	int32_t iTimeBase;      // clock tick at which the effect time was zero
 	C4Value CommandTarget; // target object for script callbacks - if deleted, the effect is removed without callbacks
 	C4PropList * Target; // target the effect is contained in
 	// presearched callback functions for faster calling
@@ -84,6 +95,7 @@ protected:
 	C4AulFunc *pFnDamage;          // callback when owned object gets damage
 
 	void AssignCallbackFunctions(); // resolve callback function names
+	void ScheduleTimer(); // make sure the list is executed when the timer is due next
 
 	int CallStart(int temporary, const C4Value &var1, const C4Value &var2, const C4Value &var3, const C4Value &var4);
 	int CallStop(int reason, bool temporary);
@@ -106,6 +118,8 @@ public:
 	void Denumerate(C4ValueNumbers *) override; // numbers to object pointers
 	void ClearPointers(C4PropList *pObj); // clear all pointers to object - may kill some effects w/o callback, because the callback target is lost
 
+	int32_t GetTime() const { return Clock ? Clock->Ticks - iTimeBase : 0; } // effect time
+	void SetTime(int32_t iTime);
 	void SetDead();                      // mark effect to be removed in next execution cycle
 	bool IsDead() { return !iPriority; } // return whether effect is to be removed
 	void FlipActive() { iPriority*=-1; } // alters activation status
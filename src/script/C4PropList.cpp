@@ -34,7 +34,15 @@ void C4PropList::DelRef(C4Value * pRef)
 	assert(erased == 1);
 	// Only pure script proplists are garbage collected here, host proplists
 	// like definitions and effects have their own memory management.
-	if (Refs.empty() && Delete()) delete this;
+	if (Refs.empty())
+	{
+		if (Delete()) delete this;
+	}
+	else if (script_heap)
+	{
+		// the remaining references might be a cycle
+		GetPropListScript()->ReferenceDropped();
+	}
 }
 
 C4PropList * C4PropList::New(C4PropList * prototype)
@@ -180,6 +188,16 @@ C4PropListNumbered::~C4PropListNumbered()
 		Log("removing numbered proplist without number");
 }
 
+void C4PropListScript::GetHeapChildren(std::vector<C4ScriptHeapObject *> &Children) const
+{
+	if (C4ScriptHeapObject *pChild = GetHeapObject(GetPrototypeValue()))
+		Children.push_back(pChild);
+	const C4PropertyStore &Store = GetPropertyStore();
+	for (int32_t i = Store.First(); i >= 0; i = Store.Next(i))
+		if (C4ScriptHeapObject *pChild = GetHeapObject(Store.GetValue(i)))
+			Children.push_back(pChild);
+}
+
 void C4PropListScript::ClearScriptPropLists()
 {
 	// empty all proplists to ensure safe deletion of proplists with circular references
@@ -286,6 +304,7 @@ C4PropListStatic *C4PropList::FreezeAndMakeStaticRecursively(std::vector<C4Value
 		// Make self static by creating a copy and replacing all references
 		this_static = NewStatic(GetPrototype(), parent, key);
 		this_static->Properties.Swap(&Properties); // grab properties
+		InvalidateLookups();
 		this_static->Status = Status;
 		RefSet pre_freeze_refs{Refs}; // copy to avoid iterator validity headaches
 		C4Value holder = C4VPropList(this); // add another reference to prevent premature deletion
@@ -320,18 +339,16 @@ C4PropListStatic *C4PropList::FreezeAndMakeStaticRecursively(std::vector<C4Value
 
 void C4PropList::Denumerate(C4ValueNumbers * numbers)
 {
-	const C4Property * p = Properties.First();
-	while (p)
-	{
-		const_cast<C4Value &>(p->Value).Denumerate(numbers);
-		p = Properties.Next(p);
-	}
+	for (int32_t i = Properties.First(); i >= 0; i = Properties.Next(i))
+		Properties.GetValue(i).Denumerate(numbers);
 	prototype.Denumerate(numbers);
 	RemoveCyclicPrototypes();
+	LookupChanged();
 }
 
 C4PropList::~C4PropList()
 {
+	LookupChanged();
 	for (C4Value * Ref : Refs)
 	{
 		// Manually kill references so DelRef doesn't destroy us again
@@ -350,17 +367,8 @@ bool C4PropList::operator==(const C4PropList &b) const
 	// every numbered proplist has a unique number and is only identical to itself
 	if (this == &b) return true;
 	if (IsNumbered() || b.IsNumbered()) return false;
-	if (Properties.GetSize() != b.Properties.GetSize()) return false;
 	if (GetDef() != b.GetDef()) return false;
-	const C4Property * p = Properties.First();
-	while (p)
-	{
-		const C4Property & bp = b.Properties.Get(p->Key);
-		if (!bp) return false;
-		if (p->Value != bp.Value) return false;
-		p = Properties.Next(p);
-	}
-	return true;
+	return Properties == b.Properties;
 }
 
 void C4PropList::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
@@ -368,6 +376,7 @@ void C4PropList::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	bool oldFormat = false;
 	// constant proplists are not serialized to savegames, but recreated from the game data instead
 	assert(!constant);
+	LookupChanged();
 	if (pComp->isDeserializer() && pComp->hasNaming())
 	{
 		// backwards compat to savegames and scenarios before 5.5
@@ -388,9 +397,9 @@ void C4PropList::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	pComp->Value(mkParAdapt(Properties, numbers));
 	if (oldFormat)
 	{
-		if (Properties.Has(&::Strings.P[P_Prototype]))
+		if (const C4Value *pt = Properties.Find(&::Strings.P[P_Prototype]))
 		{
-			prototype = Properties.Get(&::Strings.P[P_Prototype]).Value;
+			prototype = *pt;
 			Properties.Remove(&::Strings.P[P_Prototype]);
 		}
 	}
@@ -403,6 +412,7 @@ void C4PropList::RemoveCyclicPrototypes()
 	for(C4PropList * it = prototype.getPropList(); it; it = it->prototype.getPropList())
 		if(it == this)
 		{
+			LookupChanged();
 			prototype.Set0();
 		}
 }
@@ -501,13 +511,12 @@ void C4PropList::AppendDataString(StdStrBuf * out, const char * delim, int depth
 		has_elements = true;
 	}
 	// Append other properties
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
-	for (std::list<const C4Property *>::const_iterator p = sorted_props.begin(); p != sorted_props.end(); ++p)
+	for (int32_t i : Properties.GetSortedPositions())
 	{
 		if (has_elements) DataString.Append(delim);
-		DataString.Append((*p)->Key->GetData());
+		DataString.Append(Properties.GetKey(i)->GetData());
 		DataString.Append(" = ");
-		DataString.Append((*p)->Value.GetDataString(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
+		DataString.Append(Properties.GetValue(i).GetDataString(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
 		has_elements = true;
 	}
 }
@@ -529,13 +538,12 @@ StdStrBuf C4PropList::ToJSON(int depth, bool ignore_reference_parent) const
 		has_elements = true;
 	}
 	// Append other properties
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
-	for (std::list<const C4Property *>::const_iterator p = sorted_props.begin(); p != sorted_props.end(); ++p)
+	for (int32_t i : Properties.GetSortedPositions())
 	{
 		if (has_elements) DataString.Append(",");
-		DataString.Append(C4Value((*p)->Key).ToJSON());
+		DataString.Append(C4Value(Properties.GetKey(i)).ToJSON());
 		DataString.Append(":");
-		DataString.Append((*p)->Value.ToJSON(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
+		DataString.Append(Properties.GetValue(i).ToJSON(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
 		has_elements = true;
 	}
 	DataString.Append("}");
@@ -545,11 +553,11 @@ StdStrBuf C4PropList::ToJSON(int depth, bool ignore_reference_parent) const
 std::vector< C4String * > C4PropList::GetSortedLocalProperties(bool add_prototype) const
 {
 	// return property list without descending into prototype
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
+	std::vector<int32_t> sorted_props = Properties.GetSortedPositions();
 	std::vector< C4String * > result;
 	result.reserve(sorted_props.size() + add_prototype);
 	if (add_prototype) result.push_back(&::Strings.P[P_Prototype]); // implicit prototype for every prop list
-	for (auto p : sorted_props) result.push_back(p->Key);
+	for (int32_t i : sorted_props) result.push_back(Properties.GetKey(i));
 	return result;
 }
 
@@ -558,20 +566,23 @@ std::vector< C4String * > C4PropList::GetSortedLocalProperties(const char *prefi
 	// return property list without descending into prototype
 	// ignore properties that have been overridden by proplist given in ignore_overridden or any of its prototypes up to and excluding this
 	std::vector< C4String * > result;
-	for (const C4Property *pp = Properties.First(); pp; pp = Properties.Next(pp))
-		if (pp->Key != &::Strings.P[P_Prototype])
-			if (!prefix || pp->Key->GetData().BeginsWith(prefix))
+	for (int32_t i = Properties.First(); i >= 0; i = Properties.Next(i))
+	{
+		C4String *key = Properties.GetKey(i);
+		if (key != &::Strings.P[P_Prototype])
+			if (!prefix || key->GetData().BeginsWith(prefix))
 			{
 				// Override check
 				const C4PropList *check = ignore_overridden;
 				bool overridden = false;
 				if (check && check != this)
 				{
-					if (check->HasProperty(pp->Key)) { overridden = true; break; }
+					if (check->HasProperty(key)) { overridden = true; break; }
 					check = check->GetPrototype();
 				}
-				result.push_back(pp->Key);
+				result.push_back(key);
 			}
+	}
 	// Sort
 	std::sort(result.begin(), result.end(), [](const C4String *a, const C4String *b) -> bool
 	{
@@ -588,10 +599,13 @@ std::vector< C4String * > C4PropList::GetUnsortedProperties(const char *prefix,
 	const C4PropList *p = this;
 	do
 	{
-		for (const C4Property *pp = p->Properties.First(); pp; pp = p->Properties.Next(pp))
-			if (pp->Key != &::Strings.P[P_Prototype])
-				if (!prefix || pp->Key->GetData().BeginsWith(prefix))
-					result.push_back(pp->Key);
+		for (int32_t i = p->Properties.First(); i >= 0; i = p->Properties.Next(i))
+		{
+			C4String *key = p->Properties.GetKey(i);
+			if (key != &::Strings.P[P_Prototype])
+				if (!prefix || key->GetData().BeginsWith(prefix))
+					result.push_back(key);
+		}
 		p = p->GetPrototype();
 		if (p == ignore_parent) break;
 	} while (p);
@@ -723,11 +737,307 @@ unsigned int C4Set<C4Property>::Hash<C4Property>(C4Property const & p)
 	return C4Set<C4Property>::Hash(p.Key);
 }
 
+C4PropListShape *C4PropListShape::GetEmpty()
+{
+	// never deleted, so that proplists can outlive static destruction
+	static C4PropListShape *Empty = []() { auto *e = new C4PropListShape; e->IncRef(); return e; }();
+	return Empty;
+}
+
+C4PropListShape::C4PropListShape(C4PropListShape *parent, C4String *k):
+		Parent(parent), Keys(parent->Keys)
+{
+	Keys.push_back(k);
+	for (C4String *key : Keys)
+		key->IncRef();
+	Parent->IncRef();
+}
+
+C4PropListShape::~C4PropListShape()
+{
+	assert(Children.empty());
+	if (Parent)
+	{
+		Parent->Children.erase(Keys.back());
+		Parent->DecRef();
+	}
+	for (C4String *key : Keys)
+		key->DecRef();
+}
+
+int32_t C4PropListShape::Find(const C4String *k) const
+{
+	// Small shapes are faster to scan than to hash
+	if (Keys.size() <= 8)
+	{
+		for (size_t i = 0; i < Keys.size(); ++i)
+			if (Keys[i] == k)
+				return i;
+		return -1;
+	}
+	if (Slots.empty())
+		for (size_t i = 0; i < Keys.size(); ++i)
+			Slots[Keys[i]] = i;
+	auto it = Slots.find(k);
+	return it == Slots.end() ? -1 : it->second;
+}
+
+C4PropListShape *C4PropListShape::GetChild(C4String *k)
+{
+	assert(Find(k) < 0);
+	if (GetSize() >= MaxKeys)
+		return nullptr;
+	C4PropListShape *&child = Children[k];
+	if (!child)
+		child = new C4PropListShape(this, k);
+	child->IncRef();
+	return child;
+}
+
+C4PropertyStore::C4PropertyStore(): Shape(C4PropListShape::GetEmpty())
+{
+	Shape->IncRef();
+}
+
+C4PropertyStore::~C4PropertyStore()
+{
+	// the values might still refer to the keys
+	Values.clear();
+	if (Shape) Shape->DecRef();
+}
+
+C4Value *C4PropertyStore::Find(const C4String *k)
+{
+	if (!Shape)
+	{
+		C4Property &p = Dictionary->Get(k);
+		return p ? &p.Value : nullptr;
+	}
+	int32_t i = Shape->Find(k);
+	return i >= 0 ? &Values[i] : nullptr;
+}
+
+void C4PropertyStore::Set(C4String *k, const C4Value &to)
+{
+	if (C4Value *v = Find(k))
+	{
+		*v = to;
+		return;
+	}
+	if (Shape)
+	{
+		if (C4PropListShape *child = Shape->GetChild(k))
+		{
+			Values.push_back(to);
+			Shape->DecRef();
+			Shape = child;
+			return;
+		}
+		MakeDictionary();
+	}
+	Dictionary->Add(C4Property(k, to));
+}
+
+void C4PropertyStore::Remove(const C4String *k)
+{
+	if (!Has(k)) return;
+	if (Shape)
+	{
+		// Removing the last key just goes back one step in the tree
+		if (Shape->GetKey(Shape->GetSize() - 1) == k)
+		{
+			C4PropListShape *parent = Shape->GetParent();
+			parent->IncRef();
+			Values.pop_back();
+			Shape->DecRef();
+			Shape = parent;
+			return;
+		}
+		MakeDictionary();
+	}
+	Dictionary->Remove(k);
+}
+
+void C4PropertyStore::MakeDictionary()
+{
+	assert(Shape);
+	Dictionary = std::make_unique<C4Set<C4Property>>();
+	for (int32_t i = 0; i < Shape->GetSize(); ++i)
+		Dictionary->Add(C4Property(Shape->GetKey(i), std::move(Values[i])));
+	Values.clear();
+	Values.shrink_to_fit();
+	Shape->DecRef();
+	Shape = nullptr;
+}
+
+void C4PropertyStore::Clear()
+{
+	Values.clear();
+	Dictionary.reset();
+	if (Shape) Shape->DecRef();
+	Shape = C4PropListShape::GetEmpty();
+	Shape->IncRef();
+}
+
+void C4PropertyStore::Swap(C4PropertyStore *other)
+{
+	std::swap(Shape, other->Shape);
+	std::swap(Values, other->Values);
+	std::swap(Dictionary, other->Dictionary);
+}
+
+bool C4PropertyStore::operator==(const C4PropertyStore &b) const
+{
+	if (GetSize() != b.GetSize()) return false;
+	for (int32_t i = First(); i >= 0; i = Next(i))
+	{
+		const C4Value *bv = b.Find(GetKey(i));
+		if (!bv) return false;
+		if (GetValue(i) != *bv) return false;
+	}
+	return true;
+}
+
+int32_t C4PropertyStore::Next(int32_t i) const
+{
+	if (Shape)
+		return i + 1 < int32_t(Values.size()) ? i + 1 : -1;
+	while (++i < int32_t(Dictionary->GetCapacity()))
+		if (Dictionary->GetAt(i))
+			return i;
+	return -1;
+}
+
+int32_t C4PropertyStore::GetPosition(const C4String *k) const
+{
+	if (Shape)
+		return Shape->Find(k);
+	C4Property &p = Dictionary->Get(k);
+	return p ? &p - &Dictionary->GetAt(0) : -1;
+}
+
+std::vector<int32_t> C4PropertyStore::GetSortedPositions() const
+{
+	std::vector<int32_t> result;
+	result.reserve(GetSize());
+	for (int32_t i = First(); i >= 0; i = Next(i))
+		result.push_back(i);
+	std::sort(result.begin(), result.end(), [this](int32_t a, int32_t b) -> bool
+	{
+		return strcmp(GetKey(a)->GetCStr(), GetKey(b)->GetCStr()) < 0;
+	});
+	return result;
+}
+
+void C4PropertyStore::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
+{
+	// Same format as C4Set<C4Property>
+	bool fNaming = pComp->hasNaming();
+	if (pComp->isDeserializer())
+	{
+		Clear();
+		uint32_t iSize;
+		if (!fNaming) pComp->Value(iSize);
+		do
+		{
+			if (!fNaming && !iSize--)
+				break;
+			try
+			{
+				C4Property e;
+				pComp->Value(mkParAdapt(e, numbers));
+				if (e) Set(e.Key, e.Value);
+			}
+			catch (StdCompiler::NotFoundException *pEx)
+			{
+				// No value found: Stop reading loop
+				delete pEx;
+				break;
+			}
+		}
+		while (pComp->Separator(StdCompiler::SEP_SEP));
+	}
+	else
+	{
+		if (!fNaming)
+		{
+			int32_t iSize = GetSize();
+			pComp->Value(iSize);
+		}
+		bool fFirst = true;
+		for (int32_t i = First(); i >= 0; i = Next(i))
+		{
+			if (!fFirst) pComp->Separator(StdCompiler::SEP_SEP);
+			fFirst = false;
+			// Written in place, C4ValueNumbers remembers the value addresses
+			StdStrBuf s;
+			s = GetKey(i)->GetData();
+			pComp->Value(s);
+			pComp->Separator(StdCompiler::SEP_SET);
+			pComp->Value(mkParAdapt(GetValue(i), numbers));
+		}
+	}
+}
+
+uint32_t C4PropList::LookupEpoch = 1;
+
+const C4Value *C4PropList::GetPrototypeSlot(const C4String *k, C4PropListLookupCache &cache) const
+{
+	const C4PropList *proto = GetPrototype();
+	if (!proto) return nullptr;
+	C4PropListLookupCache::Entry *entries = cache.Entries;
+	for (int i = 0; i < C4PropListLookupCache::MaxEntries; ++i)
+		if (entries[i].Prototype == proto && entries[i].Epoch == LookupEpoch)
+			return entries[i].Slot;
+	// Walk the chain. Adding or removing keys moves the slots, so every proplist
+	// on the way starts a new epoch when that happens.
+	const C4Value *slot = nullptr;
+	for (const C4PropList *it = proto; it; it = it->GetPrototype())
+	{
+		it->lookup_cached = true;
+		slot = it->Properties.Find(k);
+		if (slot)
+			break;
+	}
+	// The oldest entry makes room
+	std::move_backward(entries, entries + C4PropListLookupCache::MaxEntries - 1, entries + C4PropListLookupCache::MaxEntries);
+	entries[0].Prototype = proto;
+	entries[0].Slot = slot;
+	entries[0].Epoch = LookupEpoch;
+	return slot;
+}
+
+bool C4PropList::GetPropertyByS(const C4String *k, C4Value *pResult, C4PropListLookupCache &cache) const
+{
+	// Special properties are handled by the overloads
+	if (k >= &Strings.P[0] && k < &Strings.P[P_LAST])
+		return GetPropertyByS(k, pResult);
+	if (const C4Value *v = Properties.Find(k))
+	{
+		*pResult = *v;
+		return true;
+	}
+	const C4Value *slot = GetPrototypeSlot(k, cache);
+	if (!slot)
+		return false;
+	*pResult = *slot;
+	return true;
+}
+
+C4AulFunc * C4PropList::GetFunc(C4String * k, C4PropListLookupCache &cache) const
+{
+	assert(k);
+	if (const C4Value *v = Properties.Find(k))
+		return v->getFunction();
+	const C4Value *slot = GetPrototypeSlot(k, cache);
+	return slot ? slot->getFunction() : nullptr;
+}
+
 bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult) const
 {
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		*pResult = Properties.Get(k).Value;
+		*pResult = *v;
 		return true;
 	}
 	else if (k == &Strings.P[P_Prototype])
@@ -744,9 +1054,9 @@ bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult) const
 C4String * C4PropList::GetPropertyStr(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getStr();
+		return v->getStr();
 	}
 	if (GetPrototype())
 	{
@@ -758,9 +1068,9 @@ C4String * C4PropList::GetPropertyStr(C4PropertyName n) const
 C4ValueArray * C4PropList::GetPropertyArray(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getArray();
+		return v->getArray();
 	}
 	if (GetPrototype())
 	{
@@ -772,9 +1082,9 @@ C4ValueArray * C4PropList::GetPropertyArray(C4PropertyName n) const
 C4AulFunc * C4PropList::GetFunc(C4String * k) const
 {
 	assert(k);
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getFunction();
+		return v->getFunction();
 	}
 	if (GetPrototype())
 	{
@@ -824,9 +1134,9 @@ C4Value C4PropList::Call(const char * s, C4AulParSet *Pars, bool fPassErrors)
 C4PropertyName C4PropList::GetPropertyP(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *pv = Properties.Find(k))
 	{
-		C4String * v = Properties.Get(k).Value.getStr();
+		C4String * v = pv->getStr();
 		if (v >= &Strings.P[0] && v < &Strings.P[P_LAST])
 			return C4PropertyName(v - &Strings.P[0]);
 		return P_LAST;
@@ -841,9 +1151,9 @@ C4PropertyName C4PropList::GetPropertyP(C4PropertyName n) const
 int32_t C4PropList::GetPropertyBool(C4PropertyName n, bool default_val) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getBool();
+		return v->getBool();
 	}
 	if (GetPrototype())
 	{
@@ -855,9 +1165,9 @@ int32_t C4PropList::GetPropertyBool(C4PropertyName n, bool default_val) const
 int32_t C4PropList::GetPropertyInt(C4PropertyName n, int32_t default_val) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getInt();
+		return v->getInt();
 	}
 	if (GetPrototype())
 	{
@@ -869,9 +1179,9 @@ int32_t C4PropList::GetPropertyInt(C4PropertyName n, int32_t default_val) const
 C4PropList *C4PropList::GetPropertyPropList(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *v = Properties.Find(k))
 	{
-		return Properties.Get(k).Value.getPropList();
+		return v->getPropList();
 	}
 	if (GetPrototype())
 	{
@@ -896,10 +1206,9 @@ C4ValueArray * C4PropList::GetProperties() const
 		a = new C4ValueArray(Properties.GetSize());
 		i = 0;
 	}
-	const C4Property * p = Properties.First();
-	while (p)
+	for (int32_t p = Properties.First(); p >= 0; p = Properties.Next(p))
 	{
-		C4String *newPropertyName = p->Key;
+		C4String *newPropertyName = Properties.GetKey(p);
 		assert(newPropertyName != nullptr && "Proplist key is nullpointer");
 		// Do we need to check for duplicate property names?
 		bool skipProperty = false;
@@ -917,7 +1226,6 @@ C4ValueArray * C4PropList::GetProperties() const
 			(*a)[i++] = C4VString(newPropertyName);
 			assert(((*a)[i - 1].GetType() == C4V_String) && "Proplist key is non-string");
 		}
-		p = Properties.Next(p);
 	}
 	// We might have added less properties than initially intended.
 	if (hasInheritedProperties)
@@ -927,12 +1235,12 @@ C4ValueArray * C4PropList::GetProperties() const
 
 C4String * C4PropList::EnumerateOwnFuncs(C4String * prev) const
 {
-	const C4Property * p = prev ? Properties.Next(&Properties.Get(prev)) : Properties.First();
-	while (p)
+	int32_t p = prev ? Properties.GetPosition(prev) : -1;
+	if (prev && p < 0) return nullptr;
+	for (p = Properties.Next(p); p >= 0; p = Properties.Next(p))
 	{
-		if (p->Value.getFunction())
-			return p->Key;
-		p = Properties.Next(p);
+		if (Properties.GetValue(p).getFunction())
+			return Properties.GetKey(p);
 	}
 	return nullptr;
 }
@@ -946,20 +1254,23 @@ void C4PropList::SetPropertyByS(C4String * k, const C4Value & to)
 		for(C4PropList * it = newpt; it; it = it->GetPrototype())
 			if(it == this)
 				throw C4AulExecError("Trying to create cyclic prototype structure");
+		LookupChanged();
 		prototype.SetPropList(newpt);
 	}
-	else if (Properties.Has(k))
+	else if (C4Value *v = Properties.Find(k))
 	{
-		Properties.Get(k).Value = to;
+		*v = to;
 	}
 	else
 	{
-		Properties.Add(C4Property(k, to));
+		LookupChanged();
+		Properties.Set(k, to);
 	}
 }
 
 void C4PropList::ResetProperty(C4String * k)
 {
+	LookupChanged();
 	if (k == &Strings.P[P_Prototype])
 		prototype.Set0();
 	else
@@ -976,20 +1287,18 @@ void C4PropList::Iterator::Reserve(size_t additionalAmount)
 	properties->reserve(properties->size() + additionalAmount);
 }
 
-void C4PropList::Iterator::AddProperty(const C4Property * prop)
+void C4PropList::Iterator::AddProperty(C4String * key, const C4Value & value)
 {
-	std::vector<const C4Property*>::size_type i = 0, len = properties->size();
-	for(;i < len; ++i)
+	for (C4Property &oldProperty : *properties)
 	{
-		const C4Property *oldProperty = (*properties)[i];
-		if (oldProperty->Key == prop->Key)
+		if (oldProperty.Key == key)
 		{
-			(*properties)[i] = prop;
+			oldProperty.Value = value;
 			return;
 		}
 	}
 	// not already in vector?
-	properties->push_back(prop);
+	properties->emplace_back(key, value);
 }
 
 C4PropList::Iterator C4PropList::begin()
@@ -1002,16 +1311,12 @@ C4PropList::Iterator C4PropList::begin()
 	}
 	else
 	{
-		iter.properties = std::make_shared<std::vector<const C4Property*> >();
+		iter.properties = std::make_shared<std::vector<C4Property> >();
 	}
 	iter.Reserve(Properties.GetSize());
 
-	const C4Property * p = Properties.First();
-	while (p)
-	{
-		iter.AddProperty(p);
-		p = Properties.Next(p);
-	}
+	for (int32_t p = Properties.First(); p >= 0; p = Properties.Next(p))
+		iter.AddProperty(Properties.GetKey(p), Properties.GetValue(p));
 
 	iter.Init();
 	return iter;
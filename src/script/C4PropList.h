@@ -16,6 +16,7 @@
 /* Property lists */
 
 #include "script/C4Value.h"
+#include "script/C4ScriptHeap.h"
 #include "script/C4StringTable.h"
 
 #ifndef C4PROPLIST_H
@@ -63,11 +64,99 @@ inline bool C4Set<C4Property>::Equals(const C4Property &a, const C4Property &b)
 	return a.Key == b.Key;
 }
 
+// Key layout shared by all proplists that got the same keys in the same order.
+// Adding a key moves a proplist on to a child shape, so the shapes form a tree
+// rooted in GetEmpty(). Shapes are deleted when no proplist uses them anymore.
+class C4PropListShape
+{
+public:
+	static const int32_t MaxKeys = 32; // larger proplists are stored as dictionaries
+	static C4PropListShape *GetEmpty();
+
+	int32_t GetSize() const { return Keys.size(); }
+	C4String *GetKey(int32_t i) const { return Keys[i]; }
+	int32_t Find(const C4String *k) const; // slot of k, or -1
+	// The shape with k appended with a new reference, or nullptr if that would be too large
+	C4PropListShape *GetChild(C4String *k);
+	C4PropListShape *GetParent() const { return Parent; }
+
+	void IncRef() { ++RefCnt; }
+	void DecRef() { if (!--RefCnt) delete this; }
+
+private:
+	C4PropListShape() = default;
+	C4PropListShape(C4PropListShape *parent, C4String *k);
+	~C4PropListShape();
+
+	C4PropListShape *Parent{nullptr};
+	std::vector<C4String *> Keys; // in slot order, referenced
+	std::unordered_map<const C4String *, C4PropListShape *> Children;
+	mutable std::unordered_map<const C4String *, int32_t> Slots; // built on demand for larger shapes
+	int32_t RefCnt{0};
+};
+
+// The own properties of a proplist. Values are kept in a dense array laid out by
+// a shared C4PropListShape. Proplists with many keys or removed keys fall back to a
+// hash table. Properties are enumerated in insertion order unless in the hash table.
+class C4PropertyStore
+{
+public:
+	C4PropertyStore();
+	C4PropertyStore(const C4PropertyStore &) = delete;
+	C4PropertyStore & operator = (const C4PropertyStore &) = delete;
+	~C4PropertyStore();
+
+	C4Value *Find(const C4String *k);
+	const C4Value *Find(const C4String *k) const { return const_cast<C4PropertyStore *>(this)->Find(k); }
+	bool Has(const C4String *k) const { return Find(k) != nullptr; }
+	void Set(C4String *k, const C4Value &to); // adds k if necessary
+	void Remove(const C4String *k);
+	void Clear();
+	void Swap(C4PropertyStore *other);
+	unsigned int GetSize() const { return Shape ? Values.size() : Dictionary->GetSize(); }
+	bool IsDictionary() const { return !Shape; }
+	bool operator==(const C4PropertyStore &b) const; // same keys and values, in any layout
+
+	// Positions for enumeration: for (int32_t i = First(); i >= 0; i = Next(i))
+	int32_t First() const { return Next(-1); }
+	int32_t Next(int32_t i) const;
+	int32_t GetPosition(const C4String *k) const; // -1 if k is not there
+	C4String *GetKey(int32_t i) const { return Shape ? Shape->GetKey(i) : Dictionary->GetAt(i).Key; }
+	C4Value &GetValue(int32_t i) { return Shape ? Values[i] : Dictionary->GetAt(i).Value; }
+	const C4Value &GetValue(int32_t i) const { return const_cast<C4PropertyStore *>(this)->GetValue(i); }
+	std::vector<int32_t> GetSortedPositions() const; // ordered by key
+
+	void CompileFunc(StdCompiler *pComp, C4ValueNumbers *);
+
+private:
+	void MakeDictionary();
+	C4PropListShape *Shape; // nullptr if stored in Dictionary
+	std::vector<C4Value> Values;
+	std::unique_ptr<C4Set<C4Property>> Dictionary;
+};
+
+// Remembers where the lookup of one script call site's key in the prototype chain ended,
+// for the few most recent prototypes. Filled by C4PropList::GetPropertyByS and GetFunc.
+class C4PropListLookupCache
+{
+public:
+	static const int MaxEntries = 4;
+private:
+	struct Entry
+	{
+		const class C4PropList *Prototype{nullptr};
+		const C4Value *Slot{nullptr}; // nullptr if no proplist in the chain has the key
+		uint32_t Epoch{0};
+	};
+	Entry Entries[MaxEntries];
+	friend class C4PropList;
+};
+
 class C4PropListNumbered;
 class C4PropList
 {
 public:
-	void Clear() { constant = false; Properties.Clear(); prototype.Set0(); }
+	void Clear() { LookupChanged(); constant = false; Properties.Clear(); prototype.Set0(); }
 	virtual const char *GetName() const;
 	virtual void SetName (const char *NewName = nullptr);
 	virtual void SetOnFire(bool OnFire) { }
@@ -85,6 +174,9 @@ public:
 	C4PropList * GetPrototype() const { return prototype._getPropList(); }
 	void RemoveCyclicPrototypes();
 
+	// created by script and freed by reference counting or C4ScriptHeap
+	inline class C4PropListScript * GetPropListScript();
+
 	// saved as a reference to a global constant?
 	virtual class C4PropListStatic * IsStatic() { return nullptr; }
 	const class C4PropListStatic * IsStatic() const { return const_cast<C4PropList*>(this)->IsStatic(); }
@@ -94,7 +186,8 @@ public:
 	virtual bool Delete() { return false; }
 
 	// These four operate on properties as seen by script, which can be dynamic
-	// or reflect C++ variables
+	// or reflect C++ variables. Overloads may only special-case the names in Strings.P,
+	// the cached lookups below rely on that.
 	virtual bool GetPropertyByS(const C4String *k, C4Value *pResult) const;
 	virtual C4ValueArray * GetProperties() const;
 	// not allowed on frozen proplists
@@ -110,6 +203,11 @@ public:
 	{ return GetFunc(&Strings.P[k]); }
 	C4AulFunc * GetFunc(C4String * k) const;
 	C4AulFunc * GetFunc(const char * k) const;
+	// Same results as above, but the prototype chain part of the lookup is remembered in cache
+	bool GetPropertyByS(const C4String *k, C4Value *pResult, C4PropListLookupCache &cache) const;
+	C4AulFunc * GetFunc(C4String * k, C4PropListLookupCache &cache) const;
+	// Drop all cached lookups, for changes that bypass SetPropertyByS
+	static void InvalidateLookups() { ++LookupEpoch; }
 	C4String * EnumerateOwnFuncs(C4String * prev = nullptr) const;
 	C4Value Call(C4PropertyName k, C4AulParSet *pPars=nullptr, bool fPassErrors=false)
 	{ return Call(&Strings.P[k], pPars, fPassErrors); }
@@ -158,15 +256,24 @@ public:
 protected:
 	C4PropList(C4PropList * prototype = nullptr);
 	void ClearRefs() { for( C4Value * ref: RefSet{Refs}) ref->Set0(); assert(Refs.empty()); }
+	uint32_t GetRefCount() const { return Refs.size(); }
+	const C4PropertyStore &GetPropertyStore() const { return Properties; }
+	const C4Value &GetPrototypeValue() const { return prototype; }
+	bool script_heap{false}; // this is a C4PropListScript
 
 private:
 	void AddRef(C4Value *pRef);
 	void DelRef(C4Value *pRef);
 	typedef std::unordered_set<C4Value *> RefSet;
 	RefSet Refs;
-	C4Set<C4Property> Properties;
+	C4PropertyStore Properties;
 	C4Value prototype;
 	bool constant{false}; // if true, this proplist is not changeable
+	mutable bool lookup_cached{false}; // part of a cached prototype chain lookup
+	static uint32_t LookupEpoch; // cache entries from older epochs are invalid
+	// Keys or the prototype change in a way that might invalidate cached lookups
+	void LookupChanged() { if (lookup_cached) InvalidateLookups(); }
+	const C4Value *GetPrototypeSlot(const C4String *k, C4PropListLookupCache &cache) const;
 	friend class C4Value;
 	friend class C4ScriptHost;
 public:
@@ -175,19 +282,19 @@ public:
 	class Iterator
 	{
 	private:
-		std::shared_ptr<std::vector<const C4Property*> > properties;
-		std::vector<const C4Property*>::iterator iter;
+		std::shared_ptr<std::vector<C4Property> > properties;
+		std::vector<C4Property>::iterator iter;
 		// needed when constructing the iterator
 		// adds a property or overwrites existing property with same name
-		void AddProperty(const C4Property * prop);
+		void AddProperty(C4String * key, const C4Value & value);
 		void Reserve(size_t additionalAmount);
 		// Initializes internal iterator. Needs to be called before actually using the iterator.
 		void Init();
 	public:
 		Iterator() : properties(nullptr) { }
 
-		const C4Property * operator*() const { return *iter; }
-		const C4Property * operator->() const { return *iter; }
+		const C4Property * operator*() const { return &*iter; }
+		const C4Property * operator->() const { return &*iter; }
 		void operator++() { ++iter; };
 		void operator++(int) { operator++(); }
 
@@ -246,19 +353,29 @@ protected:
 };
 
 // Proplists created by script at runtime
-class C4PropListScript: public C4PropList
+class C4PropListScript: public C4PropList, public C4ScriptHeapObject
 {
 public:
-	C4PropListScript(C4PropList * prototype = nullptr) : C4PropList(prototype) { PropLists.Add(this);  }
-	~C4PropListScript() override { PropLists.Remove(this); }
+	C4PropListScript(C4PropList * prototype = nullptr) : C4PropList(prototype), C4ScriptHeapObject(false) { script_heap = true; PropLists.Add(this);  }
+	~C4PropListScript() override { PropLists.Remove(this); script_heap = false; }
 	bool Delete() override { return true; }
 
 	static void ClearScriptPropLists(); // empty all properties in script-created prop lists. Used on game clear to ensure prop lists with circular references get cleared.
 
 protected:
 	static C4Set<C4PropListScript *> PropLists;
+
+	uint32_t GetHeapRefCount() const override { return GetRefCount(); }
+	void GetHeapChildren(std::vector<C4ScriptHeapObject *> &Children) const override;
+	void ClearHeapChildren() override { Clear(); }
+	C4Value GetHeapValue() override { return C4VPropList(this); }
 };
 
+C4PropListScript * C4PropList::GetPropListScript()
+{
+	return script_heap ? static_cast<C4PropListScript *>(this) : nullptr;
+}
+
 // PropLists declared in the game data
 // examples: Definitions, local variable initializers
 class C4PropListStatic: public C4PropList
@@ -0,0 +1,221 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2009-2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Cycle collection for proplists and arrays created by scripts */
+
+#include "C4Include.h"
+#include "script/C4ScriptHeap.h"
+
+#include "script/C4AulExec.h"
+#include "script/C4PropList.h"
+#include "script/C4Value.h"
+#include "script/C4ValueArray.h"
+
+C4ScriptHeap::State C4ScriptHeap::Data;
+
+C4ScriptHeapObject::C4ScriptHeapObject(bool fArray): fArray(fArray)
+{
+	if (fArray)
+		++C4ScriptHeap::Data.Arrays;
+	else
+		++C4ScriptHeap::Data.PropLists;
+}
+
+C4ScriptHeapObject::~C4ScriptHeapObject()
+{
+	if (fCandidate) RemoveCandidate();
+	if (fArray)
+		--C4ScriptHeap::Data.Arrays;
+	else
+		--C4ScriptHeap::Data.PropLists;
+}
+
+void C4ScriptHeapObject::AddCandidate()
+{
+	// append, so candidates are checked in the order they came up
+	C4ScriptHeap::State &Heap = C4ScriptHeap::Data;
+	fCandidate = true;
+	pPrevCandidate = Heap.pLastCandidate;
+	pNextCandidate = nullptr;
+	if (Heap.pLastCandidate)
+		Heap.pLastCandidate->pNextCandidate = this;
+	else
+		Heap.pFirstCandidate = this;
+	Heap.pLastCandidate = this;
+	++Heap.Candidates;
+}
+
+void C4ScriptHeapObject::RemoveCandidate()
+{
+	C4ScriptHeap::State &Heap = C4ScriptHeap::Data;
+	if (pPrevCandidate)
+		pPrevCandidate->pNextCandidate = pNextCandidate;
+	else
+		Heap.pFirstCandidate = pNextCandidate;
+	if (pNextCandidate)
+		pNextCandidate->pPrevCandidate = pPrevCandidate;
+	else
+		Heap.pLastCandidate = pPrevCandidate;
+	pPrevCandidate = pNextCandidate = nullptr;
+	fCandidate = false;
+	--Heap.Candidates;
+}
+
+void C4ScriptHeapObject::MarkAlive()
+{
+	HeapColor = Black;
+	iLiveMark = C4ScriptHeap::Data.LiveMark;
+	if (fCandidate) RemoveCandidate();
+}
+
+C4ScriptHeapObject *C4ScriptHeapObject::GetHeapObject(const C4Value &Value)
+{
+	switch (Value.GetType())
+	{
+	case C4V_Array: return Value._getArray();
+	case C4V_PropList: return Value._getPropList()->GetPropListScript();
+	default: return nullptr;
+	}
+}
+
+int32_t C4ScriptHeap::Collect(int32_t iMaxVisits)
+{
+	uint32_t iStartVisited = Data.Visited;
+	int32_t iFreed = 0;
+	++Data.Runs;
+	// scripts ran since the last call, so nothing is known to be alive
+	++Data.LiveMark;
+	while (Data.pFirstCandidate)
+	{
+		uint32_t iVisited = Data.Visited - iStartVisited;
+		if (iVisited >= uint32_t(iMaxVisits)) break;
+		// the first trace may take longer than the slice, otherwise it would never be done
+		int32_t iCollected = CollectCycles(Data.pFirstCandidate, iVisited ? uint32_t(iMaxVisits) - iVisited : UINT32_MAX);
+		if (iCollected < 0) break;
+		iFreed += iCollected;
+	}
+	return iFreed;
+}
+
+int32_t C4ScriptHeap::CollectCycles(C4ScriptHeapObject *pCandidate, uint32_t iMaxReached)
+{
+	// already seen alive by another trace?
+	if (pCandidate->iLiveMark == Data.LiveMark)
+	{
+		pCandidate->RemoveCandidate();
+		++Data.Visited;
+		return 0;
+	}
+	// Trial deletion: Subtract the references within the part of the heap reachable
+	// from the candidate. Whatever is left over is referenced from outside and alive,
+	// as is everything reachable from it. The rest is only kept alive by cycles.
+	// Objects that are known to be alive count as outside.
+	std::vector<C4ScriptHeapObject *> Reached, Stack, Children;
+	pCandidate->HeapColor = C4ScriptHeapObject::Gray;
+	pCandidate->iTrialRefCount = pCandidate->GetHeapRefCount();
+	Reached.push_back(pCandidate);
+	Stack.push_back(pCandidate);
+	while (!Stack.empty())
+	{
+		C4ScriptHeapObject *pObj = Stack.back();
+		Stack.pop_back();
+		Children.clear();
+		pObj->GetHeapChildren(Children);
+		for (C4ScriptHeapObject *pChild : Children)
+		{
+			if (pChild->iLiveMark == Data.LiveMark) continue;
+			if (pChild->HeapColor != C4ScriptHeapObject::Gray)
+			{
+				pChild->HeapColor = C4ScriptHeapObject::Gray;
+				pChild->iTrialRefCount = pChild->GetHeapRefCount();
+				Reached.push_back(pChild);
+				Stack.push_back(pChild);
+				// too much for this slice? Try again with the next one.
+				if (Reached.size() > iMaxReached)
+				{
+					for (C4ScriptHeapObject *pReached : Reached)
+						pReached->HeapColor = C4ScriptHeapObject::Black;
+					Data.Visited += Reached.size();
+					return -1;
+				}
+			}
+			--pChild->iTrialRefCount;
+		}
+	}
+	pCandidate->RemoveCandidate();
+	Data.Visited += Reached.size();
+	// Mark everything reachable from outside references as alive again. Candidates
+	// among them are checked already and only need another check if they lose a reference.
+	for (C4ScriptHeapObject *pRoot : Reached)
+	{
+		if (pRoot->HeapColor != C4ScriptHeapObject::Gray || pRoot->iTrialRefCount <= 0) continue;
+		pRoot->MarkAlive();
+		Stack.push_back(pRoot);
+		while (!Stack.empty())
+		{
+			C4ScriptHeapObject *pObj = Stack.back();
+			Stack.pop_back();
+			Children.clear();
+			pObj->GetHeapChildren(Children);
+			for (C4ScriptHeapObject *pChild : Children)
+				if (pChild->HeapColor == C4ScriptHeapObject::Gray)
+				{
+					pChild->MarkAlive();
+					Stack.push_back(pChild);
+				}
+		}
+	}
+	// Free the garbage. Keep references until all of it is cleared, so nothing is
+	// deleted while its references are still being dropped.
+	std::vector<C4Value> Garbage;
+	for (C4ScriptHeapObject *pObj : Reached)
+		if (pObj->HeapColor == C4ScriptHeapObject::Gray)
+		{
+			pObj->HeapColor = C4ScriptHeapObject::Black;
+			Garbage.push_back(pObj->GetHeapValue());
+			if (pObj->fArray)
+				++Data.CollectedArrays;
+			else
+				++Data.CollectedPropLists;
+		}
+	for (C4Value &Value : Garbage)
+		C4ScriptHeapObject::GetHeapObject(Value)->ClearHeapChildren();
+	int32_t iFreed = Garbage.size();
+	Garbage.clear();
+	// the dropped references may have been all that kept marked objects alive
+	if (iFreed) ++Data.LiveMark;
+	return iFreed;
+}
+
+void C4ScriptHeap::ResetStats()
+{
+	Data.Runs = Data.Visited = Data.CollectedPropLists = Data.CollectedArrays = 0;
+}
+
+namespace
+{
+	// Reset and show statistics along with the script profiler
+	class C4ScriptHeapProfilerStats : public C4AulProfiler::StatsSource
+	{
+	public:
+		void ResetStats() override { C4ScriptHeap::ResetStats(); }
+		void ShowStats() override
+		{
+			const C4ScriptHeap::Stats &Stats = C4ScriptHeap::GetStats();
+			LogF("Script heap: %u proplists, %u arrays, %u candidates; %u runs visited %u, freed %u proplists, %u arrays",
+			     Stats.PropLists, Stats.Arrays, Stats.Candidates, Stats.Runs, Stats.Visited, Stats.CollectedPropLists, Stats.CollectedArrays);
+		}
+	} ScriptHeapProfilerStats;
+}
@@ -0,0 +1,93 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2009-2016, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Cycle collection for proplists and arrays created by scripts */
+
+#ifndef INC_C4ScriptHeap
+#define INC_C4ScriptHeap
+
+class C4Value;
+
+// A script proplist or array. Reference counting alone can't free these when they
+// reference each other in a cycle, so the ones that lost a reference but are still
+// referenced are remembered as candidates and checked by C4ScriptHeap::Collect.
+class C4ScriptHeapObject
+{
+public:
+	C4ScriptHeapObject(bool fArray);
+	C4ScriptHeapObject(const C4ScriptHeapObject &) = delete;
+	C4ScriptHeapObject &operator=(const C4ScriptHeapObject &) = delete;
+	virtual ~C4ScriptHeapObject();
+
+	// call when a reference went away, but others are left
+	void ReferenceDropped() { if (!fCandidate) AddCandidate(); }
+
+protected:
+	// interface for the collector
+	virtual uint32_t GetHeapRefCount() const = 0; // all references, including those from other heap objects
+	virtual void GetHeapChildren(std::vector<C4ScriptHeapObject *> &Children) const = 0; // one entry per reference
+	virtual void ClearHeapChildren() = 0; // drop all references to other values
+	virtual C4Value GetHeapValue() = 0;
+
+	static C4ScriptHeapObject *GetHeapObject(const C4Value &Value);
+
+private:
+	enum Color { Black, Gray };
+	Color HeapColor{Black};
+	bool fArray;
+	bool fCandidate{false};
+	int32_t iTrialRefCount{0}; // references from outside the traced part of the heap
+	uint32_t iLiveMark{0}; // equals C4ScriptHeap::Data.LiveMark if proven to be alive
+	C4ScriptHeapObject *pPrevCandidate{nullptr}, *pNextCandidate{nullptr};
+	void AddCandidate();
+	void RemoveCandidate();
+	void MarkAlive();
+
+	friend class C4ScriptHeap;
+};
+
+// the collector. Local code registers candidates as well, so what a slice traces and when a cycle is
+// freed may differ between network clients. Freed cycles are unreachable from script, so this does not
+// affect the synchronized game state. The stats are thus for local diagnostics only.
+class C4ScriptHeap
+{
+public:
+	struct Stats
+	{
+		uint32_t PropLists{0}, Arrays{0}; // currently alive
+		uint32_t Candidates{0}; // waiting to be checked
+		uint32_t Runs{0}, Visited{0}, CollectedPropLists{0}, CollectedArrays{0}; // since the last reset
+	};
+
+	// Checks candidates until iMaxVisits objects were traced. A trace that does not fit into the
+	// rest of the slice is left for the next call, so only the first one may exceed it. Returns
+	// the number of freed objects.
+	static int32_t Collect(int32_t iMaxVisits);
+	static void CollectAll() { while (Data.pFirstCandidate) Collect(INT32_MAX); }
+	static const Stats &GetStats() { return Data; }
+	static void ResetStats();
+
+private:
+	static struct State : Stats
+	{
+		C4ScriptHeapObject *pFirstCandidate{nullptr}, *pLastCandidate{nullptr};
+		// objects proven alive carry this mark until the heap changes, so other traces stop there
+		uint32_t LiveMark{0};
+	} Data;
+	static int32_t CollectCycles(C4ScriptHeapObject *pCandidate, uint32_t iMaxReached);
+	friend class C4ScriptHeapObject;
+};
+
+#endif
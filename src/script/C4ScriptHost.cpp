@@ -48,9 +48,11 @@ C4ScriptHost::~C4ScriptHost()
 
 void C4ScriptHost::Clear()
 {
+	if (Engine) Engine->RemovePendingPreparse(this);
 	UnlinkOwnedFunctions();
 	C4ComponentHost::Clear();
 	ast.reset();
+	PreparseMessages.clear();
 	Script.Clear();
 	LocalValues.Clear();
 	DeleteOwnedPropLists();
@@ -136,6 +138,7 @@ void C4ScriptHost::DeleteOwnedPropLists()
 
 void C4ScriptHost::Unreg()
 {
+	if (Engine) Engine->RemovePendingPreparse(this);
 	// remove from list
 	if (Prev) Prev->Next = Next; else if (Engine) Engine->Child0 = Next;
 	if (Next) Next->Prev = Prev; else if (Engine) Engine->ChildL = Prev;
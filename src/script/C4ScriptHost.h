@@ -65,7 +65,9 @@ protected:
 	void MakeScript();
 	virtual bool ReloadScript(const char *szPath, const char *szLanguage);
 
-	bool Preparse(); // preparse script; return if successfull
+	bool Preparse(); // preparse script before the next link; return if successfull
+	void ParseSyntaxTree(); // thread safe part of the preparsing
+	void FinishPreparse();
 	virtual bool Parse(); // parse preparsed script; return if successfull
 	virtual void UnLink(); // reset to unlinked state
 
@@ -81,7 +83,7 @@ protected:
 	std::list<StdCopyStrBuf> Appends; // append list
 
 	virtual void AddEngineFunctions() {}; // add any engine functions specific to this script host
-	void CopyPropList(C4Set<C4Property> & from, C4PropListStatic * to);
+	void CopyPropList(C4PropertyStore & from, C4PropListStatic * to);
 	bool ResolveIncludes(C4DefList *rDefs); // resolve includes
 	bool ResolveAppends(C4DefList *rDefs); // resolve appends
 	void DoAppend(C4Def *def);
@@ -90,7 +92,7 @@ protected:
 
 	StdStrBuf Script; // script
 	C4LangStringTable *stringTable;
-	C4Set<C4Property> LocalValues;
+	C4PropertyStore LocalValues;
 	C4AulScriptState State{ASS_NONE}; // script state
 
 	// list of all functions generated from code in this script host
@@ -113,6 +115,7 @@ protected:
 private:
 	std::map<const char*, std::bitset<(size_t)C4AulWarningId::WarningCount>> enabledWarnings;
 	std::unique_ptr<::aul::ast::Script> ast;
+	std::vector<std::pair<bool, std::string>> PreparseMessages; // errors and warnings of ParseSyntaxTree
 };
 
 // script host for System.ocg scripts and scenario section Objects.c
@@ -23,7 +23,9 @@
 
 int usage(const char *argv0)
 {
-	fprintf(stderr, "Usage:\n%s -e <script>\n%s <file>\n", argv0, argv0);
+	fprintf(stderr, "Usage:\n%s [-c] [-d] -e <script>\n%s [-c] [-d] <file>\n", argv0, argv0);
+	fprintf(stderr, "  -c, --check          only compile the script\n");
+	fprintf(stderr, "  -d, --dump-bytecode  print the byte code of each function before and after optimization\n");
 	return 1;
 }
 
@@ -40,18 +42,22 @@ int main(int argc, char *argv[])
 		static option long_options[] =
 		{
 			{"check", no_argument, nullptr, 'c'},
+			{"dump-bytecode", no_argument, nullptr, 'd'},
 			{"execute", required_argument, nullptr, 'e'},
 			{nullptr, 0, nullptr, 0}
 		};
 
 		int option_index;
-		int c = getopt_long(argc, argv, "ce:", long_options, &option_index);
+		int c = getopt_long(argc, argv, "cde:", long_options, &option_index);
 		if (c == -1) break;
 		switch (c)
 		{
 		case 'c':
 			check = true;
 			break;
+		case 'd':
+			c4s_dumpbytecode(1);
+			break;
 		case 'e':
 			runstring = optarg;
 			break;
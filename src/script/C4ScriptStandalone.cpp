@@ -74,6 +74,7 @@ static int RunFile(const char * filename, bool checkOnly)
 
 	InitializeC4Script();
 	GameScript.Load(File, fn.getData(), nullptr, nullptr);
+	ScriptEngine.PreparseScripts();
 	if (!checkOnly)
 		RunLoadedC4Script();
 	ClearC4Script();
@@ -84,6 +85,7 @@ static int RunString(const char *script, bool checkOnly)
 {
 	InitializeC4Script();
 	GameScript.LoadData("<memory>", script, nullptr);
+	ScriptEngine.PreparseScripts();
 	if (!checkOnly)
 		RunLoadedC4Script();
 	ClearC4Script();
@@ -96,3 +98,5 @@ int c4s_runstring(const char *script) { return RunString(script, false); }
 
 int c4s_checkfile(const char *filename) { return RunFile(filename, true); }
 int c4s_checkstring(const char *script) { return RunString(script, true); }
+
+void c4s_dumpbytecode(int enable) { ScriptEngine.fDumpByteCode = !!enable; }
@@ -20,30 +20,32 @@
 
 
 // *** C4Set
-template<> template<>
-unsigned int C4Set<C4String *>::Hash<const char *>(const char * const & s)
+C4StringKey::C4StringKey(const char *Data, size_t Length): Data(Data), Length(Length)
 {
 	// Fowler/Noll/Vo hash
 	unsigned int h = 2166136261u;
-	const char * p = s;
-	while (*p)
-		h = (h ^ *(p++)) * 16777619;
-	return h;
-}
-
-template<> template<>
-bool C4Set<C4String *>::Equals<const char *>(C4String * const & a, const char * const & b)
-{
-	return a->GetData() == b;
+	for (size_t i = 0; i < Length; ++i)
+		h = (h ^ Data[i]) * 16777619;
+	Hash = h;
 }
 
 // *** C4String
 
-C4String::C4String(StdStrBuf strString)
+C4String::C4String(StdStrBuf strString, unsigned int iHash)
 {
-	// take string
-	Data.Take(std::move(strString));
-	Hash = Strings.Set.Hash(Data.getData());
+	// take string, or copy it into the string itself if it's short
+	size_t iLength = strString.getLength();
+	if (iLength <= ShortLength)
+	{
+		std::memcpy(Short, strString.getData(), iLength);
+		Short[iLength] = '\0';
+		Data.Ref(Short, iLength);
+	}
+	else
+	{
+		Data.Take(std::move(strString));
+	}
+	Hash = iHash;
 	// reg
 	Strings.Set.Add(this);
 }
@@ -70,11 +72,48 @@ void C4String::operator=(const char * s)
 	assert(!Data);
 	// ref string
 	Data.Ref(s);
-	Hash = Strings.Set.Hash(Data.getData());
+	Hash = C4StringKey(Data.getData(), Data.getLength()).Hash;
 	// reg
 	Strings.Set.Add(this);
 }
 
+void *C4String::operator new(size_t iSize)
+{
+	assert(iSize == sizeof(C4String));
+	return Strings.StringArena.Alloc();
+}
+
+void C4String::operator delete(void *pMem)
+{
+	Strings.StringArena.Free(pMem);
+}
+
+// *** C4StringTable::Arena
+
+void *C4StringTable::Arena::Alloc()
+{
+	if (!pFree)
+	{
+		// chain a new block into the free list
+		Blocks.emplace_back(new Slot[BlockSize]);
+		Slot *pBlock = Blocks.back().get();
+		for (size_t i = 0; i < BlockSize; ++i)
+			pBlock[i].pNext = (i + 1 < BlockSize) ? &pBlock[i + 1] : nullptr;
+		pFree = pBlock;
+	}
+	Slot *pSlot = pFree;
+	pFree = pSlot->pNext;
+	return pSlot;
+}
+
+void C4StringTable::Arena::Free(void *pMem)
+{
+	if (!pMem) return;
+	Slot *pSlot = static_cast<Slot *>(pMem);
+	pSlot->pNext = pFree;
+	pFree = pSlot;
+}
+
 // *** C4StringTable
 
 C4StringTable::C4StringTable()
@@ -366,14 +405,15 @@ C4StringTable::~C4StringTable()
 
 C4String *C4StringTable::RegString(StdStrBuf String)
 {
-	C4String * s = FindString(String.getData());
+	C4StringKey Key(String.getData(), String.getLength());
+	C4String * s = Set.Get(Key);
 	if (s)
 		return s;
 	else
-		return new C4String(String);
+		return new C4String(std::move(String), Key.Hash);
 }
 
 C4String *C4StringTable::FindString(const char *strString) const
 {
-	return Set.Get(strString);
+	return Set.Get(C4StringKey(strString, std::strlen(strString)));
 }
@@ -36,12 +36,21 @@ class C4String: public C4RefCnt
 public:
 	unsigned int Hash;
 private:
-	StdCopyStrBuf Data; // string data
+	// strings up to this length are stored in the C4String itself
+	static const size_t ShortLength = 23;
 
-	explicit C4String(StdStrBuf strString);
+	StdCopyStrBuf Data; // string data, might reference Short
+	char Short[ShortLength + 1];
+
+	C4String(StdStrBuf strString, unsigned int iHash);
 	C4String();
+	C4String(const C4String &) = delete;
 	void operator=(const char * s);
 
+	// allocated from C4StringTable::Arena
+	static void *operator new(size_t iSize);
+	static void operator delete(void *pMem);
+
 	friend class C4StringTable;
 public:
 	~C4String() override;
@@ -217,6 +226,9 @@ public:
 		return !!*r;
 	}
 	unsigned int GetSize() const { return Size; }
+	// direct table access, empty places included
+	unsigned int GetCapacity() const { return Capacity; }
+	T & GetAt(unsigned int i) const { return Table[i]; }
 	T * Add(T const & e)
 	{
 		MaintainCapacity();
@@ -289,6 +301,26 @@ public:
 	}
 };
 
+// A string to look up in the string table, hashed only once
+struct C4StringKey
+{
+	const char *Data;
+	size_t Length;
+	unsigned int Hash;
+	C4StringKey(const char *Data, size_t Length);
+};
+
+template<> template<>
+inline unsigned int C4Set<C4String *>::Hash<C4StringKey>(const C4StringKey & e)
+{
+	return e.Hash;
+}
+template<> template<>
+inline bool C4Set<C4String *>::Equals<C4StringKey>(C4String * const & a, const C4StringKey & b)
+{
+	// most entries on the probe sequence differ in the hash, so skip comparing those
+	return a->Hash == b.Hash && a->GetData().getLength() == b.Length && !std::memcmp(a->GetCStr(), b.Data, b.Length);
+}
 template<> template<>
 inline unsigned int C4Set<C4String *>::Hash<const C4String *>(const C4String * const & e)
 {
@@ -571,6 +603,23 @@ public:
 	C4String *FindString(const char *strString) const;
 
 private:
+	// Fixed size blocks for C4Strings. Scripts create and drop lots of temporary
+	// strings, so freed ones are kept around for reuse.
+	class Arena
+	{
+		union Slot
+		{
+			Slot *pNext;
+			alignas(C4String) char Mem[sizeof(C4String)];
+		};
+		static const size_t BlockSize = 256;
+		std::vector<std::unique_ptr<Slot[]>> Blocks;
+		Slot *pFree{nullptr};
+	public:
+		void *Alloc();
+		void Free(void *pMem);
+	} StringArena; // before the set, so it is destroyed after all strings
+
 	C4Set<C4String *> Set;
 	friend class C4String;
 
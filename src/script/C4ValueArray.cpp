@@ -19,34 +19,109 @@
 #include "object/C4FindObject.h"
 #include "script/C4Aul.h"
 
-C4ValueArray::C4ValueArray() = default;
+C4ValueArray::C4ValueArray(): C4ScriptHeapObject(true)
+{
+}
 
-C4ValueArray::C4ValueArray(int32_t inSize)
+C4ValueArray::C4ValueArray(int32_t inSize): C4ScriptHeapObject(true)
 {
 	SetSize(inSize);
 }
 
-C4ValueArray::C4ValueArray(const C4ValueArray &ValueArray2)
+C4ValueArray::C4ValueArray(const C4ValueArray &ValueArray2): C4RefCnt(), C4ScriptHeapObject(true)
 {
-	SetSize(ValueArray2.GetSize());
-	for (int32_t i = 0; i < iSize; i++)
-		pData[i].Set(ValueArray2.GetItem(i));
+	Share(ValueArray2, 0, ValueArray2.GetSize());
 }
 
 C4ValueArray::~C4ValueArray()
 {
-	delete[] pData; pData = nullptr;
-	iSize = iCapacity = 0;
+	ReleaseBuffer();
+	iSize = 0;
 }
 
 C4ValueArray &C4ValueArray::operator =(const C4ValueArray& ValueArray2)
 {
-	this->SetSize(ValueArray2.GetSize());
-	for (int32_t i = 0; i < iSize; i++)
-		pData[i].Set(ValueArray2.GetItem(i));
+	assert(!constant);
+	if (this != &ValueArray2)
+		Share(ValueArray2, 0, ValueArray2.GetSize());
 	return *this;
 }
 
+void C4ValueArray::Share(const C4ValueArray &Other, int32_t iStart, int32_t iLength)
+{
+	// take the new buffer first, it might be the current one
+	Buffer *pNewBuffer = Other.pBuffer;
+	C4Value *pNewData = Other.pData + iStart;
+	if (pNewBuffer) ++pNewBuffer->RefCnt;
+	ReleaseBuffer();
+	if (pNewBuffer) UseBuffer(pNewBuffer, pNewData);
+	iSize = iLength;
+}
+
+void C4ValueArray::Reallocate(int32_t iNewCapacity)
+{
+	// copy the values, the old buffer might still be used by other arrays
+	Buffer *pNewBuffer = new Buffer(iNewCapacity);
+	int32_t iKeep = std::min(iSize, iNewCapacity);
+	for (int32_t i = 0; i < iKeep; i++)
+		pNewBuffer->pValues[i] = pData[i];
+	ReplaceBuffer(pNewBuffer);
+	iSize = iKeep;
+}
+
+void C4ValueArray::UseBuffer(Buffer *pNewBuffer, C4Value *pNewData)
+{
+	pBuffer = pNewBuffer;
+	pData = pNewData;
+	pPrevSharer = nullptr;
+	pNextSharer = pNewBuffer->pFirstSharer;
+	if (pNextSharer) pNextSharer->pPrevSharer = this;
+	pNewBuffer->pFirstSharer = this;
+}
+
+void C4ValueArray::ReplaceBuffer(Buffer *pNewBuffer)
+{
+	// The collector can't see the values of a shared buffer, so this array
+	// may have been let go while it was part of a cycle. Check it again.
+	bool fWasShared = IsShared();
+	ReleaseBuffer();
+	UseBuffer(pNewBuffer, pNewBuffer->pValues);
+	if (fWasShared) ReferenceDropped();
+}
+
+void C4ValueArray::ReleaseBuffer()
+{
+	Buffer *pOldBuffer = pBuffer;
+	if (!pOldBuffer) return;
+	if (pPrevSharer)
+		pPrevSharer->pNextSharer = pNextSharer;
+	else
+		pOldBuffer->pFirstSharer = pNextSharer;
+	if (pNextSharer) pNextSharer->pPrevSharer = pPrevSharer;
+	pPrevSharer = pNextSharer = nullptr;
+	pBuffer = nullptr;
+	pData = nullptr;
+	// deleting the values can delete other arrays, so do it last
+	if (!--pOldBuffer->RefCnt)
+		delete pOldBuffer;
+	else if (pOldBuffer->RefCnt == 1 && pOldBuffer->pFirstSharer)
+	{
+		// The values outside the window of the last array are unreachable now, but the collector
+		// would not see them. Take them out of the buffer first, as dropping them can delete that array.
+		C4ValueArray *pLast = pOldBuffer->pFirstSharer;
+		int32_t iStart = int32_t(pLast->pData - pOldBuffer->pValues), iEnd = iStart + pLast->iSize;
+		std::vector<C4Value> Dropped;
+		for (int32_t i = 0; i < pOldBuffer->Capacity; i++)
+			if ((i < iStart || i >= iEnd) && pOldBuffer->pValues[i].GetType() != C4V_Nil)
+			{
+				Dropped.push_back(pOldBuffer->pValues[i]);
+				pOldBuffer->pValues[i].Set0();
+			}
+		// the last array now shows its values to the collector, so check it again
+		pLast->ReferenceDropped();
+	}
+}
+
 class C4SortObjectSTL
 {
 private:
@@ -71,6 +146,7 @@ public:
 void C4ValueArray::Sort(class C4SortObject &rSort)
 {
 	assert(!constant);
+	Unshare();
 	if (rSort.PrepareCache(this))
 	{
 		// Initialize position array
@@ -105,6 +181,7 @@ struct C4ValueArraySortStringscomp
 void C4ValueArray::SortStrings()
 {
 	assert(!constant);
+	Unshare();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortStringscomp());
 }
 
@@ -122,6 +199,7 @@ struct C4ValueArraySortcomp
 void C4ValueArray::Sort(bool descending)
 {
 	assert(!constant);
+	Unshare();
 	// sort by whatever type the values have
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortcomp());
 	if (descending) std::reverse(pData, pData+iSize);
@@ -149,6 +227,7 @@ bool C4ValueArray::SortByProperty(C4String *prop_name, bool descending)
 		if (!pData[i].getPropList())
 			return false;
 	// now sort
+	Unshare();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortPropertycomp(prop_name));
 	if (descending) std::reverse(pData, pData+iSize);
 	return true;
@@ -178,6 +257,7 @@ bool C4ValueArray::SortByArrayElement(int32_t element_idx, bool descending)
 			return false;
 	}
 	// now sort
+	Unshare();
 	std::stable_sort(pData, pData+iSize, C4ValueArraySortArrayElementcomp(element_idx));
 	if (descending) std::reverse(pData, pData+iSize);
 	return true;
@@ -189,6 +269,7 @@ C4Value &C4ValueArray::operator[](int32_t iElem)
 	assert(iElem >= 0);
 	assert(!constant);
 	if (iElem >= iSize && iElem < MaxSize) this->SetSize(iElem + 1);
+	else Unshare();
 	// out-of-memory? This might not get caught, but it's better than a segfault
 	assert(iElem < iSize);
 	// return
@@ -207,6 +288,7 @@ void C4ValueArray::SetItem(int32_t iElem, const C4Value &Value)
 	// out-of-memory? This might not get caught, but it's better than a segfault
 	if (iElem >= iSize)
 		throw C4AulExecError("array access: index too large");
+	Unshare();
 	// set
 	pData[iElem]=Value;
 }
@@ -216,31 +298,33 @@ void C4ValueArray::SetSize(int32_t inSize)
 	if(inSize == iSize) return;
 	assert(!constant);
 
-	// array not larger than allocated memory? Well, just ignore the additional allocated mem then
-	if (inSize <= iCapacity)
+	// shrinking: values past the end of a shared buffer still belong to the other arrays
+	if (inSize < iSize)
 	{
-		// free values in undefined area, do nothing if new is larger than old
-		for (int i=inSize; i<iSize; i++) pData[i].Set0();
-		iSize=inSize;
+		if (!IsShared())
+			for (int32_t i = inSize; i < iSize; i++) pData[i].Set0();
+		iSize = inSize;
 		return;
 	}
 
 	// bounds check
 	if (inSize > MaxSize) return;
 
-	// create new array
-	C4Value* pnData = new C4Value [inSize];
-	if (!pnData) return;
-
-	// move existing values
-	int32_t i;
-	for (i=0; i<iSize; i++)
-		pnData[i] = pData[i];
+	// enough memory allocated? The values there might be left over from before shrinking.
+	if (inSize <= GetCapacity() && !IsShared())
+	{
+		for (int32_t i = iSize; i < inSize; i++) pData[i].Set0();
+		iSize = inSize;
+		return;
+	}
 
-	// replace
-	delete[] pData;
-	pData = pnData;
-	iSize = iCapacity = inSize;
+	// Grow geometrically, so arr[GetLength(arr)] = x in a loop only copies the
+	// array a logarithmic number of times. New arrays get their exact size.
+	int32_t iNewCapacity = inSize;
+	if (iSize > 0)
+		iNewCapacity = std::max(inSize, std::min(iSize * 2, int32_t(MaxSize)));
+	Reallocate(iNewCapacity);
+	iSize = inSize;
 }
 
 bool C4ValueArray::operator==(const C4ValueArray& IntList2) const
@@ -254,12 +338,34 @@ bool C4ValueArray::operator==(const C4ValueArray& IntList2) const
 
 void C4ValueArray::Reset()
 {
-	delete[] pData; pData = nullptr;
-	iSize = iCapacity = 0;
+	ReleaseBuffer();
+	iSize = 0;
+}
+
+void C4ValueArray::GetHeapChildren(std::vector<C4ScriptHeapObject *> &Children) const
+{
+	// The references in a shared buffer count only once. Leaving them out keeps
+	// whatever they reference alive, so the collector stays safe.
+	if (IsShared()) return;
+	for (int32_t i = 0; i < iSize; i++)
+		if (C4ScriptHeapObject *pChild = GetHeapObject(pData[i]))
+			Children.push_back(pChild);
+}
+
+void C4ValueArray::ClearHeapChildren()
+{
+	// also for frozen arrays
+	Reset();
+}
+
+C4Value C4ValueArray::GetHeapValue()
+{
+	return C4VArray(this);
 }
 
 void C4ValueArray::Denumerate(C4ValueNumbers * numbers)
 {
+	Unshare();
 	for (int32_t i = 0; i < iSize; i++)
 		pData[i].Denumerate(numbers);
 }
@@ -275,7 +381,11 @@ void C4ValueArray::CompileFunc(class StdCompiler *pComp, C4ValueNumbers * number
 	// Separator
 	pComp->Separator(StdCompiler::SEP_SEP2);
 	// Allocate
-	if (pComp->isDeserializer()) this->SetSize(inSize);
+	if (pComp->isDeserializer())
+	{
+		this->SetSize(inSize);
+		Unshare();
+	}
 	// Values
 	pComp->Value(mkArrayAdaptMap(pData, iSize, C4Value(), mkParAdaptMaker(numbers)));
 }
@@ -293,7 +403,16 @@ C4ValueArray * C4ValueArray::GetSlice(int32_t startIndex, int32_t endIndex)
 	else if (endIndex < -iSize) throw C4AulExecError("array slice: end index out of range");
 	else if (endIndex < 0) endIndex += iSize;
 
-	C4ValueArray* NewArray = new C4ValueArray(std::max(0, endIndex - startIndex));
+	// Share the values, unless the slice is so small that it would mostly keep
+	// unused values alive. Those are cheap to copy.
+	int32_t iLength = std::max(0, endIndex - startIndex);
+	C4ValueArray* NewArray = new C4ValueArray;
+	if (iLength > 0 && iLength * 4 >= pBuffer->Capacity)
+	{
+		NewArray->Share(*this, startIndex, iLength);
+		return NewArray;
+	}
+	NewArray->SetSize(iLength);
 	for (int i = startIndex; i < endIndex; ++i)
 		NewArray->pData[i - startIndex] = pData[i];
 	return NewArray;
@@ -318,7 +437,9 @@ void C4ValueArray::SetSlice(int32_t startIndex, int32_t endIndex, const C4Value
 	// setting an array?
 	if(Val.GetType() == C4V_Array)
 	{
-		const C4ValueArray &Other = *Val._getArray(); // Remember that &Other could be equal to this, carefull with modifying pData
+		// Hold on to the inserted values. If they are (a slice of) this array, changing
+		// this array now makes it copy its buffer, so Other keeps the old values.
+		C4ValueArray Other(*Val._getArray());
 
 		// Calculcate new size
 		int32_t iNewEnd = std::min(startIndex + Other.GetSize(), (int32_t)MaxSize);
@@ -327,63 +448,48 @@ void C4ValueArray::SetSlice(int32_t startIndex, int32_t endIndex, const C4Value
 			iNewSize += iSize - endIndex;
 		iNewSize = std::min(iNewSize, (int32_t)MaxSize);
 		int32_t iOtherSize = Other.GetSize();
+		int32_t i,j;
 
-		if(iNewSize != iSize)
+		if(IsShared() || iNewSize > GetCapacity())
 		{
-			int32_t i,j;
-			C4Value* pnData = pData;
-
-			if(iNewSize > iCapacity)
-			{
-				 pnData = new C4Value [iNewSize];
-
-				 // Copy first part of old array
-				for(i = 0; i < startIndex && i < iSize; ++i)
-					pnData[i] = pData[i];
-			}
-
-			// Copy the second slice of the new array
+			// Build the result in a new buffer
+			Buffer *pNewBuffer = new Buffer(iNewSize);
+			C4Value *pnData = pNewBuffer->pValues;
+			for(i = 0; i < startIndex && i < iSize; ++i)
+				pnData[i] = pData[i];
 			for(i = iNewEnd, j = endIndex; i < iNewSize; ++i, ++j)
-			{
-				assert(j < iSize);
 				pnData[i] = pData[j];
-			}
-
-			// Copy the data
-			// Since pnData and pData can be the same, we can not copy with
-			//for(i = startIndex, j = 0; i < iNewEnd; ++i, ++j)
-			// but have to start from the end of the copied sequence. That works, since j <= i
-			for(i = iNewEnd - 1, j = iNewEnd - startIndex - 1; i >= startIndex; --i, --j)
-			{
-				assert(j < iOtherSize);
-				pnData[i] = Other.pData[j];
-			}
-
-			// Other values should have been initialized to 0 by new
-			if(pData != pnData)
-			{
-				delete [] pData;
-				pData = pnData;
-				iCapacity = iSize = iNewSize;
-			}
+			ReplaceBuffer(pNewBuffer);
+		}
+		else
+		{
+			// Move the rest of the array into place. Go backwards if it moves up,
+			// so no value is overwritten before it is copied.
+			int32_t iTail = iNewSize - iNewEnd;
+			if(iNewEnd <= endIndex)
+				for(i = 0; i < iTail; ++i)
+					pData[iNewEnd + i] = pData[endIndex + i];
 			else
-			{
-				// "ignore" the now unused part
-				for(i = iNewSize; i < iSize; ++i)
-					pData[i].Set0();
-				iSize = iNewSize;
-			}
-
-		} else // slice has the same size as inserted array
-			// Copy the data. changing pData does not break because if &Other == this and iNewSize == iSize, nothing happens at all
-			for(int32_t i = startIndex, j = 0; j < iOtherSize; i++, j++)
-				pData[i] = Other.pData[j];
+				for(i = iTail - 1; i >= 0; --i)
+					pData[iNewEnd + i] = pData[endIndex + i];
+			// clear values which are not part of the array anymore, and the gap if the slice starts after the end
+			for(i = iNewSize; i < iSize; ++i)
+				pData[i].Set0();
+			for(i = iSize; i < startIndex; ++i)
+				pData[i].Set0();
+		}
+		iSize = iNewSize;
+
+		// Copy the inserted values
+		for(i = startIndex, j = 0; j < iOtherSize && i < iNewEnd; ++i, ++j)
+			pData[i] = Other.pData[j];
 
 	} else /* if(Val.GetType() != C4V_Array) */ {
 		if(endIndex > MaxSize) endIndex = iSize;
 
 		// Need resize?
 		if(endIndex > iSize) SetSize(endIndex);
+		else Unshare();
 
 		// Fill
 		for(int32_t i = startIndex; i < endIndex; i++)
@@ -14,13 +14,14 @@
  * for the above references.
  */
 
+#include "script/C4ScriptHeap.h"
 #include "script/C4Value.h"
 
 #ifndef INC_C4ValueList
 #define INC_C4ValueList
 
 // reference counted array of C4Values
-class C4ValueArray: public C4RefCnt
+class C4ValueArray: public C4RefCnt, public C4ScriptHeapObject
 {
 public:
 	static const int MaxSize = 1000000; // ye shalt not create arrays larger than that!
@@ -31,6 +32,9 @@ public:
 
 	~C4ValueArray() override;
 
+	// the remaining references might be a cycle
+	void DecRef() { if (!--RefCnt) delete this; else ReferenceDropped(); }
+
 	C4ValueArray &operator =(const C4ValueArray&);
 
 	int32_t GetSize() const { return iSize; }
@@ -55,7 +59,7 @@ public:
 
 	void Reset();
 	void SetItem(int32_t iElemNr, const C4Value &Value); // interface for script
-	void SetSize(int32_t inSize); // (enlarge only!)
+	void SetSize(int32_t inSize); // grows the capacity geometrically, so appending values is cheap
 
 	// for arrays declared in script constants
 	void Freeze() { constant = true; }
@@ -81,10 +85,37 @@ public:
 	bool SortByProperty(C4String *prop_name, bool descending=false); // checks that this is an array of all proplists and sorts by values of given property. return false if an element is not a proplist.
 	bool SortByArrayElement(int32_t array_idx, bool descending=false); // checks that this is an array of all arrays and sorts by array elements at index. returns false if an element is not an array or smaller than array_idx+1
 
+protected:
+	uint32_t GetHeapRefCount() const override { return RefCnt; }
+	void GetHeapChildren(std::vector<C4ScriptHeapObject *> &Children) const override;
+	void ClearHeapChildren() override;
+	C4Value GetHeapValue() override;
+
 private:
-	C4Value* pData{nullptr};
-	int32_t iSize{0}, iCapacity{0};
+	// The values, shared by copies and slices until one of them is changed
+	struct Buffer
+	{
+		int32_t RefCnt{1};
+		int32_t Capacity;
+		C4Value *pValues;
+		C4ValueArray *pFirstSharer{nullptr}; // the arrays using this buffer
+		explicit Buffer(int32_t iCapacity): Capacity(std::max<int32_t>(iCapacity, 0)), pValues(new C4Value[Capacity]) { assert(iCapacity >= 0); }
+		~Buffer() { delete[] pValues; }
+	};
+	Buffer *pBuffer{nullptr};
+	C4Value* pData{nullptr}; // this array's values inside pBuffer
+	C4ValueArray *pPrevSharer{nullptr}, *pNextSharer{nullptr}; // other arrays using pBuffer
+	int32_t iSize{0};
 	bool constant{false}; // if true, this array is not changeable
+
+	bool IsShared() const { return pBuffer && pBuffer->RefCnt > 1; }
+	int32_t GetCapacity() const { return pBuffer ? pBuffer->Capacity - int32_t(pData - pBuffer->pValues) : 0; }
+	void Share(const C4ValueArray &Other, int32_t iStart, int32_t iLength);
+	void Unshare() { if (IsShared()) Reallocate(iSize); } // call before changing values
+	void Reallocate(int32_t iNewCapacity);
+	void UseBuffer(Buffer *pNewBuffer, C4Value *pNewData); // pNewBuffer->RefCnt must already count this array
+	void ReplaceBuffer(Buffer *pNewBuffer);
+	void ReleaseBuffer();
 };
 
 #endif
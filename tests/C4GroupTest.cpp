@@ -0,0 +1,200 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2019, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "c4group/C4Group.h"
+#include "c4group/CStdFile.h"
+#include "platform/StdFile.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	// Files and nested child groups, enough of both for EntryCRC32 to use several threads
+	bool CreateGroupDirectory(const std::string &path, int iDepth, int iSeed)
+	{
+		EraseItem(path.c_str());
+		if (!CreatePath(path)) return false;
+		for (int i = 0; i < 12; ++i)
+		{
+			StdStrBuf data;
+			for (int j = 0; j < (i * 37 + iSeed) % 300; ++j)
+				data.AppendFormat("%d,", (i + 1) * (j + iSeed));
+			if (!data.SaveToFile((path + DirSep + FormatString("File%d.txt", i).getData()).c_str())) return false;
+		}
+		// Packing uses temporary files named like the child groups, so those differ between the levels
+		if (iDepth)
+			for (int i = 0; i < 8; ++i)
+				if (!CreateGroupDirectory(path + DirSep + FormatString("Level%dChild%d.ocd", iDepth, i).getData(), iDepth - 1, iSeed + i))
+					return false;
+		return true;
+	}
+
+	bool CreatePackedGroup(const char *filename, int iSeed, bool fIndexed)
+	{
+		// child groups are resorted when packed, as by the engine
+		C4Group_SetSortList(C4CFN_FLS);
+		if (!CreateGroupDirectory(filename, 2, iSeed) || !C4Group_PackDirectory(filename)) return false;
+		if (!fIndexed) return true;
+		C4Group grp;
+		return grp.Open(filename) && grp.SetIndexed(true) && grp.Close();
+	}
+
+	// Every entry read one after another, without C4Group::EntryCRC32
+	uint32_t SerialCRC32(C4Group &grp)
+	{
+		std::vector<std::string> names;
+		StdStrBuf name;
+		grp.ResetSearch();
+		while (grp.FindNextEntry("*", &name))
+			names.emplace_back(name.getData());
+		uint32_t CRC = 0;
+		for (const std::string &entry : names)
+		{
+			if (WildcardMatch("*.ocd", entry.c_str()))
+			{
+				C4Group child;
+				EXPECT_TRUE(child.OpenAsChild(&grp, entry.c_str()));
+				CRC ^= SerialCRC32(child);
+			}
+			else
+			{
+				StdBuf data;
+				EXPECT_TRUE(grp.LoadEntry(entry.c_str(), &data));
+				// non-empty files count with their name
+				if (data.getSize())
+					CRC ^= crc32(crc32(0, static_cast<const Bytef *>(data.getData()), data.getSize()), reinterpret_cast<const Bytef *>(entry.c_str()), entry.size());
+			}
+		}
+		return CRC;
+	}
+
+	uint32_t SerialCRC32(const char *filename)
+	{
+		C4Group grp;
+		EXPECT_TRUE(grp.Open(filename));
+		return SerialCRC32(grp);
+	}
+
+	uint32_t EntryCRC32(const char *filename)
+	{
+		C4Group grp;
+		EXPECT_TRUE(grp.Open(filename));
+		return grp.EntryCRC32();
+	}
+
+	uint32_t FileContentsCRC32(const char *filename)
+	{
+		StdBuf data;
+		EXPECT_TRUE(data.LoadFromFile(filename));
+		return crc32(0, static_cast<const Bytef *>(data.getData()), data.getSize());
+	}
+
+	uint32_t FileCRC32(const char *filename)
+	{
+		uint32_t CRC = 0;
+		EXPECT_TRUE(GetFileCRC(filename, &CRC));
+		return CRC;
+	}
+
+	// Cached checksums are only used for files older than the resolution of their modification time
+	void WaitForCacheableAge()
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(3));
+	}
+}
+
+TEST(C4GroupTest, EntryCRC32)
+{
+	const char *unpacked = "C4GroupTest.Unpacked.ocs", *packed = "C4GroupTest.Packed.ocs", *indexed = "C4GroupTest.Indexed.ocs";
+	ASSERT_TRUE(CreateGroupDirectory(unpacked, 2, 0));
+	ASSERT_TRUE(CreatePackedGroup(packed, 0, false));
+	ASSERT_TRUE(CreatePackedGroup(indexed, 0, true));
+	{
+		C4Group grp;
+		ASSERT_TRUE(grp.Open(indexed));
+		EXPECT_TRUE(grp.IsIndexed());
+	}
+
+	const uint32_t expected = SerialCRC32(unpacked);
+	EXPECT_NE(0u, expected);
+	EXPECT_EQ(expected, EntryCRC32(unpacked));
+	EXPECT_EQ(expected, SerialCRC32(packed));
+	EXPECT_EQ(expected, EntryCRC32(packed));
+	EXPECT_EQ(expected, SerialCRC32(indexed));
+	EXPECT_EQ(expected, EntryCRC32(indexed));
+
+	// Checksums of part of the entries
+	C4Group grp;
+	ASSERT_TRUE(grp.Open(indexed));
+	uint32_t iChildCRC = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		C4Group child;
+		ASSERT_TRUE(child.OpenAsChild(&grp, FormatString("Level2Child%d.ocd", i).getData()));
+		iChildCRC ^= SerialCRC32(child);
+	}
+	EXPECT_EQ(iChildCRC, grp.EntryCRC32("*.ocd"));
+	EXPECT_TRUE(grp.Close());
+
+	EXPECT_TRUE(EraseItem(unpacked));
+	EXPECT_TRUE(EraseItem(packed));
+	EXPECT_TRUE(EraseItem(indexed));
+}
+
+TEST(C4GroupTest, ChecksumCacheInvalidation)
+{
+	const char *file = "C4GroupTest.txt", *packed = "C4GroupTest.Cached.ocs";
+	// Files changed right after being checksummed must not be taken from the cache, even if their size and time stay the same
+	StdStrBuf data;
+	data.Copy("first contents");
+	ASSERT_TRUE(data.SaveToFile(file));
+	EXPECT_EQ(FileContentsCRC32(file), FileCRC32(file));
+	data.Copy("other contents");
+	ASSERT_TRUE(data.SaveToFile(file));
+	EXPECT_EQ(FileContentsCRC32(file), FileCRC32(file));
+	ASSERT_TRUE(CreatePackedGroup(packed, 0, true));
+	const uint32_t iFirstGroupCRC = SerialCRC32(packed);
+	EXPECT_EQ(iFirstGroupCRC, EntryCRC32(packed));
+
+	// Older files are cached
+	WaitForCacheableAge();
+	for (int i = 0; i < 2; ++i)
+	{
+		EXPECT_EQ(FileContentsCRC32(file), FileCRC32(file));
+		EXPECT_EQ(SerialCRC32(packed), EntryCRC32(packed));
+	}
+
+	// Changed files are not found in the cache, neither right away nor once they are old enough
+	data.Copy("third contents");
+	ASSERT_TRUE(data.SaveToFile(file));
+	ASSERT_TRUE(CreatePackedGroup(packed, 1, true));
+	const uint32_t iFileCRC = FileContentsCRC32(file), iGroupCRC = SerialCRC32(packed);
+	ASSERT_NE(iFirstGroupCRC, iGroupCRC);
+	EXPECT_EQ(iFileCRC, FileCRC32(file));
+	EXPECT_EQ(iGroupCRC, EntryCRC32(packed));
+	WaitForCacheableAge();
+	for (int i = 0; i < 2; ++i)
+	{
+		EXPECT_EQ(iFileCRC, FileCRC32(file));
+		EXPECT_EQ(iGroupCRC, EntryCRC32(packed));
+	}
+
+	EXPECT_TRUE(EraseItem(file));
+	EXPECT_TRUE(EraseItem(packed));
+}
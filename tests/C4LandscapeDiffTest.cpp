@@ -0,0 +1,129 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2019, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "c4group/C4Components.h"
+#include "c4group/C4Group.h"
+#include "graphics/CSurface8.h"
+#include "landscape/C4LandscapeDiff.h"
+#include "platform/StdFile.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	const int Wdt = 16, Hgt = 12;
+	// packed groups move the files on close, so each entry needs its own
+	const char *TempFilename = "C4LandscapeDiffTest.bmp", *TempFilenameBkg = "C4LandscapeDiffTestBkg.bmp";
+
+	void CreateLandscape(CSurface8 &sfc, const std::vector<uint8_t> &pixels)
+	{
+		ASSERT_TRUE(sfc.Create(Wdt, Hgt));
+		for (int y = 0; y < Hgt; y++)
+			for (int x = 0; x < Wdt; x++)
+				sfc.SetPix(x, y, pixels[y * Wdt + x]);
+	}
+
+	std::vector<uint8_t> GetPixels(const CSurface8 &sfc)
+	{
+		std::vector<uint8_t> pixels;
+		for (int y = 0; y < Hgt; y++)
+			for (int x = 0; x < Wdt; x++)
+				pixels.push_back(sfc.GetPix(x, y));
+		return pixels;
+	}
+
+	std::vector<uint8_t> Change(std::vector<uint8_t> pixels, int iFirst, int iStep, uint8_t col)
+	{
+		for (size_t i = iFirst; i < pixels.size(); i += iStep)
+			pixels[i] = col;
+		return pixels;
+	}
+
+	bool SaveDiff(const char *filename, const std::vector<uint8_t> &initial, const std::vector<uint8_t> &initial_bkg,
+		const std::vector<uint8_t> &current, const std::vector<uint8_t> &current_bkg, bool fSyncSave, bool fSaveUnchanged)
+	{
+		EraseItem(filename);
+		CSurface8 sfc, sfc_bkg;
+		CreateLandscape(sfc, current);
+		CreateLandscape(sfc_bkg, current_bkg);
+		C4Group grp;
+		if (!grp.Open(filename, true)) return false;
+		if (!SaveLandscapeDiff(sfc, initial.data(), grp, C4CFN_DiffLandscape, TempFilename, fSyncSave, fSaveUnchanged)) return false;
+		if (!SaveLandscapeDiff(sfc_bkg, initial_bkg.data(), grp, C4CFN_DiffLandscapeBkg, TempFilenameBkg, fSyncSave, fSaveUnchanged)) return false;
+		// the landscape itself must not be changed by saving
+		EXPECT_EQ(current, GetPixels(sfc));
+		EXPECT_EQ(current_bkg, GetPixels(sfc_bkg));
+		return grp.Close();
+	}
+}
+
+// A runtime joining client recreates the initial landscape and applies the landscape diff of
+// the network dynamic, which C4Network2::RetrieveScenario merged into its copy of the scenario
+TEST(C4LandscapeDiffTest, NetworkDynamicOverScenarioDiff)
+{
+	const char *scenario = "C4LandscapeDiffTest.Scenario.ocs", *dynamic = "C4LandscapeDiffTest.Dynamic.ocs";
+	std::vector<uint8_t> initial(Wdt * Hgt), initial_bkg(Wdt * Hgt);
+	for (size_t i = 0; i < initial.size(); i++)
+	{
+		initial[i] = uint8_t(1 + i % 7);
+		initial_bkg[i] = uint8_t(20 + i % 3);
+	}
+	// the scenario is a savegame, so it already contains changes against the initial landscape
+	ASSERT_TRUE(SaveDiff(scenario, initial, initial_bkg, Change(initial, 0, 5, 30), Change(initial_bkg, 1, 4, 31), false, false));
+	// the host changed other pixels since, and restored the background
+	std::vector<uint8_t> current = Change(Change(initial, 0, 5, 30), 2, 9, 40);
+	ASSERT_TRUE(SaveDiff(dynamic, initial, initial_bkg, current, initial_bkg, false, true));
+
+	ASSERT_TRUE(C4Group_UnpackDirectory(scenario));
+	ASSERT_TRUE(C4Group_UnpackDirectory(dynamic));
+	C4Group grp;
+	ASSERT_TRUE(grp.Open(scenario));
+	ASSERT_TRUE(grp.Merge(dynamic));
+
+	CSurface8 sfc, sfc_bkg;
+	CreateLandscape(sfc, initial);
+	CreateLandscape(sfc_bkg, initial_bkg);
+	EXPECT_TRUE(ApplyLandscapeDiff(sfc, grp, C4CFN_DiffLandscape));
+	EXPECT_TRUE(ApplyLandscapeDiff(sfc_bkg, grp, C4CFN_DiffLandscapeBkg));
+	EXPECT_EQ(current, GetPixels(sfc));
+	EXPECT_EQ(initial_bkg, GetPixels(sfc_bkg));
+	EXPECT_TRUE(grp.Close());
+
+	EXPECT_TRUE(EraseItem(scenario));
+	EraseItem(dynamic);
+}
+
+TEST(C4LandscapeDiffTest, UnchangedDiff)
+{
+	// Savegames leave out diffs without changes, network dynamics must not
+	const char *filename = "C4LandscapeDiffTest.ocs";
+	std::vector<uint8_t> initial(Wdt * Hgt, 3);
+	for (bool fSaveUnchanged : { false, true })
+	{
+		ASSERT_TRUE(SaveDiff(filename, initial, initial, initial, initial, false, fSaveUnchanged));
+		C4Group grp;
+		ASSERT_TRUE(grp.Open(filename));
+		EXPECT_EQ(fSaveUnchanged, grp.FindEntry(C4CFN_DiffLandscape));
+		EXPECT_EQ(fSaveUnchanged, grp.FindEntry(C4CFN_DiffLandscapeBkg));
+		// an unchanged diff changes nothing
+		CSurface8 sfc;
+		CreateLandscape(sfc, Change(initial, 0, 2, 9));
+		EXPECT_EQ(fSaveUnchanged, ApplyLandscapeDiff(sfc, grp, C4CFN_DiffLandscape));
+		EXPECT_EQ(Change(initial, 0, 2, 9), GetPixels(sfc));
+		EXPECT_TRUE(grp.Close());
+	}
+	EXPECT_TRUE(EraseItem(filename));
+}
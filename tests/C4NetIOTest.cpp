@@ -15,6 +15,7 @@
 
 #include <C4Include.h>
 #include "network/C4NetIO.h"
+#include "platform/StdScheduler.h"
 
 #include <gtest/gtest.h>
 
@@ -106,3 +107,73 @@ TEST_F(C4NetIOTest, TCPBind)
 
 	NetIO.Close();
 }
+
+#ifdef HAVE_SYS_EPOLL_H
+// Tests that C4NetIOTCP keeps sending queued output when waited for by epoll
+TEST_F(C4NetIOTest, TCPEpollSendQueued)
+{
+	// plain receiving socket, so only the sending side is scheduled
+	int lsock = ::socket(AF_INET, SOCK_STREAM, 0);
+	ASSERT_NE(lsock, -1);
+	sockaddr_in sa = {};
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t iAddrLen = sizeof(sa);
+	ASSERT_EQ(0, ::bind(lsock, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)));
+	ASSERT_EQ(0, ::getsockname(lsock, reinterpret_cast<sockaddr *>(&sa), &iAddrLen));
+	ASSERT_EQ(0, ::listen(lsock, 1));
+
+	struct : C4NetIO::CBClass
+	{
+		bool fConnected = false;
+		C4NetIO::addr_t PeerAddr;
+		bool OnConn(const C4NetIO::addr_t &AddrPeer, const C4NetIO::addr_t &AddrConnect, const C4NetIO::addr_t *pOwnAddr, C4NetIO *pNetIO) override
+		{
+			fConnected = true; PeerAddr = AddrPeer; return true;
+		}
+		void OnPacket(const C4NetIOPacket &rPacket, C4NetIO *pNetIO) override { }
+	} CB;
+
+	StdScheduler Scheduler;
+	Scheduler.SetUseEpoll(true);
+	C4NetIOTCP NetIO;
+	NetIO.SetCallback(&CB);
+	ASSERT_TRUE(NetIO.Init());
+	Scheduler.Add(&NetIO);
+
+	C4NetIO::addr_t addr;
+	addr.SetAddress(reinterpret_cast<sockaddr *>(&sa));
+	ASSERT_TRUE(NetIO.Connect(addr));
+	int sock = ::accept(lsock, nullptr, nullptr);
+	ASSERT_NE(sock, -1);
+	fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+	for (int i = 0; i < 100 && !CB.fConnected; i++)
+		Scheduler.ScheduleProcs(10);
+	ASSERT_TRUE(CB.fConnected);
+
+	// send much more than fits into the socket buffers at once
+	const size_t iSize = 16 << 20;
+	StdBuf Data; Data.New(iSize);
+	memset(Data.getMData(), 'x', iSize);
+	ASSERT_TRUE(NetIO.Send(C4NetIOPacket(Data.getData(), iSize, false, CB.PeerAddr)));
+
+	// everything must arrive (packet plus 5 bytes header) without further sends
+	const size_t iTotal = iSize + 5;
+	size_t iReceived = 0;
+	char Buf[65536];
+	auto tStart = C4TimeMilliseconds::Now();
+	while (iReceived < iTotal && C4TimeMilliseconds::Now() - tStart < 10000)
+	{
+		Scheduler.ScheduleProcs(10);
+		ssize_t iRead;
+		while ((iRead = ::recv(sock, Buf, sizeof(Buf), 0)) > 0)
+			iReceived += iRead;
+	}
+	EXPECT_EQ(iTotal, iReceived);
+
+	Scheduler.Remove(&NetIO);
+	NetIO.Close();
+	close(sock);
+	close(lsock);
+}
+#endif
@@ -15,6 +15,7 @@
 
 #include <C4Include.h>
 #include "platform/StdFile.h"
+#include "c4group/CStdFile.h"
 
 #include <gtest/gtest.h>
 
@@ -36,3 +37,34 @@ TEST(StdFileTest, WildcardMatchTest)
 	EXPECT_TRUE(WildcardMatch("[[]", "["));
 	EXPECT_TRUE(WildcardMatch("[[-]", "-"));
 }
+
+TEST(StdFileTest, IndexedCompressionTest)
+{
+	// some compressible and some random data spanning several blocks
+	std::vector<BYTE> data(300 * 1024);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (i < 100 * 1024) ? BYTE(i / 7) : BYTE(rand());
+	const char *filename = "StdFileTest.tmp";
+	CStdFile file;
+	ASSERT_TRUE(file.Create(filename, true, false, false, true));
+	ASSERT_TRUE(file.Write(&data[0], data.size()));
+	ASSERT_TRUE(file.Close());
+
+	ASSERT_TRUE(file.Open(filename, true));
+	EXPECT_TRUE(file.IsIndexed());
+	EXPECT_EQ(data.size(), file.AccessedEntrySize());
+	std::vector<BYTE> buf(50 * 1024);
+	// skip into the middle of a compressed block, then into the stored ones
+	ASSERT_TRUE(file.Advance(70000));
+	ASSERT_TRUE(file.Read(&buf[0], buf.size()));
+	EXPECT_TRUE(std::equal(buf.begin(), buf.end(), data.begin() + 70000));
+	ASSERT_TRUE(file.Advance(100000));
+	ASSERT_TRUE(file.Read(&buf[0], buf.size()));
+	EXPECT_TRUE(std::equal(buf.begin(), buf.end(), data.begin() + 70000 + buf.size() + 100000));
+	ASSERT_TRUE(file.Rewind());
+	ASSERT_TRUE(file.Read(&buf[0], buf.size()));
+	EXPECT_TRUE(std::equal(buf.begin(), buf.end(), data.begin()));
+	EXPECT_FALSE(file.Advance(data.size()));
+	file.Close();
+	EraseFile(filename);
+}
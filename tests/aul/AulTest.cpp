@@ -20,11 +20,18 @@
 #include "AulTest.h"
 #include "ErrorHandler.h"
 
+#include "script/C4AulExec.h"
+#include "script/C4Effect.h"
+#include "script/C4ScriptHeap.h"
 #include "script/C4ScriptHost.h"
 #include "lib/C4Random.h"
 #include "object/C4DefList.h"
 #include "TestLog.h"
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 void AulTest::SetUp()
 {
 	part_count = 0;
@@ -285,3 +292,261 @@ TEST_F(AulTest, Conditionals)
 	EXPECT_EQ(C4VInt(1), RunCode("if (true) return 1; else return 2;"));
 	EXPECT_EQ(C4VInt(2), RunCode("if (false) return 1; else return 2;"));
 }
+
+TEST_F(AulTest, ComparisonJumps)
+{
+	// Comparisons directly followed by a conditional jump run as superinstructions for int operands
+	EXPECT_EQ(C4VInt(1), RunCode("var i = 3; if (i < 5) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(2), RunCode("var i = 5; if (i < 5) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(1), RunCode("var i = 5, j = 5; if (i == j) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(2), RunCode("var i = 5, j = 6; if (i >= j) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(1), RunCode("var i = 5; if (!(i != 5)) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(1), RunScript("local i = 3; func Main() { if (i <= 3) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(10), RunCode("var n = 10, c; for (var i = 0; i < n; ++i) ++c; return c;"));
+	// Other operand types take the regular path
+	EXPECT_EQ(C4VInt(1), RunCode("var i; if (i < 1) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(2), RunCode("var s = \"a\"; if (s == 1) return 1; return 2;"));
+	EXPECT_EQ(C4VInt(1), RunScript("local i; func Main() { if (i == nil) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(2), RunScript("local i; func Main() { if (i == 0) return 1; return 2; }"));
+	EXPECT_THROW(RunCode("var s = \"a\"; if (s < 1) return 1; return 2;"), C4AulExecError);
+}
+
+TEST_F(AulTest, LookupCaches)
+{
+	// Property and function lookups remember where in the prototype chain they found the key
+	EXPECT_EQ(C4VInt(6), RunCode("var p = { x = 1 }, a = new p {}, b = new p {}, s; for (var i = 0; i < 3; ++i) s += a.x + b.x; return s;"));
+	// Later lookups from the same call site see changes to the prototypes
+	EXPECT_EQ(C4VInt(12), RunCode("var p = { x = 1 }, a = new p {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + a.x; p.x = 2; } return r;"));
+	EXPECT_EQ(C4VInt(15), RunCode("var b = { x = 1 }, p = new b {}, a = new p {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + a.x; p.x = 5; } return r;"));
+	EXPECT_EQ(C4VInt(13), RunCode("var p = { x = 1 }, q = { }, a = new p {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + a.x; a.Prototype = q; q.x = 3; } return r;"));
+	EXPECT_EQ(C4VInt(20), RunCode("var b = { x = 1 }, p = new b { x = 2 }, a = new p {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + (a.x ?? 0); b.x = 3; p.x = nil; } return r;"));
+	// Own properties are never taken from the cache
+	EXPECT_EQ(C4VInt(17), RunCode("var p = { x = 1 }, a = new p {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + a.x; a.x = 7; } return r;"));
+	// The same for function calls, including calls to functions that are not there
+	const char *funcs = "local p = { f = func() { return 1; } }, q = { f = func() { return 2; } }, e = { };";
+	EXPECT_EQ(C4VInt(12), RunScript(std::string(funcs) + "func Main() { var m = new p {}, a = new m {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + a->f(); m.f = q.f; } return r; }"));
+	EXPECT_EQ(C4VInt(2), RunScript(std::string(funcs) + "func Main() { var m = new e {}, a = new m {}, r; for (var i = 0; i < 2; ++i) { r = r * 10 + (a->~f() ?? 0); m.f = q.f; } return r; }"));
+	EXPECT_EQ(C4VInt(21), RunScript(std::string(funcs) + "func Main() { var a = new p {}, b = new q {}, r; for (var c in [b, a, a]) r = r * 10 + c->f(); return r / 10; }"));
+}
+
+TEST_F(AulTest, PropListStorage)
+{
+	// Proplists with the same keys share their layout
+	EXPECT_EQ(C4VInt(5), RunCode("var a = { x = 1, y = 2 }, b = { x = 3, y = 4 }; return a.y + b.x;"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = { }, b = { }; a.x = 1; a.y = 2; b.y = 3; b.x = 4; return DeepEqual([\"x\", \"y\"], GetProperties(a)) && DeepEqual(GetProperties(a), GetProperties(b));"));
+	EXPECT_EQ(C4VBool(true), RunCode("var p = { a = 1, b = 2 }; ResetProperty(\"b\", p); p.c = 3; return DeepEqual([\"a\", \"c\"], GetProperties(p));"));
+	// Removing other keys or adding many turns the proplist into a dictionary
+	EXPECT_EQ(C4VBool(true), RunCode("var p = { a = 1, b = 2, c = 3 }; ResetProperty(\"b\", p); p.d = 4; return DeepEqual([1, nil, 3, 4, 3], [p.a, p.b, p.c, p.d, GetLength(GetProperties(p))]);"));
+	EXPECT_EQ(C4VInt(4950 + 57), RunCode("var p = { }, s; for (var i = 0; i < 100; ++i) p[Format(\"k%d\", i)] = i; for (var k in GetProperties(p)) s += p[k]; return s + p.k57;"));
+	EXPECT_EQ(C4VBool(true), RunCode("var p = { }, q = { }; for (var i = 0; i < 40; ++i) { p[Format(\"k%d\", i)] = i; q[Format(\"k%d\", 39 - i)] = 39 - i; } return DeepEqual(p, q);"));
+}
+
+TEST_F(AulTest, ArrayStorage)
+{
+	// Appending one value at a time
+	EXPECT_EQ(C4VInt(1999), RunCode("var a = []; for (var i = 0; i < 1000; ++i) a[GetLength(a)] = i; return a[999] + GetLength(a);"));
+	// Copies and slices share their values until one of them is changed
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3, 4, 5, 6, 7, 8], b = a[1:]; b[0] = 9; a[2] = 10; return DeepEqual([2, 9, 10, 3], [a[1], b[0], a[2], b[1]]);"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3, 4], b = a[:]; SortArray(b, true); return DeepEqual([[1, 2, 3, 4], [4, 3, 2, 1]], [a, b]);"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3, 4], b = a[:]; SetLength(b, 2); SetLength(b, 4); return DeepEqual([[1, 2, 3, 4], [1, 2, nil, nil]], [a, b]);"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3, 4], b = a[:]; SetLength(a, 2); b = nil; SetLength(a, 3); return DeepEqual([1, 2, nil], a);"));
+	// Slice assignments from the array itself
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3]; a[1:] = a; return DeepEqual([1, 1, 2, 3], a);"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [1, 2, 3, 4]; a[1:] = a[2:]; return DeepEqual([1, 3, 4], a);"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = []; for (var i = 0; i < 5; ++i) a[i] = i; a[1:2] = [7, 8, 9]; a[7:] = [5]; return DeepEqual([0, 7, 8, 9, 2, 3, 4, 5], a);"));
+}
+
+TEST_F(AulTest, StringTable)
+{
+	// Equal strings are the same C4String, whether they are stored inline or not
+	const char *long_text = "a string that is longer than the short string storage";
+	C4String *s = ::Strings.RegString("short"), *l = ::Strings.RegString(long_text);
+	// keep them referenced, so they are removed from the table again
+	C4Value vs(s), vl(l);
+	EXPECT_EQ(s, ::Strings.RegString(StdCopyStrBuf("short")));
+	EXPECT_EQ(l, ::Strings.RegString(StdCopyStrBuf(long_text)));
+	EXPECT_EQ(l, ::Strings.FindString(long_text));
+	EXPECT_STREQ(long_text, l->GetCStr());
+	EXPECT_EQ(5u, s->GetData().getLength());
+	EXPECT_EQ(nullptr, ::Strings.FindString("shor"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = [], b = []; for (var i = 0; i < 300; ++i) { a[i] = Format(\"%d\", i); b[i] = Format(\"%d%s\", i, \" and some more text to be long\"); } return a[123] == \"123\" && b[7] == \"7 and some more text to be long\" && b[7] != b[8];"));
+}
+
+TEST_F(AulTest, ByteCodeOptimization)
+{
+	// Constant expressions are folded at compile time
+	EXPECT_EQ(C4VInt(17), RunExpr("(2 + 3) * 4 - 6 / 2"));
+	EXPECT_EQ(C4VInt(-8), RunExpr("~(1 << 3) + 1"));
+	EXPECT_EQ(C4VInt(1024), RunExpr("2 ** 10"));
+	EXPECT_EQ(C4VNull, RunExpr("5 % 0"));
+	EXPECT_EQ(C4VBool(true), RunCode("var a = 0; return GetType(5 % 0) == GetType(5 % a);"));
+	EXPECT_EQ(C4VBool(true), RunExpr("!(3 > 4) == (1 + 1 == 2)"));
+	EXPECT_EQ(C4VBool(false), RunExpr("1 == true"));
+	// Operations that fail at runtime are left alone
+	EXPECT_THROW(RunExpr("(3 - 3) + 1 / (2 - 2)"), C4AulExecError);
+	// Branches on constants
+	EXPECT_EQ(C4VInt(2), RunScript("static const Debug = false; func Main() { if (Debug) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(1), RunScript("static const Level = 3; func Main() { if (Level > 2 && !(Level > 5)) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(3), RunCode("return 0 || 3;"));
+	EXPECT_EQ(C4VInt(0), RunCode("return 0 && 3;"));
+	EXPECT_EQ(C4VInt(4), RunCode("return nil ?? 4;"));
+	EXPECT_EQ(C4VInt(5), RunCode("return 5 ?? 4;"));
+	EXPECT_EQ(C4VInt(6), RunCode("var i; while (true) { if (++i > 5) break; } return i;"));
+	EXPECT_EQ(C4VInt(7), RunCode("var i = 7; while (false) i = 0; return i;"));
+	// Jumps stay correct when the code around them shrinks
+	EXPECT_EQ(C4VInt(6), RunCode("var s; for (var x in [1, 2, 3]) { if (1 + 1 == 2) s += x; else s -= x; } return s;"));
+	EXPECT_EQ(C4VInt(3), RunCode("var c; for (var x in [1, 2, 3]) {} for (var y in [4, 5, 6]) { if (true) continue; c = 10; } for (var z in [7, 8, 9]) ++c; return c;"));
+	EXPECT_EQ(C4VInt(10), RunCode("var c; for (var i = 0; i < 2 * 5; ++i) { if (false) { c = 100; break; } ++c; } return c;"));
+}
+
+TEST_F(AulTest, EffectTimers)
+{
+	// Effect timers are only checked when one is due, but run in list order at the same times
+	InitCoreFunctionMap(&ScriptEngine);
+	GameScript.LoadData("<EffectTimers>", R"(
+static calls, fx_c;
+local Fx = { Timer = func(int time)
+{
+	calls = Format("%s %s%d", calls, this.Tag, time);
+	if (this.Tag == "b" && time == 4) fx_c.Time = 5;
+	if (this.Tag == "a" && time == 6) return -1;
+} };
+func Init()
+{
+	calls = "";
+	CreateEffect(Fx, 1, 3).Tag = "a";
+	CreateEffect(Fx, 2, 2).Tag = "b";
+	fx_c = CreateEffect(Fx, 3, 5);
+	fx_c.Tag = "c";
+}
+func Result() { return Format("%s, %d", calls, fx_c.Time); }
+)", nullptr);
+	ScriptEngine.Link(nullptr);
+	GameScript.Call("Init", nullptr, true);
+	for (int i = 0; i < 10; ++i)
+		C4Effect::Execute(&GameScript.pScenarioEffects);
+	C4Value result = GameScript.Call("Result", nullptr, true);
+	EXPECT_STREQ(" b2 a3 b4 c5 a6 b6 b8 c10 b10, 11", result.getStr() ? result.getStr()->GetCStr() : "");
+	GameScript.Clear();
+	ScriptEngine.Clear();
+}
+
+TEST_F(AulTest, ProfilerCallGraph)
+{
+	// The profiler keeps the call stacks apart and includes engine functions
+	C4AulProfiler::StartProfiling(nullptr);
+	EXPECT_EQ(C4VInt(3), RunScript("func Inner() { return Abs(-1); } func Outer() { return Inner() + Inner(); } func Main() { return Outer() + Inner(); }"));
+	C4AulProfiler::StopProfiling("AulTestProfile");
+	std::ifstream folded("AulTestProfile.folded");
+	std::stringstream stacks;
+	stacks << folded.rdbuf();
+	folded.close();
+	EXPECT_NE(std::string::npos, stacks.str().find("Main;Scenario.Prototype.Outer;Scenario.Prototype.Inner;Global.Abs "));
+	EXPECT_NE(std::string::npos, stacks.str().find("Main;Scenario.Prototype.Inner;Global.Abs "));
+	std::ifstream json("AulTestProfile.json");
+	std::stringstream trace;
+	trace << json.rdbuf();
+	json.close();
+	EXPECT_EQ(0u, trace.str().find("{\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, trace.str().find("\"name\":\"Scenario.Prototype.Outer\""));
+	std::remove("AulTestProfile.folded");
+	std::remove("AulTestProfile.json");
+}
+
+TEST_F(AulTest, ScriptHeapCycles)
+{
+	// Cycles of proplists and arrays are freed once nothing else references them
+	C4ScriptHeap::CollectAll();
+	const C4ScriptHeap::Stats &Stats = C4ScriptHeap::GetStats();
+	uint32_t iPropLists = Stats.PropLists, iArrays = Stats.Arrays;
+	C4Value kept = RunCode("var a = {}, b = [a]; a.b = b; a.self = a; var c = { d = {} }; c.d.c = c; c.d.x = [c, c.d]; return c;");
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists + 2, Stats.PropLists);
+	EXPECT_EQ(iArrays + 1, Stats.Arrays);
+	C4Value d, x;
+	ASSERT_TRUE(kept.getPropList() && kept.getPropList()->GetPropertyByS(::Strings.RegString("d"), &d));
+	ASSERT_TRUE(d.getPropList() && d.getPropList()->GetPropertyByS(::Strings.RegString("x"), &x));
+	EXPECT_EQ(2, x.getArray() ? x.getArray()->GetSize() : 0);
+	kept.Set0();
+	d.Set0();
+	x.Set0();
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists, Stats.PropLists);
+	EXPECT_EQ(iArrays, Stats.Arrays);
+	EXPECT_EQ(0u, Stats.Candidates);
+}
+
+TEST_F(AulTest, ScriptHeapSharedBuffers)
+{
+	// A cycle through an array that shares its values with a copy is kept while the copy
+	// exists, and freed once the array is the only one left using them
+	C4ScriptHeap::CollectAll();
+	const C4ScriptHeap::Stats &Stats = C4ScriptHeap::GetStats();
+	uint32_t iPropLists = Stats.PropLists, iArrays = Stats.Arrays;
+	C4Value kept = RunCode("var a = {}, b = [a]; a.b = b; return b[:];");
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists + 1, Stats.PropLists);
+	EXPECT_EQ(iArrays + 2, Stats.Arrays);
+	kept.Set0();
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists, Stats.PropLists);
+	EXPECT_EQ(iArrays, Stats.Arrays);
+	EXPECT_EQ(0u, Stats.Candidates);
+}
+
+TEST_F(AulTest, ScriptHeapSliceOfDroppedArray)
+{
+	// A slice that outlives the array it shares values with doesn't keep the values outside of it
+	C4ScriptHeap::CollectAll();
+	const C4ScriptHeap::Stats &Stats = C4ScriptHeap::GetStats();
+	uint32_t iPropLists = Stats.PropLists, iArrays = Stats.Arrays;
+	EXPECT_EQ(C4VInt(3), RunCode("var a = {}; var b = [a, 0, 0, 0]; a.b = b[1:]; b = nil; return GetLength(a.b);"));
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists, Stats.PropLists);
+	EXPECT_EQ(iArrays, Stats.Arrays);
+	EXPECT_EQ(0u, Stats.Candidates);
+}
+
+TEST_F(AulTest, ScriptHeapSlices)
+{
+	// Objects proven alive are not traced again for every candidate that reaches them,
+	// and a trace that doesn't fit into the rest of a slice waits for the next one
+	C4ScriptHeap::CollectAll();
+	const C4ScriptHeap::Stats &Stats = C4ScriptHeap::GetStats();
+	C4Value kept = RunCode("var big = [[], []]; for (var j = 0; j < 2; ++j) { for (var i = 0; i < 2000; ++i) big[j][i] = {}; for (var i = 0; i < 100; ++i) { var p = { big = big[j] }; big[j][i].p = p; } } return big;");
+	EXPECT_GE(Stats.Candidates, 200u);
+	C4ScriptHeap::ResetStats();
+	const uint32_t iSliceSize = 500, iWholeHeap = 2 * (1 + 2000 + 100) + 1;
+	uint32_t iRuns = 0, iMaxVisited = 0;
+	while (Stats.Candidates && iRuns < 100)
+	{
+		uint32_t iVisited = Stats.Visited;
+		C4ScriptHeap::Collect(iSliceSize);
+		iMaxVisited = std::max(iMaxVisited, Stats.Visited - iVisited);
+		++iRuns;
+	}
+	EXPECT_EQ(0u, Stats.Candidates);
+	EXPECT_LE(iMaxVisited, iWholeHeap + iSliceSize);
+	EXPECT_LE(Stats.Visited, 4 * iWholeHeap);
+	EXPECT_EQ(0u, Stats.CollectedPropLists + Stats.CollectedArrays);
+	// still freed as a whole once unreferenced
+	uint32_t iPropLists = Stats.PropLists;
+	kept.Set0();
+	C4ScriptHeap::CollectAll();
+	EXPECT_EQ(iPropLists - 2 * 2100, Stats.PropLists);
+}
+
+TEST_F(AulTest, ParallelPreparse)
+{
+	// Enough scripts to be parsed on several threads; they still get registered in load order
+	for (int i = 0; i < 32; ++i)
+	{
+		C4ExtraScriptHost *pHost = new C4ExtraScriptHost();
+		pHost->Reg2List(&ScriptEngine);
+		std::string name = "<ParallelPreparse::" + std::to_string(i) + ">";
+		std::string code = "global func Parallel" + std::to_string(i) + "() { return \"s" + std::to_string(i) + "\"; }\n"
+			"global func Last() { return " + std::to_string(i) + "; }\n";
+		pHost->LoadData(name.c_str(), code.c_str(), nullptr);
+	}
+	EXPECT_EQ(C4VArray(C4VString("s0"), C4VString("s17"), C4VString("s31"), C4VInt(31)), RunExpr("[Parallel0(), Parallel17(), Parallel31(), Last()]"));
+}